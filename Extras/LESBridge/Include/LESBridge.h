@@ -0,0 +1,121 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#pragma once
+
+// Standalone library for the shared memory event bridge of the Light Event System. Tools use it to watch the events
+// mirrored by the game and to inject events into it, without linking against the engine. See README.md for building.
+
+#include "BridgeLayout.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace LESBridge
+{
+	/** Which end of the bridge this process is. Determines the ring it reads and the ring it writes. */
+	enum class ERole
+	{
+		/** Creates the region, reads injected events and writes mirrored events. Used by the game and by tests. */
+		Game,
+		/** Opens an existing region, reads mirrored events and writes injected events. */
+		Tool,
+	};
+
+	struct FField
+	{
+		std::string Name;
+		LES::Bridge::EFieldKind Kind = LES::Bridge::EFieldKind::Raw;
+
+		/** Size in bytes of the raw fields. Zero for the text fields. */
+		uint32_t Size = 0;
+	};
+
+	/** Describes the fields of an event class, as published by the game. */
+	struct FSchema
+	{
+		uint32_t ClassId = 0;
+
+		/** Path of the event class, like /Script/LightEventSystem.LES_VectorEvent. */
+		std::string ClassName;
+
+		std::vector<FField> Fields;
+	};
+
+	struct FEvent
+	{
+		uint32_t ClassId = 0;
+		std::string Channel;
+
+		/** Values in the schema order: the raw bytes for the raw fields, and UTF-8 for the text fields. */
+		std::vector<std::string> Values;
+
+		/** Copies the raw value at the \a Index into \a OutValue. Returns false if the sizes don't match. */
+		template <typename T>
+		bool GetRaw(const size_t Index, T& OutValue) const
+		{
+			if (Index >= Values.size() || Values[Index].size() != sizeof(T)) return false;
+			std::memcpy(&OutValue, Values[Index].data(), sizeof(T));
+			return true;
+		}
+
+		/** Sets the raw value at the \a Index, growing the values if needed. */
+		template <typename T>
+		void SetRaw(const size_t Index, const T& Value)
+		{
+			if (Index >= Values.size()) Values.resize(Index + 1);
+			Values[Index].assign(reinterpret_cast<const char*>(&Value), sizeof(T));
+		}
+	};
+
+	class FBridge
+	{
+	public:
+		/** Creates the region named \a Name, with rings of \a Capacity bytes (a power of two). Returns null on failure. */
+		static std::unique_ptr<FBridge> Create(const std::string& Name, uint32_t Capacity,
+		                                       uint32_t SchemaCapacity = 64 * 1024);
+
+		/** Opens the region named \a Name created by the game. Returns null if it doesn't exist or isn't compatible. */
+		static std::unique_ptr<FBridge> Open(const std::string& Name);
+
+		~FBridge();
+
+		FBridge(const FBridge&) = delete;
+		FBridge& operator=(const FBridge&) = delete;
+
+		/** Publishes the schema of an event class. Game role only. Returns false if the schema log is full. */
+		bool PublishSchema(const FSchema& Schema);
+
+		/** Returns the schema with the \a ClassId, or null if it hasn't been published. */
+		const FSchema* FindSchema(uint32_t ClassId);
+
+		/** Returns the schema of the class with the \a ClassName, or null if it hasn't been published. */
+		const FSchema* FindSchema(const std::string& ClassName);
+
+		/** Reads the next event from the ring of this role. Returns false if there's none. */
+		bool Read(FEvent& OutEvent);
+
+		/** Writes the \a Event to the ring of this role. Returns false if the ring is full or the event is invalid. */
+		bool Write(const FEvent& Event);
+
+		/** Amount of events dropped so far because the ring written by this role was full. */
+		uint64_t GetNumDropped() const;
+
+	private:
+		FBridge() = default;
+
+		ERole Role = ERole::Tool;
+		std::string Name;
+		void* Mapping = nullptr;
+		uint64_t MappingSize = 0;
+		void* Handle = nullptr;
+		LES::Bridge::FRegionHeader* Header = nullptr;
+		LES::Bridge::FRingReader Reader;
+		LES::Bridge::FRingWriter Writer;
+		uint32_t NumSchemaBytesRead = 0;
+		std::vector<FSchema> Schemas;
+
+		bool Map(bool bCreate, uint64_t Size);
+		void RefreshSchemas();
+	};
+}
@@ -0,0 +1,317 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#include "LESBridge.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace LESBridge
+{
+	namespace
+	{
+		/** Reads values from a record body, failing once the body is exhausted. */
+		class FBodyReader
+		{
+		public:
+			FBodyReader(const uint8_t* InData, const uint32_t InSize) : Data(InData), Size(InSize)
+			{
+			}
+
+			template <typename T>
+			bool Read(T& OutValue)
+			{
+				if (Size - Offset < sizeof(T)) return false;
+				std::memcpy(&OutValue, Data + Offset, sizeof(T));
+				Offset += sizeof(T);
+				return true;
+			}
+
+			bool Read(std::string& OutValue, const uint32_t Length)
+			{
+				if (Size - Offset < Length) return false;
+				OutValue.assign(reinterpret_cast<const char*>(Data + Offset), Length);
+				Offset += Length;
+				return true;
+			}
+
+		private:
+			const uint8_t* Data;
+			uint32_t Size;
+			uint32_t Offset = 0;
+		};
+
+		/** Appends values to a record body. */
+		class FBodyWriter
+		{
+		public:
+			explicit FBodyWriter(uint8_t* InData) : Data(InData)
+			{
+			}
+
+			template <typename T>
+			void Write(const T& Value)
+			{
+				std::memcpy(Data + Offset, &Value, sizeof(T));
+				Offset += sizeof(T);
+			}
+
+			void Write(const std::string& Value)
+			{
+				std::memcpy(Data + Offset, Value.data(), Value.size());
+				Offset += static_cast<uint32_t>(Value.size());
+			}
+
+		private:
+			uint8_t* Data;
+			uint32_t Offset = 0;
+		};
+
+		std::string GetSystemName(const std::string& Name)
+		{
+#if defined(_WIN32)
+			return Name;
+#else
+			// Matches the engine, which prefixes the names of the POSIX shared memory objects with a slash.
+			return "/" + Name;
+#endif
+		}
+	}
+
+	std::unique_ptr<FBridge> FBridge::Create(const std::string& Name, const uint32_t Capacity,
+	                                         const uint32_t SchemaCapacity)
+	{
+		if (Capacity < 64 || (Capacity & (Capacity - 1)) != 0) return nullptr;
+
+		std::unique_ptr<FBridge> Bridge(new FBridge());
+		Bridge->Role = ERole::Game;
+		Bridge->Name = Name;
+		if (!Bridge->Map(true, LES::Bridge::GetRegionSize(Capacity, SchemaCapacity))) return nullptr;
+
+		LES::Bridge::InitializeRegion(Bridge->Mapping, Capacity, SchemaCapacity);
+		Bridge->Header = LES::Bridge::GetRegionHeader(Bridge->Mapping, Bridge->MappingSize);
+		Bridge->Reader = LES::Bridge::FRingReader(Bridge->Header, LES::Bridge::ToolsToGame);
+		Bridge->Writer = LES::Bridge::FRingWriter(Bridge->Header, LES::Bridge::GameToTools);
+		return Bridge;
+	}
+
+	std::unique_ptr<FBridge> FBridge::Open(const std::string& Name)
+	{
+		std::unique_ptr<FBridge> Bridge(new FBridge());
+		Bridge->Role = ERole::Tool;
+		Bridge->Name = Name;
+		if (!Bridge->Map(false, 0)) return nullptr;
+
+		Bridge->Header = LES::Bridge::GetRegionHeader(Bridge->Mapping, Bridge->MappingSize);
+		if (!Bridge->Header) return nullptr;
+		Bridge->Reader = LES::Bridge::FRingReader(Bridge->Header, LES::Bridge::GameToTools);
+		Bridge->Writer = LES::Bridge::FRingWriter(Bridge->Header, LES::Bridge::ToolsToGame);
+		return Bridge;
+	}
+
+	FBridge::~FBridge()
+	{
+#if defined(_WIN32)
+		if (Mapping) UnmapViewOfFile(Mapping);
+		if (Handle) CloseHandle(Handle);
+#else
+		if (Mapping) munmap(Mapping, MappingSize);
+		if (Role == ERole::Game && Mapping) shm_unlink(GetSystemName(Name).c_str());
+#endif
+	}
+
+	bool FBridge::Map(const bool bCreate, const uint64_t Size)
+	{
+		const std::string SystemName = GetSystemName(Name);
+#if defined(_WIN32)
+		Handle = bCreate
+			         ? CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, static_cast<DWORD>(Size >> 32),
+			                              static_cast<DWORD>(Size), SystemName.c_str())
+			         : OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, SystemName.c_str());
+		if (!Handle) return false;
+
+		Mapping = MapViewOfFile(Handle, FILE_MAP_ALL_ACCESS, 0, 0, static_cast<SIZE_T>(Size));
+		if (!Mapping) return false;
+
+		MEMORY_BASIC_INFORMATION Info;
+		if (!VirtualQuery(Mapping, &Info, sizeof(Info))) return false;
+		MappingSize = Info.RegionSize;
+		return true;
+#else
+		const int Descriptor = shm_open(SystemName.c_str(), bCreate ? O_RDWR | O_CREAT | O_TRUNC : O_RDWR, 0600);
+		if (Descriptor < 0) return false;
+
+		struct stat Stat;
+		if ((bCreate && ftruncate(Descriptor, static_cast<off_t>(Size)) != 0) || fstat(Descriptor, &Stat) != 0)
+		{
+			close(Descriptor);
+			return false;
+		}
+
+		MappingSize = static_cast<uint64_t>(Stat.st_size);
+		void* Address = MappingSize > 0
+			                ? mmap(nullptr, MappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, Descriptor, 0)
+			                : MAP_FAILED;
+		close(Descriptor);
+		if (Address == MAP_FAILED) return false;
+		Mapping = Address;
+		return true;
+#endif
+	}
+
+	bool FBridge::PublishSchema(const FSchema& Schema)
+	{
+		if (Role != ERole::Game) return false;
+
+		uint32_t BodySize = sizeof(uint32_t) + 2 * sizeof(uint16_t) + static_cast<uint32_t>(Schema.ClassName.size());
+		for (const FField& Field : Schema.Fields)
+			BodySize += sizeof(uint16_t) + 2 * sizeof(uint8_t) + sizeof(uint32_t) + static_cast<uint32_t>(Field.Name.size());
+
+		std::vector<uint8_t> Body(BodySize);
+		FBodyWriter BodyWriter(Body.data());
+		BodyWriter.Write(Schema.ClassId);
+		BodyWriter.Write(static_cast<uint16_t>(Schema.Fields.size()));
+		BodyWriter.Write(static_cast<uint16_t>(Schema.ClassName.size()));
+		BodyWriter.Write(Schema.ClassName);
+		for (const FField& Field : Schema.Fields)
+		{
+			BodyWriter.Write(static_cast<uint16_t>(Field.Name.size()));
+			BodyWriter.Write(Field.Kind);
+			BodyWriter.Write(static_cast<uint8_t>(0));
+			BodyWriter.Write(Field.Size);
+			BodyWriter.Write(Field.Name);
+		}
+		return LES::Bridge::AppendSchema(Header, Body.data(), BodySize);
+	}
+
+	const FSchema* FBridge::FindSchema(const uint32_t ClassId)
+	{
+		RefreshSchemas();
+		for (const FSchema& Schema : Schemas)
+		{
+			if (Schema.ClassId == ClassId) return &Schema;
+		}
+		return nullptr;
+	}
+
+	const FSchema* FBridge::FindSchema(const std::string& ClassName)
+	{
+		RefreshSchemas();
+		for (const FSchema& Schema : Schemas)
+		{
+			if (Schema.ClassName == ClassName) return &Schema;
+		}
+		return nullptr;
+	}
+
+	void FBridge::RefreshSchemas()
+	{
+		const uint32_t SchemaSize = Header->SchemaSize.load(std::memory_order_acquire);
+		if (SchemaSize == NumSchemaBytesRead) return;
+		NumSchemaBytesRead = SchemaSize;
+
+		Schemas.clear();
+		LES::Bridge::ForEachSchema(Header, [this](const uint8_t* Body, const uint32_t BodySize)
+		{
+			FBodyReader BodyReader(Body, BodySize);
+			FSchema Schema;
+			uint16_t NumFields = 0;
+			uint16_t ClassNameLength = 0;
+			if (!BodyReader.Read(Schema.ClassId) || !BodyReader.Read(NumFields) || !BodyReader.Read(ClassNameLength) ||
+				!BodyReader.Read(Schema.ClassName, ClassNameLength))
+				return;
+
+			for (uint16_t Index = 0; Index < NumFields; Index++)
+			{
+				FField Field;
+				uint16_t NameLength = 0;
+				uint8_t Reserved = 0;
+				if (!BodyReader.Read(NameLength) || !BodyReader.Read(Field.Kind) || !BodyReader.Read(Reserved) ||
+					!BodyReader.Read(Field.Size) || !BodyReader.Read(Field.Name, NameLength))
+					return;
+				Schema.Fields.push_back(std::move(Field));
+			}
+			Schemas.push_back(std::move(Schema));
+		});
+	}
+
+	bool FBridge::Read(FEvent& OutEvent)
+	{
+		LES::Bridge::FRecordHeader RecordHeader;
+		const uint8_t* Body = nullptr;
+		uint32_t BodySize = 0;
+		while (Reader.Peek(RecordHeader, Body, BodySize))
+		{
+			FBodyReader BodyReader(Body, BodySize);
+			uint16_t ChannelLength = 0;
+			uint16_t Reserved = 0;
+			bool bValid = RecordHeader.Type == LES::Bridge::ERecordType::Event &&
+				BodyReader.Read(OutEvent.ClassId) && BodyReader.Read(ChannelLength) && BodyReader.Read(Reserved) &&
+				BodyReader.Read(OutEvent.Channel, ChannelLength);
+
+			const FSchema* Schema = bValid ? FindSchema(OutEvent.ClassId) : nullptr;
+			bValid = Schema != nullptr;
+			if (bValid)
+			{
+				OutEvent.Values.resize(Schema->Fields.size());
+				for (size_t Index = 0; Index < Schema->Fields.size() && bValid; Index++)
+				{
+					const FField& Field = Schema->Fields[Index];
+					uint32_t Length = Field.Size;
+					if (Field.Kind == LES::Bridge::EFieldKind::Text)
+						bValid = BodyReader.Read(Length);
+					bValid = bValid && BodyReader.Read(OutEvent.Values[Index], Length);
+				}
+			}
+
+			// Records that can't be decoded are skipped.
+			Reader.Pop();
+			if (bValid) return true;
+		}
+		return false;
+	}
+
+	bool FBridge::Write(const FEvent& Event)
+	{
+		const FSchema* Schema = FindSchema(Event.ClassId);
+		if (!Schema || Event.Values.size() != Schema->Fields.size()) return false;
+
+		uint32_t BodySize = sizeof(uint32_t) + 2 * sizeof(uint16_t) + static_cast<uint32_t>(Event.Channel.size());
+		for (size_t Index = 0; Index < Schema->Fields.size(); Index++)
+		{
+			const FField& Field = Schema->Fields[Index];
+			if (Field.Kind == LES::Bridge::EFieldKind::Raw && Event.Values[Index].size() != Field.Size) return false;
+			if (Field.Kind == LES::Bridge::EFieldKind::Text) BodySize += sizeof(uint32_t);
+			BodySize += static_cast<uint32_t>(Event.Values[Index].size());
+		}
+
+		uint8_t* Body = Writer.BeginWrite(LES::Bridge::ERecordType::Event, BodySize);
+		if (!Body) return false;
+
+		FBodyWriter BodyWriter(Body);
+		BodyWriter.Write(Event.ClassId);
+		BodyWriter.Write(static_cast<uint16_t>(Event.Channel.size()));
+		BodyWriter.Write(static_cast<uint16_t>(0));
+		BodyWriter.Write(Event.Channel);
+		for (size_t Index = 0; Index < Schema->Fields.size(); Index++)
+		{
+			if (Schema->Fields[Index].Kind == LES::Bridge::EFieldKind::Text)
+				BodyWriter.Write(static_cast<uint32_t>(Event.Values[Index].size()));
+			BodyWriter.Write(Event.Values[Index]);
+		}
+		Writer.EndWrite();
+		return true;
+	}
+
+	uint64_t FBridge::GetNumDropped() const
+	{
+		const LES::Bridge::ERing Ring = Role == ERole::Game ? LES::Bridge::GameToTools : LES::Bridge::ToolsToGame;
+		return Header->Rings[Ring].NumDropped.load(std::memory_order_relaxed);
+	}
+}
@@ -0,0 +1,126 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+// Runs the game and the tool ends of the bridge as two local processes. The game mirrors a stream of vector events,
+// the tool reads them and injects each one back with the value doubled, and the game checks what it gets back. The
+// rings are small on purpose, so both ends wrap around and wait on each other many times.
+
+#include "LESBridge.h"
+
+#include <chrono>
+#include <cstdio>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+namespace
+{
+	constexpr int NumEvents = 10000;
+	constexpr uint32_t Capacity = 1024;
+	const char* VectorEventClass = "/Script/LightEventSystem.LES_VectorEvent";
+
+	struct FVector
+	{
+		double X, Y, Z;
+	};
+
+	/** Retries the \a Func until it returns true, or fails after a few seconds. */
+	template <typename TFunc>
+	bool Retry(TFunc&& Func)
+	{
+		const auto Deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+		while (!Func())
+		{
+			if (std::chrono::steady_clock::now() > Deadline) return false;
+			std::this_thread::yield();
+		}
+		return true;
+	}
+
+	int Fail(const char* Side, const char* Message, const int Index = -1)
+	{
+		std::fprintf(stderr, "[%s] %s (event %d)\n", Side, Message, Index);
+		return 1;
+	}
+
+	int RunTool(const std::string& Name)
+	{
+		std::unique_ptr<LESBridge::FBridge> Bridge;
+		if (!Retry([&] { return (Bridge = LESBridge::FBridge::Open(Name)) != nullptr; }))
+			return Fail("Tool", "Couldn't open the bridge");
+
+		const LESBridge::FSchema* Schema = nullptr;
+		if (!Retry([&] { return (Schema = Bridge->FindSchema(VectorEventClass)) != nullptr; }))
+			return Fail("Tool", "Schema wasn't published");
+		if (Schema->Fields.size() != 1 || Schema->Fields[0].Size != sizeof(FVector))
+			return Fail("Tool", "Unexpected schema");
+
+		for (int Index = 0; Index < NumEvents; Index++)
+		{
+			LESBridge::FEvent Event;
+			FVector Value;
+			if (!Retry([&] { return Bridge->Read(Event); }))
+				return Fail("Tool", "Timed out reading", Index);
+			if (Event.ClassId != Schema->ClassId || Event.Channel != "Movement" || !Event.GetRaw(0, Value) ||
+				Value.X != Index || Value.Y != -Index || Value.Z != 0.5)
+				return Fail("Tool", "Unexpected event", Index);
+
+			Value.X *= 2;
+			Event.SetRaw(0, Value);
+			Event.Channel = "Injected";
+			if (!Retry([&] { return Bridge->Write(Event); }))
+				return Fail("Tool", "Timed out injecting", Index);
+		}
+		return 0;
+	}
+
+	int RunGame(const std::string& Name, const pid_t ToolProcess)
+	{
+		const std::unique_ptr<LESBridge::FBridge> Bridge = LESBridge::FBridge::Create(Name, Capacity);
+		if (!Bridge) return Fail("Game", "Couldn't create the bridge");
+		if (!Bridge->PublishSchema({7, VectorEventClass, {{"Value", LES::Bridge::EFieldKind::Raw, sizeof(FVector)}}}))
+			return Fail("Game", "Couldn't publish the schema");
+
+		int NumSent = 0;
+		int NumReceived = 0;
+		const auto Deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+		while (NumReceived < NumEvents)
+		{
+			if (std::chrono::steady_clock::now() > Deadline)
+				return Fail("Game", "Timed out", NumReceived);
+
+			if (NumSent < NumEvents)
+			{
+				LESBridge::FEvent Event{7, "Movement", {}};
+				Event.SetRaw(0, FVector{static_cast<double>(NumSent), -static_cast<double>(NumSent), 0.5});
+				if (Bridge->Write(Event)) NumSent++;
+			}
+
+			LESBridge::FEvent Injected;
+			FVector Value;
+			while (Bridge->Read(Injected))
+			{
+				if (Injected.ClassId != 7 || Injected.Channel != "Injected" || !Injected.GetRaw(0, Value) ||
+					Value.X != 2.0 * NumReceived)
+					return Fail("Game", "Unexpected injected event", NumReceived);
+				NumReceived++;
+			}
+		}
+
+		int Status = 0;
+		if (waitpid(ToolProcess, &Status, 0) != ToolProcess || !WIFEXITED(Status) || WEXITSTATUS(Status) != 0)
+			return Fail("Game", "Tool process failed");
+
+		std::printf("Bridge test passed: %d events each way, %llu writes found the ring full and were retried.\n",
+		            NumEvents, static_cast<unsigned long long>(Bridge->GetNumDropped()));
+		return 0;
+	}
+}
+
+int main()
+{
+	const std::string Name = "LESBridgeTest_" + std::to_string(getpid());
+	const pid_t ToolProcess = fork();
+	if (ToolProcess < 0) return Fail("Game", "Couldn't start the tool process");
+	if (ToolProcess == 0) _exit(RunTool(Name));
+	return RunGame(Name, ToolProcess);
+}
@@ -0,0 +1,128 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+
+#include "MassEventBridge.h"
+
+#include "MassEntityManager.h"
+#include "MassExecutionContext.h"
+
+TArray<ULES_MassEventBridge*> ULES_MassEventBridge::Bridges;
+
+void ULES_MassEventBridge::Initialize(ULES_EventSystem* InEventSystem,
+                                      const TSharedRef<FMassEntityManager>& InEntityManager)
+{
+	check(IsInGameThread());
+	EventSystem = InEventSystem;
+	EntityManager = InEntityManager;
+	Bridges.AddUnique(this);
+}
+
+bool ULES_MassEventBridge::Unsubscribe(const FLES_ObserverHandle& ObserverHandle)
+{
+	auto IsSubscription = [&ObserverHandle](const TUniquePtr<FSubscription>& Subscription)
+	{
+		return !Subscription->bRemoved &&
+			Subscription->ObserverHandle.RecordIndex == ObserverHandle.RecordIndex &&
+			Subscription->ObserverHandle.RecordSerial == ObserverHandle.RecordSerial;
+	};
+	const int32 Index = Subscriptions.IndexOfByPredicate(IsSubscription);
+	if (Index == INDEX_NONE) return false;
+
+	if (IsValid(EventSystem))
+		EventSystem->RemoveByHandle(ObserverHandle);
+
+	// Subscriptions are iterated while processing, so they're only marked, and removed when it finishes.
+	if (bProcessing)
+		Subscriptions[Index]->bRemoved = true;
+	else
+		Subscriptions.RemoveAt(Index);
+	return true;
+}
+
+void ULES_MassEventBridge::ProcessEvents(FMassExecutionContext& Context)
+{
+	if (!EntityManager.IsValid() || bProcessing) return;
+
+	TGuardValue<bool> ProcessingGuard(bProcessing, true);
+	const int32 NumSubscriptions = Subscriptions.Num();
+	for (int32 Index = 0; Index < NumSubscriptions; Index++)
+	{
+		FSubscription& Subscription = *Subscriptions[Index];
+		if (Subscription.bRemoved || Subscription.PendingEvents.IsEmpty()) continue;
+
+		// The events are moved out first, so that the ones sent by the handler wait for the next processing.
+		Swap(Subscription.PendingEvents, Subscription.ProcessedEvents);
+		const TArrayView<ULES_Event* const> Events = Subscription.ProcessedEvents;
+		auto ChunkFunction = [&Subscription, Events](FMassExecutionContext& ChunkContext)
+		{
+			if (!Subscription.bRemoved)
+				Subscription.Handler(ChunkContext, Events);
+		};
+		Subscription.Query.ForEachEntityChunk(*EntityManager, Context, ChunkFunction);
+		Subscription.ProcessedEvents.Reset();
+	}
+
+	Subscriptions.RemoveAll([](const TUniquePtr<FSubscription>& Subscription)
+	{
+		return Subscription->bRemoved;
+	});
+}
+
+void ULES_MassEventBridge::ProcessEvents()
+{
+	if (!EntityManager.IsValid()) return;
+
+	FMassExecutionContext Context(*EntityManager);
+	ProcessEvents(Context);
+}
+
+int32 ULES_MassEventBridge::GetNumPendingEvents() const
+{
+	int32 NumPendingEvents = 0;
+	for (const TUniquePtr<FSubscription>& Subscription : Subscriptions)
+		NumPendingEvents += Subscription->PendingEvents.Num();
+	return NumPendingEvents;
+}
+
+void ULES_MassEventBridge::ForEachBridge(const FMassEntityManager& EntityManager,
+                                         TFunctionRef<void(ULES_MassEventBridge& Bridge)> Function)
+{
+	check(IsInGameThread());
+	for (int32 Index = Bridges.Num() - 1; Index >= 0; Index--)
+	{
+		if (Bridges[Index]->EntityManager.Get() == &EntityManager)
+			Function(*Bridges[Index]);
+	}
+}
+
+void ULES_MassEventBridge::AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector)
+{
+	Super::AddReferencedObjects(InThis, Collector);
+
+	ULES_MassEventBridge* This = CastChecked<ULES_MassEventBridge>(InThis);
+	for (const TUniquePtr<FSubscription>& Subscription : This->Subscriptions)
+	{
+		for (ULES_Event*& Event : Subscription->PendingEvents)
+			Collector.AddReferencedObject(Event, This);
+		for (ULES_Event*& Event : Subscription->ProcessedEvents)
+			Collector.AddReferencedObject(Event, This);
+	}
+}
+
+void ULES_MassEventBridge::BeginDestroy()
+{
+	Bridges.Remove(this);
+	Subscriptions.Empty();
+	Super::BeginDestroy();
+}
+
+ULES_MassEventBridge::FSubscription* ULES_MassEventBridge::AddSubscription(const FMassEntityQuery& Query,
+                                                                           LES::FMassEventHandler&& Handler)
+{
+	if (!IsValid(EventSystem) || !EntityManager.IsValid()) return nullptr;
+
+	FSubscription& Subscription = *Subscriptions.Add_GetRef(MakeUnique<FSubscription>());
+	Subscription.Query = Query;
+	Subscription.Handler = MoveTemp(Handler);
+	return &Subscription;
+}
@@ -0,0 +1,31 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+
+#include "MassEventProcessor.h"
+
+#include "MassEventBridge.h"
+
+ULES_MassEventProcessor::ULES_MassEventProcessor()
+{
+	ExecutionFlags = static_cast<int32>(EProcessorExecutionFlags::All);
+	ProcessingPhase = EMassProcessingPhase::PrePhysics;
+	bRequiresGameThreadExecution = true;
+}
+
+void ULES_MassEventProcessor::ConfigureQueries()
+{
+	// Nothing to register. The queries belong to the subscriptions of the bridges, which come and go while the game
+	// runs, whereas Mass registers the queries of a processor once, when it's initialized. The subscriptions' queries
+	// run unregistered in Execute instead, against the entity managers of their bridges, which cache the matching
+	// archetypes themselves. The processing graph doesn't know which fragments the handlers access because of that,
+	// hence the game thread execution. Order the processor after the processors writing the same fragments with
+	// ExecutionOrder if they run in parallel.
+}
+
+void ULES_MassEventProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+	ULES_MassEventBridge::ForEachBridge(EntityManager, [&Context](ULES_MassEventBridge& Bridge)
+	{
+		Bridge.ProcessEvents(Context);
+	});
+}
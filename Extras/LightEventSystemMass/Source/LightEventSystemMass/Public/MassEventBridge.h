@@ -0,0 +1,175 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#pragma once
+
+#include "EventSystem.h"
+#include "MassEntityQuery.h"
+#include "MassEventBridge.generated.h"
+
+struct FMassEntityManager;
+struct FMassExecutionContext;
+
+namespace LES
+{
+	/**
+	 * Handler of the events for one chunk of entities. Reads and writes the fragments of the chunk's entities through
+	 * the \a Context, in a loop of its own.
+	 */
+	using FMassEventHandler = TFunction<void(FMassExecutionContext& Context, TArrayView<ULES_Event* const> Events)>;
+
+	/** Constrains the \a THandler to be a callable taking the execution context and a view of \a TEvent pointers. */
+	template <typename THandler, typename TEvent>
+	concept IsMassEventHandler = requires(THandler Handler, FMassExecutionContext& Context,
+	                                      TArrayView<const TEvent* const> Events)
+	{
+		Handler(Context, Events);
+	};
+}
+
+/**
+ * Delivers events to Mass entities, without proxy objects. Entities subscribe by the fragments and tags they have,
+ * through an entity query. Events sent on the Event System are collected per subscription, and processed by
+ * \a ULES_MassEventProcessor once per Mass frame: the subscription's handler is called once for every chunk of the
+ * matching entities, with all the events collected since the last processing. There's no per-entity callback, so the
+ * handlers iterate the fragments of a chunk in a dense loop. Example usage:
+ *
+ * Bridge->SubscribeByTag<UAlertRaised, FEnemyTag>([](FMassExecutionContext& Context,\n
+ *                                                   TArrayView<const UAlertRaised* const> Alerts)\n
+ * {\n
+ *		const TArrayView<FAlertFragment> AlertFragments = Context.GetMutableFragmentView<FAlertFragment>();\n
+ *		// Your code handling the events for the entities of the chunk.\n
+ * }, "Alerts");
+ *
+ * Outside of the Mass simulation, call \a ProcessEvents to process the collected events.
+ */
+UCLASS()
+class LIGHTEVENTSYSTEMMASS_API ULES_MassEventBridge : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	/** Sets the Event System the events are received from, and the entity manager of the subscribed entities. */
+	void Initialize(ULES_EventSystem* InEventSystem, const TSharedRef<FMassEntityManager>& InEntityManager);
+
+	/**
+	 * Subscribes the entities matching the \a Query to the events of \a TEvent type sent on the \a Channel. The query
+	 * should declare the fragments accessed by the \a Handler.
+	 *
+	 * @return A handle to the observer record of the subscription, or an invalid handle if the bridge isn't
+	 * initialized. Pass it to \a Unsubscribe to end the subscription.
+	 */
+	template <typename TEvent, typename THandler>
+		requires TIsDerivedFrom<TEvent, ULES_Event>::Value &&
+		!TIsSame<TEvent, ULES_Event>::Value &&
+		LES::IsMassEventHandler<THandler, TEvent>
+	FLES_ObserverHandle Subscribe(const FMassEntityQuery& Query, THandler Handler, const FName Channel = NAME_None);
+
+	/** Subscribes the entities with the \a TTag to the events of \a TEvent type sent on the \a Channel. */
+	template <typename TEvent, typename TTag, typename THandler>
+		requires TIsDerivedFrom<TTag, FMassTag>::Value
+	FLES_ObserverHandle SubscribeByTag(THandler Handler, const FName Channel = NAME_None);
+
+	/**
+	 * Subscribes the entities with the \a TFragment to the events of \a TEvent type sent on the \a Channel. The handler
+	 * may access the fragment as declared by the \a Access.
+	 */
+	template <typename TEvent, typename TFragment, typename THandler>
+		requires TIsDerivedFrom<TFragment, FMassFragment>::Value
+	FLES_ObserverHandle SubscribeByFragment(THandler Handler, const FName Channel = NAME_None,
+	                                        const EMassFragmentAccess Access = EMassFragmentAccess::ReadWrite);
+
+	/** Ends the subscription and drops its collected events. Returns false if the handle isn't a subscription. */
+	bool Unsubscribe(const FLES_ObserverHandle& ObserverHandle);
+
+	/**
+	 * Calls the handlers of the subscriptions with collected events for every chunk of their entities. Events sent by
+	 * the handlers wait for the next processing. Called by \a ULES_MassEventProcessor with the processor's \a Context.
+	 */
+	void ProcessEvents(FMassExecutionContext& Context);
+
+	/** Version of \a ProcessEvents with an execution context of its own, for use outside of the Mass simulation. */
+	void ProcessEvents();
+
+	/** Returns the amount of events waiting to be processed, over all subscriptions. */
+	int32 GetNumPendingEvents() const;
+
+	/** Calls the \a Function for every initialized bridge delivering events to the entities of the \a EntityManager. */
+	static void ForEachBridge(const FMassEntityManager& EntityManager,
+	                          TFunctionRef<void(ULES_MassEventBridge& Bridge)> Function);
+
+	static void AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector);
+	virtual void BeginDestroy() override;
+
+private:
+	struct FSubscription
+	{
+		FMassEntityQuery Query;
+		LES::FMassEventHandler Handler;
+		FLES_ObserverHandle ObserverHandle;
+
+		/** Events waiting to be processed, and the ones being processed right now. */
+		TArray<ULES_Event*> PendingEvents;
+		TArray<ULES_Event*> ProcessedEvents;
+
+		/** Set if the subscription ended while the events were processed. */
+		bool bRemoved = false;
+	};
+
+	UPROPERTY(Transient)
+	TObjectPtr<ULES_EventSystem> EventSystem;
+
+	TSharedPtr<FMassEntityManager> EntityManager;
+
+	/** Subscriptions have stable addresses, since their observer records point to them. */
+	TArray<TUniquePtr<FSubscription>> Subscriptions;
+	bool bProcessing = false;
+
+	/** Initialized bridges, found by the processor. Accessed only on the game thread. */
+	static TArray<ULES_MassEventBridge*> Bridges;
+
+	/** Adds the subscription, without its observer record. Returns nullptr if the bridge isn't initialized. */
+	FSubscription* AddSubscription(const FMassEntityQuery& Query, LES::FMassEventHandler&& Handler);
+};
+
+template <typename TEvent, typename THandler>
+	requires TIsDerivedFrom<TEvent, ULES_Event>::Value &&
+	!TIsSame<TEvent, ULES_Event>::Value &&
+	LES::IsMassEventHandler<THandler, TEvent>
+FLES_ObserverHandle ULES_MassEventBridge::Subscribe(const FMassEntityQuery& Query, THandler Handler,
+                                                    const FName Channel)
+{
+	// Subscriptions receive exactly the events of the TEvent class, so the view of the events is reinterpreted.
+	auto HandlerLambda = [Handler = MoveTemp(Handler)](FMassExecutionContext& Context,
+	                                                   const TArrayView<ULES_Event* const> Events)
+	{
+		Handler(Context, MakeArrayView(reinterpret_cast<const TEvent* const*>(Events.GetData()), Events.Num()));
+	};
+	FSubscription* Subscription = AddSubscription(Query, MoveTemp(HandlerLambda));
+	if (!Subscription) return {};
+
+	Subscription->ObserverHandle = EventSystem->AddObserver<TEvent>(this, [Subscription](TEvent* Event)
+	{
+		if (!Subscription->bRemoved)
+			Subscription->PendingEvents.Add(Event);
+	}, Channel);
+	return Subscription->ObserverHandle;
+}
+
+template <typename TEvent, typename TTag, typename THandler>
+	requires TIsDerivedFrom<TTag, FMassTag>::Value
+FLES_ObserverHandle ULES_MassEventBridge::SubscribeByTag(THandler Handler, const FName Channel)
+{
+	FMassEntityQuery Query;
+	Query.AddTagRequirement<TTag>(EMassFragmentPresence::All);
+	return Subscribe<TEvent>(Query, MoveTemp(Handler), Channel);
+}
+
+template <typename TEvent, typename TFragment, typename THandler>
+	requires TIsDerivedFrom<TFragment, FMassFragment>::Value
+FLES_ObserverHandle ULES_MassEventBridge::SubscribeByFragment(THandler Handler, const FName Channel,
+                                                              const EMassFragmentAccess Access)
+{
+	FMassEntityQuery Query;
+	Query.AddRequirement<TFragment>(Access);
+	return Subscribe<TEvent>(Query, MoveTemp(Handler), Channel);
+}
@@ -0,0 +1,23 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#pragma once
+
+#include "MassProcessor.h"
+#include "MassEventProcessor.generated.h"
+
+/**
+ * Processes the events collected by the Mass event bridges of the simulated entity manager, once per frame, before the
+ * physics. Runs on the game thread, since the handlers read the event objects. See \a ULES_MassEventBridge.
+ */
+UCLASS()
+class LIGHTEVENTSYSTEMMASS_API ULES_MassEventProcessor : public UMassProcessor
+{
+	GENERATED_BODY()
+
+public:
+	ULES_MassEventProcessor();
+
+protected:
+	virtual void ConfigureQueries() override;
+	virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+};
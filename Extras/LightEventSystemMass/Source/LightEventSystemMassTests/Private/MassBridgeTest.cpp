@@ -0,0 +1,184 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#include "MassEntityManager.h"
+#include "MassEventBridge.h"
+#include "MassExecutionContext.h"
+#include "MassTestTypes.h"
+#include "Misc/AutomationTest.h"
+
+namespace
+{
+	/** Returns a standalone entity manager, outside of any world. */
+	TSharedRef<FMassEntityManager> MakeEntityManager()
+	{
+		TSharedRef<FMassEntityManager> EntityManager = MakeShareable(new FMassEntityManager());
+		EntityManager->Initialize();
+		return EntityManager;
+	}
+
+	/** Adds the sum of the events' values to the test fragments of the chunk's entities. */
+	void AddEventValues(FMassExecutionContext& Context, TArrayView<const ULES_FloatEvent* const> Events)
+	{
+		float Sum = 0.0f;
+		for (const ULES_FloatEvent* Event : Events)
+			Sum += Event->Value;
+		for (FLES_MassTestFragment& Fragment : Context.GetMutableFragmentView<FLES_MassTestFragment>())
+			Fragment.Value += Sum;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLES_MassBridgeTest, "Light Event System.Mass bridge",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+bool FLES_MassBridgeTest::RunTest(const FString& Parameters)
+{
+	auto EventSystem = TStrongObjectPtr(NewObject<ULES_EventSystem>());
+	auto Bridge = TStrongObjectPtr(NewObject<ULES_MassEventBridge>());
+	const TSharedRef<FMassEntityManager> EntityManager = MakeEntityManager();
+	Bridge->Initialize(EventSystem.Get(), EntityManager);
+
+	const FMassArchetypeHandle TaggedArchetype = EntityManager->CreateArchetype(
+		{FLES_MassTestFragment::StaticStruct(), FLES_MassTestTag::StaticStruct()});
+	const FMassArchetypeHandle UntaggedArchetype = EntityManager->CreateArchetype(
+		{FLES_MassTestFragment::StaticStruct()});
+	TArray<FMassEntityHandle> TaggedEntities;
+	TArray<FMassEntityHandle> UntaggedEntities;
+	EntityManager->BatchCreateEntities(TaggedArchetype, 10, TaggedEntities);
+	EntityManager->BatchCreateEntities(UntaggedArchetype, 5, UntaggedEntities);
+
+	const FName Alerts = "Alerts";
+	FMassEntityQuery TaggedQuery;
+	TaggedQuery.AddRequirement<FLES_MassTestFragment>(EMassFragmentAccess::ReadWrite);
+	TaggedQuery.AddTagRequirement<FLES_MassTestTag>(EMassFragmentPresence::All);
+	const auto TaggedHandle = Bridge->Subscribe<ULES_FloatEvent>(TaggedQuery, &AddEventValues, Alerts);
+
+	int32 NumChunkCalls = 0;
+	int32 NumNotifiedEntities = 0;
+	auto CountEntities = [&NumChunkCalls, &NumNotifiedEntities](FMassExecutionContext& Context,
+	                                                             TArrayView<const ULES_FloatEvent* const> Events)
+	{
+		NumChunkCalls++;
+		NumNotifiedEntities += Context.GetNumEntities();
+	};
+	Bridge->SubscribeByFragment<ULES_FloatEvent, FLES_MassTestFragment>(CountEntities, Alerts,
+	                                                                    EMassFragmentAccess::ReadOnly);
+
+	EventSystem->SendEvent(LES::Create<ULES_FloatEvent>(1.0f, nullptr, Alerts));
+	EventSystem->SendEvent(LES::Create<ULES_FloatEvent>(2.0f, nullptr, Alerts));
+	TestEqual(TEXT("Events should wait for the processing"), Bridge->GetNumPendingEvents(), 4);
+	TestEqual(TEXT("Entities shouldn't be notified while sending"), NumChunkCalls, 0);
+
+	Bridge->ProcessEvents();
+	TestEqual(TEXT("Processing should consume the events"), Bridge->GetNumPendingEvents(), 0);
+	TestEqual(TEXT("Handler should be called once per archetype chunk"), NumChunkCalls, 2);
+	TestEqual(TEXT("Fragment subscription should cover all entities"), NumNotifiedEntities, 15);
+	TestEqual(TEXT("Tagged entities should receive the events"),
+	          EntityManager->GetFragmentDataChecked<FLES_MassTestFragment>(TaggedEntities[0]).Value, 3.0f);
+	TestEqual(TEXT("Untagged entities shouldn't receive the events"),
+	          EntityManager->GetFragmentDataChecked<FLES_MassTestFragment>(UntaggedEntities[0]).Value, 0.0f);
+
+	TestTrue(TEXT("Subscription should end"), Bridge->Unsubscribe(TaggedHandle));
+	TestFalse(TEXT("Subscription should end once"), Bridge->Unsubscribe(TaggedHandle));
+	EventSystem->SendEvent(LES::Create<ULES_FloatEvent>(1.0f, nullptr, Alerts));
+	Bridge->ProcessEvents();
+	TestEqual(TEXT("Ended subscription shouldn't receive events"),
+	          EntityManager->GetFragmentDataChecked<FLES_MassTestFragment>(TaggedEntities[0]).Value, 3.0f);
+	TestEqual(TEXT("Other subscriptions should keep receiving events"), NumChunkCalls, 4);
+
+	return true;
+}
+
+/**
+ * Compares delivering events to 100k entities through the Mass bridge with the UObject paths: an observer record per
+ * object, and a class-level subscription. Registration and delivery times are reported in the test's log. Delivery to
+ * the entities includes processing the collected events.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLES_MassBridgeBenchmark, "Light Event System.Benchmark.Mass entities",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::StressFilter)
+
+bool FLES_MassBridgeBenchmark::RunTest(const FString& Parameters)
+{
+	constexpr int32 NumObservers = 100000;
+	constexpr int32 NumSends = 16;
+	auto MeasureTime = [](auto&& Function)
+	{
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+		Function();
+		return FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles);
+	};
+	auto Event = TStrongObjectPtr(LES::Create<ULES_FloatEvent>(1.0f, nullptr, NAME_None));
+
+	// An observer record per object.
+	auto RecordEventSystem = TStrongObjectPtr(NewObject<ULES_EventSystem>());
+	TArray<TStrongObjectPtr<ULES_MassTestObserver>> Observers;
+	Observers.Reserve(NumObservers);
+	for (int32 Index = 0; Index < NumObservers; Index++)
+		Observers.Emplace(NewObject<ULES_MassTestObserver>());
+	const double RecordRegistrationTime = MeasureTime([&]
+	{
+		for (const TStrongObjectPtr<ULES_MassTestObserver>& Observer : Observers)
+			RecordEventSystem->AddObserver<ULES_FloatEvent>(Observer.Get(), &ULES_MassTestObserver::OnFloatEvent);
+	});
+	const double RecordDeliveryTime = MeasureTime([&]
+	{
+		for (int32 Index = 0; Index < NumSends; Index++)
+			RecordEventSystem->SendEvent(Event.Get());
+	});
+	TestEqual(TEXT("Objects should receive every event"), Observers.Last()->Counter, NumSends);
+	Observers.Empty();
+
+	// A class-level subscription.
+	auto ClassEventSystem = TStrongObjectPtr(NewObject<ULES_EventSystem>());
+	TArray<TStrongObjectPtr<ULES_MassTestClassObserver>> ClassObservers;
+	ClassObservers.Reserve(NumObservers);
+	const double ClassRegistrationTime = MeasureTime([&]
+	{
+		ClassEventSystem->AddClassObserver<ULES_FloatEvent, ULES_MassTestClassObserver>(
+			&ULES_MassTestClassObserver::OnFloatEvent);
+		for (int32 Index = 0; Index < NumObservers; Index++)
+			ClassObservers.Emplace(NewObject<ULES_MassTestClassObserver>());
+	});
+	const double ClassDeliveryTime = MeasureTime([&]
+	{
+		for (int32 Index = 0; Index < NumSends; Index++)
+			ClassEventSystem->SendEvent(Event.Get());
+	});
+	TestEqual(TEXT("Class instances should receive every event"), ClassObservers.Last()->Counter, NumSends);
+	ClassObservers.Empty();
+
+	// Entities, through the bridge.
+	auto MassEventSystem = TStrongObjectPtr(NewObject<ULES_EventSystem>());
+	auto Bridge = TStrongObjectPtr(NewObject<ULES_MassEventBridge>());
+	const TSharedRef<FMassEntityManager> EntityManager = MakeEntityManager();
+	Bridge->Initialize(MassEventSystem.Get(), EntityManager);
+	TArray<FMassEntityHandle> Entities;
+	const double MassRegistrationTime = MeasureTime([&]
+	{
+		const FMassArchetypeHandle Archetype = EntityManager->CreateArchetype(
+			{FLES_MassTestFragment::StaticStruct(), FLES_MassTestTag::StaticStruct()});
+		EntityManager->BatchCreateEntities(Archetype, NumObservers, Entities);
+		FMassEntityQuery Query;
+		Query.AddRequirement<FLES_MassTestFragment>(EMassFragmentAccess::ReadWrite);
+		Query.AddTagRequirement<FLES_MassTestTag>(EMassFragmentPresence::All);
+		Bridge->Subscribe<ULES_FloatEvent>(Query, &AddEventValues);
+	});
+	const double MassDeliveryTime = MeasureTime([&]
+	{
+		for (int32 Index = 0; Index < NumSends; Index++)
+			MassEventSystem->SendEvent(Event.Get());
+		Bridge->ProcessEvents();
+	});
+	TestEqual(TEXT("Entities should receive every event"),
+	          EntityManager->GetFragmentDataChecked<FLES_MassTestFragment>(Entities.Last()).Value,
+	          static_cast<float>(NumSends));
+
+	AddInfo(FString::Printf(TEXT("%d receivers, %d events. Registration / delivery in ms:"), NumObservers, NumSends));
+	AddInfo(FString::Printf(TEXT("Observer records: %.3f / %.3f"), RecordRegistrationTime, RecordDeliveryTime));
+	AddInfo(FString::Printf(TEXT("Class subscription: %.3f / %.3f"), ClassRegistrationTime, ClassDeliveryTime));
+	AddInfo(FString::Printf(TEXT("Mass entities: %.3f / %.3f"), MassRegistrationTime, MassDeliveryTime));
+
+	return true;
+}
@@ -0,0 +1,43 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#pragma once
+
+#include "BasicEvents.h"
+#include "EventSystem.h"
+#include "MassEntityTypes.h"
+#include "UObject/StrongObjectPtr.h"
+#include "MassTestTypes.generated.h"
+
+USTRUCT()
+struct FLES_MassTestFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	float Value = 0.0f;
+};
+
+USTRUCT()
+struct FLES_MassTestTag : public FMassTag
+{
+	GENERATED_BODY()
+};
+
+UCLASS(HideDropdown)
+class ULES_MassTestObserver : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	int32 Counter = 0;
+
+	void OnFloatEvent(const ULES_FloatEvent* FloatEvent)
+	{
+		Counter += FMath::TruncToInt32(FloatEvent->Value);
+	}
+};
+
+UCLASS(HideDropdown)
+class ULES_MassTestClassObserver : public ULES_MassTestObserver
+{
+	GENERATED_BODY()
+};
@@ -30,6 +30,7 @@ public class LightEventSystem : ModuleRules
 				"Core",
 				"CoreUObject",
 				"Engine",
+				"DeveloperSettings",
 				// ... add other public dependencies that you statically link with here ...
 			}
 		);
@@ -0,0 +1,115 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+
+#include "AsyncObserver.h"
+
+namespace LES
+{
+	FAsyncObserver::FAsyncObserver(FObserverCallback&& InWork, FObserverCallback&& InCompletion,
+	                               const int32 InMaxTasksInFlight)
+		: Work(MoveTemp(InWork)),
+		  Completion(MoveTemp(InCompletion)),
+		  MaxTasksInFlight(FMath::Max(InMaxTasksInFlight, 1))
+	{
+		InFlight.Reserve(MaxTasksInFlight);
+	}
+
+	FAsyncObserver::~FAsyncObserver()
+	{
+		Wait();
+	}
+
+	void FAsyncObserver::Add(ULES_Event* Event)
+	{
+		if (bRetired) return;
+
+		// The task gets its own copy, since the sender may reuse the event and the other observers may modify it. The
+		// event is the template of the copy, so its properties are copied without serialization.
+		Event = NewObject<ULES_Event>(GetTransientPackage(), Event->GetClass(), NAME_None, RF_NoFlags, Event);
+		const uint64 SendCycles = FPlatformTime::Cycles64();
+		if (Queue.IsEmpty() && InFlight.Num() < MaxTasksInFlight)
+		{
+			Launch(Event, SendCycles);
+			return;
+		}
+
+		Queue.Add({Event, SendCycles});
+		PeakQueuedEvents = FMath::Max(PeakQueuedEvents, Queue.Num());
+	}
+
+	void FAsyncObserver::Flush(TFunctionRef<void(ULES_Event*)> OnCompleted)
+	{
+		// The completion handler may send events to this observer, which appends new tasks, or retire it.
+		for (int32 Index = 0; Index < InFlight.Num();)
+		{
+			if (!InFlight[Index].Task.IsCompleted())
+			{
+				Index++;
+				continue;
+			}
+
+			const FTaskInFlight Finished = InFlight[Index];
+			InFlight.RemoveAt(Index, 1, EAllowShrinking::No);
+
+			const double Latency = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - Finished.SendCycles);
+			NumCompletedEvents++;
+			TotalLatency += Latency;
+			MaxLatency = FMath::Max(MaxLatency, Latency);
+
+			if (!bRetired)
+			{
+				if (Completion)
+					Completion(Finished.Event);
+				OnCompleted(Finished.Event);
+			}
+		}
+
+		int32 NumLaunched = 0;
+		while (!bRetired && NumLaunched < Queue.Num() && InFlight.Num() < MaxTasksInFlight)
+		{
+			const FQueuedEvent& Queued = Queue[NumLaunched++];
+			Launch(Queued.Event, Queued.SendCycles);
+		}
+		if (NumLaunched > 0)
+			Queue.RemoveAt(0, NumLaunched, EAllowShrinking::No);
+	}
+
+	void FAsyncObserver::Retire()
+	{
+		bRetired = true;
+		Queue.Empty();
+	}
+
+	void FAsyncObserver::Wait() const
+	{
+		for (const FTaskInFlight& Task : InFlight)
+			Task.Task.Wait();
+	}
+
+	FLES_AsyncObserverStats FAsyncObserver::GetStats() const
+	{
+		FLES_AsyncObserverStats Stats;
+		Stats.NumQueuedEvents = Queue.Num();
+		Stats.PeakQueuedEvents = PeakQueuedEvents;
+		Stats.NumTasksInFlight = InFlight.Num();
+		Stats.NumCompletedEvents = NumCompletedEvents;
+		Stats.AverageLatency = NumCompletedEvents > 0 ? TotalLatency / NumCompletedEvents : 0.0;
+		Stats.MaxLatency = MaxLatency;
+		return Stats;
+	}
+
+	void FAsyncObserver::AddReferencedObjects(FReferenceCollector& Collector)
+	{
+		for (FQueuedEvent& Queued : Queue)
+			Collector.AddReferencedObject(Queued.Event);
+		for (FTaskInFlight& Task : InFlight)
+			Collector.AddReferencedObject(Task.Event);
+	}
+
+	void FAsyncObserver::Launch(ULES_Event* Event, const uint64 SendCycles)
+	{
+		// The observer outlives its tasks, and the copy of the event is referenced until the task is completed.
+		UE::Tasks::FTask Task = UE::Tasks::Launch(TEXT("LES_AsyncObserver"), [this, Event] { Work(Event); });
+		InFlight.Add({Event, SendCycles, MoveTemp(Task)});
+	}
+}
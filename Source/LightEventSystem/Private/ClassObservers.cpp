@@ -0,0 +1,142 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+
+#include "ClassObservers.h"
+
+#include "UObject/UObjectHash.h"
+
+namespace LES
+{
+	/** Flags of the objects that are templates of the other objects, rather than live instances. */
+	constexpr EObjectFlags TemplateFlags = RF_ClassDefaultObject | RF_ArchetypeObject;
+
+	/** Flags of the objects whose constructor or loading hasn't finished yet. */
+	constexpr EObjectFlags IncompleteFlags = RF_NeedInitialization | RF_NeedLoad | RF_NeedPostLoad;
+
+	int32 FInstanceList::Num() const
+	{
+		FScopeLock Lock(&CriticalSection);
+		return Instances.Num() + PendingInstances.Num();
+	}
+
+	void FInstanceList::Add(UObject* Instance)
+	{
+		// Objects reported twice, by the listener and by the search for the existing instances, are added once.
+		int32& Index = Indices.FindOrAdd(Instance, INDEX_NONE);
+		if (Index == INDEX_NONE)
+			Index = EncodePending(PendingInstances.Add(Instance));
+	}
+
+	void FInstanceList::Remove(const UObjectBase* Instance)
+	{
+		int32 Index;
+		if (!Indices.RemoveAndCopyValue(Instance, Index)) return;
+
+		if (Index >= 0)
+		{
+			Instances.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+			if (Index < Instances.Num())
+				Indices[Instances[Index]] = Index;
+		}
+		else
+		{
+			Index = EncodePending(Index);
+			PendingInstances.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+			if (Index < PendingInstances.Num())
+				Indices[PendingInstances[Index]] = EncodePending(Index);
+		}
+	}
+
+	void FInstanceList::TakeSnapshot() const
+	{
+		FScopeLock Lock(&CriticalSection);
+		for (int32 Index = PendingInstances.Num() - 1; Index >= 0; Index--)
+		{
+			UObject* Instance = PendingInstances[Index];
+			if (Instance->HasAnyFlags(IncompleteFlags)) continue;
+
+			// The object moved in its place comes from the end of the array, which was already visited.
+			Indices[Instance] = Instances.Add(Instance);
+			PendingInstances.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+			if (Index < PendingInstances.Num())
+				Indices[PendingInstances[Index]] = EncodePending(Index);
+		}
+
+		Snapshot.Reserve(Snapshot.Num() + Instances.Num());
+		for (UObject* Instance : Instances)
+			Snapshot.Emplace(Instance);
+	}
+
+	FClassInstances::~FClassInstances()
+	{
+		StopListening();
+	}
+
+	FInstanceList& FClassInstances::FindOrAdd(UClass* Class)
+	{
+		check(IsInGameThread());
+		for (const TPair<const UClass*, TUniquePtr<FInstanceList>>& List : Lists)
+		{
+			if (List.Key == Class)
+				return *List.Value;
+		}
+
+		// Listening starts before the existing instances are collected, so that none created in between is missed.
+		// Instances reported twice are added once.
+		if (!bListening)
+		{
+			GUObjectArray.AddUObjectCreateListener(this);
+			GUObjectArray.AddUObjectDeleteListener(this);
+			bListening = true;
+		}
+
+		FScopeLock Lock(&CriticalSection);
+		FInstanceList& List = *Lists.Emplace_GetRef(Class, MakeUnique<FInstanceList>(CriticalSection)).Value;
+		ForEachObjectOfClass(Class, [&List](UObject* Instance)
+		{
+			List.Add(Instance);
+		}, true, TemplateFlags);
+		return List;
+	}
+
+	void FClassInstances::NotifyUObjectCreated(const UObjectBase* Object, int32 Index)
+	{
+		if (Object->GetFlags() & TemplateFlags) return;
+
+		FScopeLock Lock(&CriticalSection);
+		const UClass* Class = Object->GetClass();
+		for (const TPair<const UClass*, TUniquePtr<FInstanceList>>& List : Lists)
+		{
+			if (Class->IsChildOf(List.Key))
+				List.Value->Add(static_cast<UObject*>(const_cast<UObjectBase*>(Object)));
+		}
+	}
+
+	void FClassInstances::NotifyUObjectDeleted(const UObjectBase* Object, int32 Index)
+	{
+		// The class of a destroyed object may already be destroyed too, so the lists are searched by the object alone.
+		// The lists of destroyed classes are dropped, since their instances are gone and their address may be reused.
+		FScopeLock Lock(&CriticalSection);
+		for (int32 ListIndex = Lists.Num() - 1; ListIndex >= 0; ListIndex--)
+		{
+			if (Lists[ListIndex].Key == Object)
+				Lists.RemoveAtSwap(ListIndex, 1, EAllowShrinking::No);
+			else
+				Lists[ListIndex].Value->Remove(Object);
+		}
+	}
+
+	void FClassInstances::OnUObjectArrayShutdown()
+	{
+		StopListening();
+	}
+
+	void FClassInstances::StopListening()
+	{
+		if (!bListening) return;
+
+		GUObjectArray.RemoveUObjectCreateListener(this);
+		GUObjectArray.RemoveUObjectDeleteListener(this);
+		bListening = false;
+	}
+}
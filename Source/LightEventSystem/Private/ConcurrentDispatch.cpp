@@ -0,0 +1,162 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+
+#include "ConcurrentDispatch.h"
+
+#include "Async/UniqueLock.h"
+#include "HAL/PlatformTLS.h"
+
+namespace LES
+{
+	FEpochReclaimer::~FEpochReclaimer()
+	{
+		for (const FRetiredObject& Object : Retired)
+			Object.Deleter(Object.Object);
+	}
+
+	int32 FEpochReclaimer::EnterRead()
+	{
+		// The epoch may advance before the slot is taken, which only makes the reader keep more objects alive. Any
+		// writer that misses the slot has published its changes before, so the reader sees them.
+		const uint64 Epoch = GlobalEpoch.load();
+		for (int32 Slot = FPlatformTLS::GetCurrentThreadId() % MaxReaders;; Slot = (Slot + 1) % MaxReaders)
+		{
+			uint64 FreeEpoch = 0;
+			if (ReaderSlots[Slot].Epoch.compare_exchange_strong(FreeEpoch, Epoch))
+			{
+				// The reader's acquire loads of the shared pointers mustn't be ordered before the slot is published,
+				// or a writer could miss the slot and free what the reader is about to load.
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				return Slot;
+			}
+		}
+	}
+
+	void FEpochReclaimer::ExitRead(const int32 Slot)
+	{
+		ReaderSlots[Slot].Epoch.store(0, std::memory_order_release);
+	}
+
+	void FEpochReclaimer::Retire(void* Object, void (*Deleter)(void*))
+	{
+		// Readers that started after the epoch advanced can't reach the object anymore.
+		Retired.Add({.Epoch = GlobalEpoch.fetch_add(1), .Object = Object, .Deleter = Deleter});
+	}
+
+	int32 FEpochReclaimer::Reclaim()
+	{
+		if (Retired.IsEmpty()) return 0;
+
+		uint64 OldestEpoch = MAX_uint64;
+		for (const FReaderSlot& ReaderSlot : ReaderSlots)
+		{
+			const uint64 Epoch = ReaderSlot.Epoch.load();
+			if (Epoch != 0)
+				OldestEpoch = FMath::Min(OldestEpoch, Epoch);
+		}
+
+		return Retired.RemoveAll([OldestEpoch](const FRetiredObject& Object)
+		{
+			if (Object.Epoch >= OldestEpoch) return false;
+			Object.Deleter(Object.Object);
+			return true;
+		});
+	}
+
+	FConcurrentDispatcher::~FConcurrentDispatcher()
+	{
+		for (const TPair<int32, TPair<FBucket*, const FObserver*>>& Observer : ObserversById)
+			delete Observer.Value.Value;
+		for (const TUniquePtr<FBucket>& Bucket : Buckets)
+			delete Bucket->List.load();
+		delete Directory.load();
+	}
+
+	void FConcurrentDispatcher::Add(const int32 Id, const UClass* EventClass, const FName Channel,
+	                                FObserverCallback&& Callback)
+	{
+		UE::TUniqueLock Lock(WriterLock);
+		check(!ObserversById.Contains(Id));
+
+		FBucket& Bucket = FindOrAddBucket({EventClass, Channel});
+		const FObserver* Observer = new FObserver{MoveTemp(Callback)};
+		ReplaceList(Bucket, [Observer](TArray<const FObserver*>& Observers)
+		{
+			Observers.Add(Observer);
+		});
+		ObserversById.Add(Id, {&Bucket, Observer});
+		Reclaimer.Reclaim();
+	}
+
+	bool FConcurrentDispatcher::Remove(const int32 Id)
+	{
+		UE::TUniqueLock Lock(WriterLock);
+		TPair<FBucket*, const FObserver*> Observer;
+		if (!ObserversById.RemoveAndCopyValue(Id, Observer)) return false;
+
+		ReplaceList(*Observer.Key, [&Observer](TArray<const FObserver*>& Observers)
+		{
+			Observers.RemoveSingle(Observer.Value);
+		});
+		Reclaimer.Retire(Observer.Value);
+		Reclaimer.Reclaim();
+		return true;
+	}
+
+	void FConcurrentDispatcher::Dispatch(ULES_Event* Event) const
+	{
+		const FEpochReadScope ReadScope(Reclaimer);
+		const FDirectory* CurrentDirectory = Directory.load(std::memory_order_acquire);
+		if (!CurrentDirectory) return;
+
+		FBucket* const* Bucket = CurrentDirectory->Find({Event->GetClass(), Event->Channel});
+		if (!Bucket) return;
+
+		const FObserverList* List = (*Bucket)->List.load(std::memory_order_acquire);
+		if (!List) return;
+
+		for (const FObserver* Observer : List->Observers)
+			Observer->Callback(Event);
+	}
+
+	void FConcurrentDispatcher::Reclaim()
+	{
+		UE::TUniqueLock Lock(WriterLock);
+		Reclaimer.Reclaim();
+	}
+
+	int32 FConcurrentDispatcher::Num() const
+	{
+		UE::TUniqueLock Lock(WriterLock);
+		return ObserversById.Num();
+	}
+
+	void FConcurrentDispatcher::ReplaceList(FBucket& Bucket,
+	                                        TFunctionRef<void(TArray<const FObserver*>& Observers)> Edit)
+	{
+		const FObserverList* OldList = Bucket.List.load(std::memory_order_relaxed);
+		FObserverList* NewList = OldList ? new FObserverList(*OldList) : new FObserverList();
+		Edit(NewList->Observers);
+		Bucket.List.store(NewList);
+		if (OldList)
+			Reclaimer.Retire(OldList);
+	}
+
+	FConcurrentDispatcher::FBucket& FConcurrentDispatcher::FindOrAddBucket(const FKey& Key)
+	{
+		const FDirectory* OldDirectory = Directory.load(std::memory_order_relaxed);
+		if (OldDirectory)
+		{
+			if (FBucket* const* Bucket = OldDirectory->Find(Key))
+				return **Bucket;
+		}
+
+		FBucket* Bucket = Buckets.Add_GetRef(MakeUnique<FBucket>()).Get();
+		FDirectory* NewDirectory = OldDirectory ? new FDirectory(*OldDirectory) : new FDirectory();
+		NewDirectory->Add(Key, Bucket);
+		Directory.store(NewDirectory);
+		if (OldDirectory)
+			Reclaimer.Retire(OldDirectory);
+		return *Bucket;
+	}
+}
@@ -0,0 +1,49 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+
+#include "EventMailbox.h"
+
+namespace LES
+{
+	FEventMailbox::FEventMailbox(FBatchCallback&& InCallback, const int32 InMaxBatchSize)
+		: Callback(MoveTemp(InCallback)), MaxBatchSize(FMath::Max(InMaxBatchSize, 0))
+	{
+		if (MaxBatchSize > 0)
+		{
+			Events.Reserve(MaxBatchSize);
+			FlushedEvents.Reserve(MaxBatchSize);
+		}
+	}
+
+	bool FEventMailbox::Add(ULES_Event* Event)
+	{
+		Events.Add(Event);
+		return MaxBatchSize > 0 && Events.Num() >= MaxBatchSize;
+	}
+
+	TArrayView<ULES_Event* const> FEventMailbox::BeginFlush()
+	{
+		check(FlushedEvents.IsEmpty());
+		Swap(Events, FlushedEvents);
+
+		// Events destroyed explicitly while waiting are cleared by the garbage collector.
+		FlushedEvents.RemoveAll([](const ULES_Event* Event)
+		{
+			return !IsValid(Event);
+		});
+		return FlushedEvents;
+	}
+
+	void FEventMailbox::EndFlush()
+	{
+		FlushedEvents.Reset();
+	}
+
+	void FEventMailbox::AddReferencedObjects(FReferenceCollector& Collector)
+	{
+		for (ULES_Event*& Event : Events)
+			Collector.AddReferencedObject(Event);
+		for (ULES_Event*& Event : FlushedEvents)
+			Collector.AddReferencedObject(Event);
+	}
+}
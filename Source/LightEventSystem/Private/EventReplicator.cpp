@@ -0,0 +1,117 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+
+#include "EventReplicator.h"
+
+#include "LightEventSystemModule.h"
+#include "Misc/CoreDelegates.h"
+#include "Serialization/BitReader.h"
+
+void ULES_EventReplicator::Initialize(ULES_EventSystem* InEventSystem,
+                                      const TSharedRef<const LES::FReplicationTable>& InTable)
+{
+	EventSystem = InEventSystem;
+	Table = InTable;
+	OutgoingCodec = MakeUnique<LES::FEventPacketCodec>(InTable);
+	IncomingCodec = MakeUnique<LES::FEventPacketCodec>(InTable);
+	PacketWriter.Reset();
+
+	if (!EndOfFrameHandle.IsValid())
+	{
+		EndOfFrameHandle = FCoreDelegates::OnEndFrame.AddWeakLambda(this, [this]
+		{
+			if (bFlushAtEndOfFrame)
+				Flush();
+		});
+	}
+}
+
+bool ULES_EventReplicator::StartReplicating(const TSubclassOf<ULES_Event>& EventClass, const FName Channel)
+{
+	if (!IsValid(EventSystem) || !Table.IsValid() || !EventClass) return false;
+	if (Table->FindEventClass(EventClass) == INDEX_NONE || Table->FindChannel(Channel) == INDEX_NONE)
+	{
+		UE_LOG(LogLightEventSystem, Warning, TEXT("Can't replicate events of class %s on channel %s, not in the table."),
+		       *EventClass->GetName(), *Channel.ToString());
+		return false;
+	}
+
+	EventSystem->AddObserver_Private(EventClass, this, [this](ULES_Event* Event)
+	{
+		QueueEvent(Event);
+	}, Channel);
+	return true;
+}
+
+bool ULES_EventReplicator::QueueEvent(ULES_Event* Event)
+{
+	// Events received from the other end, which are outered to the replicator, aren't sent back. Events sent by their
+	// handlers are.
+	if (!OutgoingCodec || !Event || Event->GetOuter() == this) return false;
+
+	// Each event is preceded by a bit telling that another event follows.
+	FBitWriterMark Mark(PacketWriter);
+	PacketWriter.WriteBit(1);
+	if (!OutgoingCodec->Write(PacketWriter, Event))
+	{
+		Mark.Pop(PacketWriter);
+		return false;
+	}
+	NumEventsSent++;
+	return true;
+}
+
+void ULES_EventReplicator::Flush()
+{
+	if (PacketWriter.GetNumBits() == 0) return;
+
+	PacketWriter.WriteBit(0);
+	NumPacketsSent++;
+	NumBitsSent += PacketWriter.GetNumBits();
+	OnPacketReady.ExecuteIfBound(*PacketWriter.GetBuffer(), PacketWriter.GetNumBits());
+	PacketWriter.Reset();
+}
+
+bool ULES_EventReplicator::ReceivePacket(const TArray<uint8>& Data, const int64 NumBits)
+{
+	if (!IsValid(EventSystem) || !IncomingCodec) return false;
+
+	// The reader copies the bits from the data, so their amount comes from the other end and can't be trusted.
+	if (NumBits < 0 || NumBits > Data.Num() * 8ll)
+	{
+		UE_LOG(LogLightEventSystem, Warning, TEXT("Received a corrupted event packet, %lld bits in %d bytes."), NumBits,
+		       Data.Num());
+		return false;
+	}
+
+	FBitReader Reader(Data.GetData(), NumBits);
+	while (Reader.ReadBit() && !Reader.IsError())
+	{
+		ULES_Event* Event = IncomingCodec->Read(Reader, this);
+		if (!Event) break;
+		NumEventsReceived++;
+		EventSystem->SendEvent(Event);
+	}
+
+	if (Reader.IsError())
+	{
+		UE_LOG(LogLightEventSystem, Warning, TEXT("Received a corrupted event packet."));
+		return false;
+	}
+	return true;
+}
+
+void ULES_EventReplicator::ConnectLoopback(ULES_EventReplicator* Receiver)
+{
+	OnPacketReady.BindWeakLambda(Receiver, [Receiver](const TArray<uint8>& Data, const int64 NumBits)
+	{
+		Receiver->ReceivePacket(Data, NumBits);
+	});
+}
+
+void ULES_EventReplicator::BeginDestroy()
+{
+	FCoreDelegates::OnEndFrame.Remove(EndOfFrameHandle);
+	EndOfFrameHandle.Reset();
+	Super::BeginDestroy();
+}
@@ -4,6 +4,7 @@
 #include "EventSubsystem.h"
 
 #include "EventSystem.h"
+#include "EventSystemSettings.h"
 #include "Kismet/GameplayStatics.h"
 #include "Engine/GameInstance.h"
 
@@ -11,6 +12,14 @@ void ULES_EventSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 {
 	Super::Initialize(Collection);
 	EventSystem = NewObject<ULES_EventSystem>(this);
+	GetDefault<ULES_EventSystemSettings>()->ApplyTo(EventSystem);
+}
+
+void ULES_EventSubsystem::Deinitialize()
+{
+	if (IsValid(EventSystem) && GetDefault<ULES_EventSystemSettings>()->bLogUsageReport)
+		EventSystem->LogUsageReport();
+	Super::Deinitialize();
 }
 
 ULES_EventSystem* ULES_EventSubsystem::GetGlobalEventSystem(const UObject* WorldContextObject)
@@ -18,3 +27,23 @@ ULES_EventSystem* ULES_EventSubsystem::GetGlobalEventSystem(const UObject* World
 	const UGameInstance* GameInstance = UGameplayStatics::GetGameInstance(WorldContextObject);
 	return GameInstance ? GameInstance->GetSubsystem<ULES_EventSubsystem>()->EventSystem : nullptr;
 }
+
+void ULES_EventSubsystem::Tick(float DeltaTime)
+{
+	EventSystem->Tick(DeltaTime);
+}
+
+ETickableTickType ULES_EventSubsystem::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+bool ULES_EventSubsystem::IsTickable() const
+{
+	return IsValid(EventSystem);
+}
+
+TStatId ULES_EventSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(ULES_EventSubsystem, STATGROUP_Tickables);
+}
@@ -3,8 +3,74 @@
 
 #include "EventSystem.h"
 
+#include "LightEventSystemModule.h"
+#include "Components/SceneComponent.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformStackWalk.h"
+#include "Misc/CoreDelegates.h"
+#include "UObject/UObjectIterator.h"
+
+namespace
+{
+	FAutoConsoleCommand WatchdogCommand(
+		TEXT("LES.Watchdog"),
+		TEXT("Logs the slow-handler watchdog counters of the Event Systems on the game thread. Pass 'reset' to reset "
+		     "them afterwards."),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			const bool bReset = Args.Num() > 0 && Args[0] == TEXT("reset");
+			for (TObjectIterator<ULES_EventSystem> EventSystem; EventSystem; ++EventSystem)
+			{
+				// The Event Systems of the shards are used by their own threads.
+				if (EventSystem->IsOwnedByShard()) continue;
+
+				EventSystem->LogWatchdogStats();
+				if (bReset)
+					EventSystem->ResetWatchdogStats();
+			}
+		}));
+
+	FAutoConsoleCommand UsageCommand(
+		TEXT("LES.Usage"),
+		TEXT("Logs the reserved capacity and the peak use of the Event Systems on the game thread."),
+		FConsoleCommandDelegate::CreateLambda([]
+		{
+			for (TObjectIterator<ULES_EventSystem> EventSystem; EventSystem; ++EventSystem)
+			{
+				if (!EventSystem->IsOwnedByShard())
+					EventSystem->LogUsageReport();
+			}
+		}));
+
+	/**
+	 * Describes a handler by its name, or by the call site that added it. Symbolication is slow, so the call site is
+	 * written as a raw address unless \a bSymbolicate is set.
+	 */
+	FString DescribeHandler(const uint64 CallSite, const FName CallbackName, const FString& ObserverName,
+	                        const bool bSymbolicate)
+	{
+		FString Description;
+		if (!CallbackName.IsNone())
+		{
+			Description = FString::Printf(TEXT("Handler %s"), *CallbackName.ToString());
+		}
+		else if (bSymbolicate)
+		{
+			ANSICHAR Symbol[1024] = "";
+			FPlatformStackWalk::ProgramCounterToHumanReadableString(0, CallSite, Symbol, UE_ARRAY_COUNT(Symbol));
+			Description = FString::Printf(TEXT("Handler added at %hs"), Symbol);
+		}
+		else
+		{
+			Description = FString::Printf(TEXT("Handler added at 0x%016llx"), CallSite);
+		}
+		return Description + TEXT(" of ") + ObserverName;
+	}
+}
+
 FLES_ObserverHandle ULES_EventSystem::BP_AddObserver_Event(const TSubclassOf<ULES_Event>& EventClass, UObject* Observer,
-                                                           FLES_EventHandler Callback, const FName Channel)
+                                                           FLES_EventHandler Callback, const FName Channel,
+                                                           const FName Group)
 {
 	if (!IsValid(Observer) || !IsValid(EventClass)) return {};
 
@@ -13,118 +79,934 @@ FLES_ObserverHandle ULES_EventSystem::BP_AddObserver_Event(const TSubclassOf<ULE
 		if (Observer.IsValid())
 			Callback.ExecuteIfBound(Event);
 	};
-	return AddObserver_Private(EventClass, Observer, CallbackLambda, Channel);
+	const FLES_ObserverHandle Handle = AddObserver_Private(EventClass, Observer, MoveTemp(CallbackLambda), Channel, {},
+	                                                       Group);
+	ObserverRecords[Handle.RecordIndex].CallbackName = Callback.GetFunctionName();
+	return Handle;
 }
 
 FLES_ObserverHandle ULES_EventSystem::BP_AddObserver_Function(const TSubclassOf<ULES_Event>& EventClass,
                                                               UObject* Observer,
-                                                              const FName FunctionName, const FName Channel)
+                                                              const FName FunctionName, const FName Channel,
+                                                              const FName Group)
 {
 	if (!IsValid(Observer) || !IsValid(EventClass)) return {};
 
 	UFunction* Callback = FindCallbackFunction(Observer, FunctionName);
 	if (!Callback) return {};
 
-	auto CallbackLambda = [
-			Observer = TWeakObjectPtr<>(Observer),
-			Callback = TWeakObjectPtr<UFunction>(Callback)
-		](ULES_Event* Event)
+	return AddObserver_Function(EventClass, Observer, Callback, Channel, Group);
+}
+
+FLES_ObserverHandle ULES_EventSystem::BP_AddObserver_Resolved(const TSubclassOf<ULES_Event>& EventClass,
+                                                              UObject* Observer, const FName FunctionName,
+                                                              const FName Channel, const FName Group)
+{
+	if (!IsValid(Observer) || !IsValid(EventClass)) return {};
+
+	// The signature has been checked by the blueprint compiler, but the observer passed at runtime may be of another
+	// class than the node was compiled against. Only the single parameter is checked, without a full walk.
+	UFunction* Callback = Observer->FindFunction(FunctionName);
+	if (!Callback || Callback->NumParms != 1) return {};
+
+	const FObjectProperty* EventProperty = CastField<FObjectProperty>(Callback->ChildProperties);
+	if (!EventProperty || EventProperty->HasAnyPropertyFlags(CPF_OutParm | CPF_ReturnParm) ||
+		!EventClass->IsChildOf(EventProperty->PropertyClass))
+	{
+		return {};
+	}
+
+	return AddObserver_Function(EventClass, Observer, Callback, Channel, Group);
+}
+
+void ULES_EventSystem::SendEvent(ULES_Event* Event)
+{
+	if (!IsValid(Event)) return;
+	if (!BeforeSend(Event)) return;
+
+	const int32 BucketIndex = FindObservedBucket(Event->GetClass(), Event->Channel);
+	if (BucketIndex != INDEX_NONE)
+		DispatchEvent(BucketIndex, Event);
+	else
+		TrackUnobservedSend(Event->GetClass(), Event->Channel, Event->Sender, PLATFORM_RETURN_ADDRESS());
+	AfterSend(Event);
+}
+
+void ULES_EventSystem::SendEvent(const FLES_SendToken& Token, ULES_Event* Event)
+{
+	if (!IsValid(Event)) return;
+
+	const bool bMatchesToken = IsSendTokenValid(Token) &&
+		Buckets[Token.BucketIndex].EventClass == Event->GetClass() &&
+		Buckets[Token.BucketIndex].Key.Value == Event->Channel;
+	if (!bMatchesToken)
+	{
+		SendEvent(Event);
+		return;
+	}
+
+	if (!BeforeSend(Event)) return;
+	if (Buckets[Token.BucketIndex].NumRecords > 0)
+		DispatchEvent(Token.BucketIndex, Event);
+	else
+		TrackUnobservedSend(Event->GetClass(), Event->Channel, Event->Sender, PLATFORM_RETURN_ADDRESS());
+	AfterSend(Event);
+}
+
+void ULES_EventSystem::SendQuery(ULES_Event* Event, LES::FQueryState& QueryState)
+{
+	if (!IsValid(Event)) return;
+	if (!BeforeSend(Event)) return;
+
+	const int32 BucketIndex = FindObservedBucket(Event->GetClass(), Event->Channel);
+	if (BucketIndex != INDEX_NONE)
+	{
+		TGuardValue<LES::FQueryState*> QueryGuard(ActiveQuery, &QueryState);
+		DispatchEvent(BucketIndex, Event, &QueryState.bDone);
+	}
+	else
+	{
+		TrackUnobservedSend(Event->GetClass(), Event->Channel, Event->Sender, PLATFORM_RETURN_ADDRESS());
+	}
+	AfterSend(Event);
+}
+
+void ULES_EventSystem::SendEventConcurrent(ULES_Event* Event) const
+{
+	if (Event)
+		ConcurrentObservers.Dispatch(Event);
+}
+
+void ULES_EventSystem::BP_SendEvent_Token(const FLES_SendToken& Token, ULES_Event* Event)
+{
+	SendEvent(Token, Event);
+}
+
+bool ULES_EventSystem::HasObservers(const TSubclassOf<ULES_Event>& EventClass, const FName Channel) const
+{
+	return FindObservedBucket(EventClass, Channel) != INDEX_NONE;
+}
+
+TArray<FLES_UnobservedSend> ULES_EventSystem::GetUnobservedSends(const int64 MinNumSends) const
+{
+	TArray<FLES_UnobservedSend> Report;
+#if LES_WITH_SEND_REPORT
+	for (const TPair<TTuple<FObjectKey, FName, uint64>, FUnobservedSendStats>& Pair : UnobservedSends)
+	{
+		if (Pair.Value.NumSends < MinNumSends) continue;
+
+		ANSICHAR CallSite[1024] = "";
+		FPlatformStackWalk::ProgramCounterToHumanReadableString(0, Pair.Key.Get<2>(), CallSite,
+		                                                        UE_ARRAY_COUNT(CallSite));
+
+		FLES_UnobservedSend& Send = Report.AddDefaulted_GetRef();
+		Send.EventClass = Cast<UClass>(Pair.Key.Get<0>().ResolveObjectPtr());
+		Send.Channel = Pair.Key.Get<1>();
+		Send.CallSite = ANSI_TO_TCHAR(CallSite);
+		if (!Pair.Value.SenderClass.IsNone())
+			Send.CallSite += FString::Printf(TEXT(" (sender %s)"), *Pair.Value.SenderClass.ToString());
+		Send.NumSends = Pair.Value.NumSends;
+	}
+	Report.Sort([](const FLES_UnobservedSend& A, const FLES_UnobservedSend& B) { return A.NumSends > B.NumSends; });
+#endif
+	return Report;
+}
+
+void ULES_EventSystem::LogUnobservedSends(const int64 MinNumSends) const
+{
+	const TArray<FLES_UnobservedSend> Report = GetUnobservedSends(MinNumSends);
+	UE_LOG(LogLightEventSystem, Log, TEXT("%d kinds of events sent without observers:"), Report.Num());
+	for (const FLES_UnobservedSend& Send : Report)
+	{
+		UE_LOG(LogLightEventSystem, Log, TEXT("%10lld  %s on channel %s, sent from %s"), Send.NumSends,
+		       *GetNameSafe(Send.EventClass), *Send.Channel.ToString(), *Send.CallSite);
+	}
+}
+
+void ULES_EventSystem::ResetUnobservedSends()
+{
+#if LES_WITH_SEND_REPORT
+	UnobservedSends.Reset();
+#endif
+}
+
+FLES_SendToken ULES_EventSystem::ResolveSendToken(const TSubclassOf<ULES_Event>& EventClass, const FName Channel)
+{
+	if (!IsValid(EventClass)) return {};
+
+	const int32 BucketIndex = FindOrAddBucket(EventClass, Channel);
+	return {this, BucketIndex, Buckets[BucketIndex].Serial};
+}
+
+bool ULES_EventSystem::IsSendTokenValid(const FLES_SendToken& Token) const
+{
+	return Token.EventSystem == this &&
+		Buckets.IsValidIndex(Token.BucketIndex) &&
+		Buckets[Token.BucketIndex].Serial == Token.BucketSerial;
+}
+
+bool ULES_EventSystem::SetStreamOperators(const FLES_ObserverHandle& ObserverHandle,
+                                          const FLES_StreamOperators& Operators)
+{
+	if (!ContainsValidHandle(ObserverHandle)) return false;
+
+	LES::FObserverRecord& Record = ObserverRecords[ObserverHandle.RecordIndex];
+	if (Operators.IsEmpty())
+	{
+		Record.Operators.Reset();
+		return true;
+	}
+
+	if (!Record.Operators.IsValid())
+		OperatorRecords.Emplace(ObserverHandle.RecordIndex, Record.Serial);
+	Record.Operators = MakeUnique<LES::FStreamOperatorState>(Operators, ObserverHandle.ObserverKey.Key.Get());
+	return true;
+}
+
+bool ULES_EventSystem::SetSpatialFilter(const FLES_ObserverHandle& ObserverHandle,
+                                        const USceneComponent* PositionSource, const float Radius)
+{
+	if (!ContainsValidHandle(ObserverHandle)) return false;
+
+	const int32 BucketIndex = FindBucket(ObserverHandle.ObserverKey.Key.Get(), ObserverHandle.ObserverKey.Value);
+	if (BucketIndex == INDEX_NONE || !Buckets[BucketIndex].EventClass->IsChildOf<ULES_SpatialEvent>()) return false;
+
+	FBucket& Bucket = Buckets[BucketIndex];
+	LES::FObserverRecord& Record = ObserverRecords[ObserverHandle.RecordIndex];
+	if (Record.SpatialEntry != INDEX_NONE)
+	{
+		Bucket.SpatialObservers->SetSource(Record.SpatialEntry, PositionSource, Radius);
+		return true;
+	}
+
+	// Moves the record from the bucket's list to its spatial hash.
+	TArray<int32>& Records = FindOrAddRecordList(Bucket, Record.Group).Records;
+	const int32 Position = Records.Find(ObserverHandle.RecordIndex);
+	if (DispatchDepth > 0)
+	{
+		Records[Position] = INDEX_NONE;
+		CompactAfterDispatch(BucketIndex);
+	}
+	else
+	{
+		Records.RemoveAt(Position, 1, EAllowShrinking::No);
+	}
+
+	if (!Bucket.SpatialObservers.IsValid())
+		Bucket.SpatialObservers = MakeUnique<LES::FSpatialHash>(SpatialCellSize);
+	Record.SpatialEntry = Bucket.SpatialObservers->Add(ObserverHandle.RecordIndex, FVector::ZeroVector, Radius,
+	                                                   PositionSource);
+	return true;
+}
+
+bool ULES_EventSystem::SetSpatialObserverLocation(const FLES_ObserverHandle& ObserverHandle, const FVector& Location)
+{
+	if (!ContainsValidHandle(ObserverHandle)) return false;
+
+	const int32 SpatialEntry = ObserverRecords[ObserverHandle.RecordIndex].SpatialEntry;
+	if (SpatialEntry == INDEX_NONE) return false;
+
+	const int32 BucketIndex = FindBucket(ObserverHandle.ObserverKey.Key.Get(), ObserverHandle.ObserverKey.Value);
+	Buckets[BucketIndex].SpatialObservers->SetPosition(SpatialEntry, Location);
+	return true;
+}
+
+void ULES_EventSystem::UpdateSpatialObservers()
+{
+	for (FBucket& Bucket : Buckets)
+	{
+		if (Bucket.SpatialObservers.IsValid())
+			Bucket.SpatialObservers->Update();
+	}
+}
+
+void ULES_EventSystem::SuspendGroup(const FName Group)
+{
+	if (Group.IsNone()) return;
+
+	Groups[FindOrAddGroup(Group)].bSuspended = true;
+}
+
+void ULES_EventSystem::ResumeGroup(const FName Group)
+{
+	if (const int32* GroupIndex = GroupIndices.Find(Group))
+		Groups[*GroupIndex].bSuspended = false;
+}
+
+bool ULES_EventSystem::IsGroupSuspended(const FName Group) const
+{
+	const int32* GroupIndex = GroupIndices.Find(Group);
+	return GroupIndex && Groups[*GroupIndex].bSuspended;
+}
+
+FName ULES_EventSystem::GetGroup(const FLES_ObserverHandle& ObserverHandle) const
+{
+	if (!ContainsValidHandle(ObserverHandle)) return NAME_None;
+
+	return Groups[ObserverRecords[ObserverHandle.RecordIndex].Group].Name;
+}
+
+bool ULES_EventSystem::SetDeliveryDeferred(const FLES_ObserverHandle& ObserverHandle, const bool bDeferred)
+{
+	if (!ContainsValidHandle(ObserverHandle)) return false;
+
+	ObserverRecords[ObserverHandle.RecordIndex].bDeferred = bDeferred;
+	return true;
+}
+
+bool ULES_EventSystem::IsDeliveryDeferred(const FLES_ObserverHandle& ObserverHandle) const
+{
+	return ContainsValidHandle(ObserverHandle) && ObserverRecords[ObserverHandle.RecordIndex].bDeferred;
+}
+
+FLES_WatchdogStats ULES_EventSystem::GetWatchdogStats() const
+{
+	return WatchdogStats;
+}
+
+void ULES_EventSystem::ResetWatchdogStats()
+{
+	WatchdogStats = FLES_WatchdogStats();
+	SlowHandlers.Reset();
+}
+
+void ULES_EventSystem::LogWatchdogStats() const
+{
+	UE_LOG(LogLightEventSystem, Log,
+	       TEXT("%s: %lld handler calls timed, %lld over the budget, the slowest took %.3f ms. %d records demoted, ")
+	       TEXT("%lld deferred deliveries."),
+	       *GetPathName(), WatchdogStats.NumTimedCalls, WatchdogStats.NumOverBudgetCalls, WatchdogStats.SlowestCallTime,
+	       WatchdogStats.NumDemotedRecords, WatchdogStats.NumDeferredDeliveries);
+	for (const TPair<TTuple<uint64, FName, FObjectKey, FName>, FSlowHandlerStats>& Pair : SlowHandlers)
+	{
+		UE_LOG(LogLightEventSystem, Log, TEXT("    %s receiving %s on channel %s: %lld calls over the budget, ")
+		       TEXT("the slowest took %.3f ms"),
+		       *DescribeHandler(Pair.Key.Get<0>(), Pair.Key.Get<1>(), Pair.Value.ObserverName, true),
+		       *GetNameSafe(Pair.Key.Get<2>().ResolveObjectPtr()), *Pair.Key.Get<3>().ToString(),
+		       Pair.Value.NumOverBudgetCalls, Pair.Value.SlowestCallTime);
+	}
+}
+
+void ULES_EventSystem::SendEventConflated(ULES_Event* Event)
+{
+	if (!IsValid(Event)) return;
+
+	ConflationStats.NumSends++;
+	const LES::FConflationKey Key{Event->GetClass(), Event->Channel, Event->Sender.Get()};
+	if (const int32* Index = ConflatedEventIndices.Find(Key))
+	{
+		ConflatedEvents[*Index] = Event;
+		ConflationStats.NumMerged++;
+		return;
+	}
+
+	ConflatedEventIndices.Add(Key, ConflatedEvents.Add(Event));
+	if (ConflationFlushPoint == ELES_ConflationFlushPoint::EndOfFrame && !EndOfFrameHandle.IsValid())
+	{
+		EndOfFrameHandle = FCoreDelegates::OnEndFrame.AddWeakLambda(this, [this]
+		{
+			if (ConflationFlushPoint == ELES_ConflationFlushPoint::EndOfFrame)
+				FlushConflatedEvents();
+		});
+	}
+}
+
+void ULES_EventSystem::FlushConflatedEvents()
+{
+	// The queue is swapped out before sending, so that the events conflated by the handlers wait for the next flush,
+	// even if the handlers flush the queue themselves.
+	if (ConflatedEvents.IsEmpty() || !FlushedConflatedEvents.IsEmpty()) return;
+
+	Swap(ConflatedEvents, FlushedConflatedEvents);
+	ConflatedEventIndices.Reset();
+
+	ConflationStats.NumDispatched += FlushedConflatedEvents.Num();
+	for (int32 Index = 0; Index < FlushedConflatedEvents.Num(); Index++)
+	{
+		SendEvent(FlushedConflatedEvents[Index]);
+	}
+	FlushedConflatedEvents.Reset();
+}
+
+FLES_ConflationStats ULES_EventSystem::GetConflationStats() const
+{
+	return ConflationStats;
+}
+
+void ULES_EventSystem::ResetConflationStats()
+{
+	ConflationStats = {};
+}
+
+FLES_ScheduledEventHandle ULES_EventSystem::SendEventDelayed(ULES_Event* Event, const double Delay)
+{
+	return SendEventAt(Event, CurrentTime + Delay);
+}
+
+FLES_ScheduledEventHandle ULES_EventSystem::SendEventAt(ULES_Event* Event, const double Time)
+{
+	if (!IsValid(Event)) return {};
+
+	FLES_ScheduledEventHandle Handle = ScheduledEvents.Schedule(Event, Time);
+	Handle.EventSystem = this;
+	return Handle;
+}
+
+bool ULES_EventSystem::CancelScheduledEvent(const FLES_ScheduledEventHandle& ScheduledEventHandle)
+{
+	// The wheels of different Event Systems hand out the same indices and serials.
+	return ScheduledEventHandle.EventSystem == this && ScheduledEvents.Cancel(ScheduledEventHandle);
+}
+
+bool ULES_EventSystem::IsEventScheduled(const FLES_ScheduledEventHandle& ScheduledEventHandle) const
+{
+	return ScheduledEventHandle.EventSystem == this && ScheduledEvents.IsScheduled(ScheduledEventHandle);
+}
+
+int ULES_EventSystem::GetNumScheduledEvents() const
+{
+	return ScheduledEvents.Num();
+}
+
+double ULES_EventSystem::GetTime() const
+{
+	return CurrentTime;
+}
+
+void ULES_EventSystem::Tick(const float DeltaTime)
+{
+	UpdateSpatialObservers();
+	DeliverDeferredEvents();
+
+	if (ConflationFlushPoint == ELES_ConflationFlushPoint::Tick)
+		FlushConflatedEvents();
+
+	CurrentTime += DeltaTime;
+
+	// Due events are moved out of the wheel before any of them is sent, so that the handlers may freely schedule and
+	// cancel other events.
+	check(DueEvents.IsEmpty());
+	ScheduledEvents.Advance(CurrentTime, DueEvents);
+	for (int32 Index = 0; Index < DueEvents.Num(); Index++)
+	{
+		SendEvent(DueEvents[Index]);
+	}
+	DueEvents.Reset();
+
+	for (int32 Index = OperatorRecords.Num() - 1; Index >= 0; Index--)
+	{
+		const auto [RecordIndex, RecordSerial] = OperatorRecords[Index];
+		if (!ObserverRecords.IsValid(RecordIndex, RecordSerial) || !ObserverRecords[RecordIndex].Operators.IsValid())
+		{
+			OperatorRecords.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+			continue;
+		}
+
+		// Records have stable addresses, so the record stays put even if the handler adds observers. Removing it is
+		// deferred, like during the dispatch, so the handler isn't destroyed while running.
+		const LES::FObserverRecord& Record = ObserverRecords[RecordIndex];
+		if (!Record.Observer.IsValid() || Groups[Record.Group].bSuspended) continue;
+		if (ULES_Event* Event = Record.Operators->Flush(CurrentTime))
+		{
+			DispatchDepth++;
+			NotifyObserver(RecordIndex, Event, GetHandlerBudget(Event->Channel));
+			if (--DispatchDepth == 0 && HasDeferredRemovals())
+				ApplyDeferredRemovals();
+		}
+	}
+
+	FlushMailboxes();
+	FlushAsyncObservers();
+	ConcurrentObservers.Reclaim();
+}
+
+void ULES_EventSystem::FlushAsyncObservers()
+{
+	for (int32 Index = AsyncRecords.Num() - 1; Index >= 0; Index--)
+	{
+		const auto [RecordIndex, RecordSerial] = AsyncRecords[Index];
+		if (!ObserverRecords.IsValid(RecordIndex, RecordSerial))
+		{
+			AsyncRecords.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+			continue;
+		}
+		FlushAsyncObserver(RecordIndex);
+	}
+
+	for (int32 Index = RetiredAsyncObservers.Num() - 1; Index >= 0; Index--)
+	{
+		RetiredAsyncObservers[Index]->Flush([](ULES_Event*) {});
+		if (RetiredAsyncObservers[Index]->IsIdle())
+			RetiredAsyncObservers.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	}
+}
+
+FLES_AsyncObserverStats ULES_EventSystem::GetAsyncObserverStats(const FLES_ObserverHandle& ObserverHandle) const
+{
+	if (!ContainsValidHandle(ObserverHandle)) return {};
+
+	const LES::FObserverRecord& Record = ObserverRecords[ObserverHandle.RecordIndex];
+	return Record.AsyncObserver.IsValid() ? Record.AsyncObserver->GetStats() : FLES_AsyncObserverStats();
+}
+
+void ULES_EventSystem::FlushMailboxes()
+{
+	for (int32 Index = MailboxRecords.Num() - 1; Index >= 0; Index--)
+	{
+		const auto [RecordIndex, RecordSerial] = MailboxRecords[Index];
+		if (!ObserverRecords.IsValid(RecordIndex, RecordSerial))
+		{
+			MailboxRecords.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+			continue;
+		}
+
+		// Mailboxes of the suspended groups keep their events until the group is resumed.
+		const LES::FObserverRecord& Record = ObserverRecords[RecordIndex];
+		if (Record.Observer.IsValid() && !Groups[Record.Group].bSuspended)
+			FlushMailbox(RecordIndex);
+	}
+}
+
+void ULES_EventSystem::AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector)
+{
+	Super::AddReferencedObjects(InThis, Collector);
+
+	ULES_EventSystem* This = CastChecked<ULES_EventSystem>(InThis);
+	This->ScheduledEvents.AddReferencedObjects(Collector);
+	for (ULES_Event*& Event : This->DueEvents)
+		Collector.AddReferencedObject(Event, This);
+	for (FDeferredDelivery& Delivery : This->DeferredDeliveries)
+		Collector.AddReferencedObject(Delivery.Event, This);
+	for (FDeferredDelivery& Delivery : This->DueDeliveries)
+		Collector.AddReferencedObject(Delivery.Event, This);
+	for (const auto [RecordIndex, RecordSerial] : This->OperatorRecords)
+	{
+		LES::FObserverRecord& Record = This->ObserverRecords[RecordIndex];
+		if (Record.Serial == RecordSerial && Record.Operators.IsValid())
+			Record.Operators->AddReferencedObjects(Collector);
+	}
+	for (const auto [RecordIndex, RecordSerial] : This->MailboxRecords)
+	{
+		LES::FObserverRecord& Record = This->ObserverRecords[RecordIndex];
+		if (Record.Serial == RecordSerial && Record.Mailbox.IsValid())
+			Record.Mailbox->AddReferencedObjects(Collector);
+	}
+	for (const auto [RecordIndex, RecordSerial] : This->AsyncRecords)
+	{
+		LES::FObserverRecord& Record = This->ObserverRecords[RecordIndex];
+		if (Record.Serial == RecordSerial && Record.AsyncObserver.IsValid())
+			Record.AsyncObserver->AddReferencedObjects(Collector);
+	}
+	for (const TUniquePtr<LES::FAsyncObserver>& AsyncObserver : This->RetiredAsyncObservers)
+		AsyncObserver->AddReferencedObjects(Collector);
+}
+
+void ULES_EventSystem::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	if (!HasAnyFlags(RF_ClassDefaultObject))
+	{
+		PostGarbageCollectHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddWeakLambda(this, [this]
+		{
+			if (bCleanAfterGarbageCollection)
+				Clean();
+			PurgeUnloadedEventClasses();
+		});
+	}
+}
+
+void ULES_EventSystem::BeginDestroy()
+{
+	FCoreDelegates::OnEndFrame.Remove(EndOfFrameHandle);
+	EndOfFrameHandle.Reset();
+	FCoreUObjectDelegates::GetPostGarbageCollect().Remove(PostGarbageCollectHandle);
+	PostGarbageCollectHandle.Reset();
+	ClassInstances.Reset();
+
+	// The events of the running tasks are referenced only until the Event System is destroyed.
+	for (const auto [RecordIndex, RecordSerial] : AsyncRecords)
+	{
+		const LES::FObserverRecord& Record = ObserverRecords[RecordIndex];
+		if (Record.Serial == RecordSerial && Record.AsyncObserver.IsValid())
+			Record.AsyncObserver->Wait();
+	}
+	for (const TUniquePtr<LES::FAsyncObserver>& AsyncObserver : RetiredAsyncObservers)
+		AsyncObserver->Wait();
+	Super::BeginDestroy();
+}
+
+template <typename TFunction>
+void ULES_EventSystem::ForEachRecord(const FBucket& Bucket, TFunction Function) const
+{
+	for (const FRecordList& RecordList : Bucket.RecordLists)
+	{
+		for (const int32 RecordIndex : RecordList.Records)
+		{
+			if (RecordIndex != INDEX_NONE)
+				Function(RecordIndex);
+		}
+	}
+
+	if (Bucket.SpatialObservers.IsValid())
+	{
+		for (const int32 RecordIndex : Bucket.SpatialObservers->GetRecords())
+		{
+			if (RecordIndex != INDEX_NONE)
+				Function(RecordIndex);
+		}
+	}
+}
+
+template <typename TPredicate>
+int32 ULES_EventSystem::RemoveRecords(const int32 BucketIndex, TPredicate Predicate)
+{
+	FBucket& Bucket = Buckets[BucketIndex];
+
+	int32 Count = 0;
+	for (FRecordList& RecordList : Bucket.RecordLists)
+	{
+		int32 NumCleared = 0;
+		for (int32& RecordIndex : RecordList.Records)
+		{
+			if (RecordIndex == INDEX_NONE || !Predicate(ObserverRecords[RecordIndex])) continue;
+
+			ReleaseRecord(RecordIndex);
+			RecordIndex = INDEX_NONE;
+			NumCleared++;
+		}
+
+		if (NumCleared > 0)
+		{
+			if (DispatchDepth == 0)
+				RecordList.Records.RemoveAll([](const int32 RecordIndex) { return RecordIndex == INDEX_NONE; });
+			else
+				CompactAfterDispatch(BucketIndex);
+		}
+		Count += NumCleared;
+	}
+
+	// Spatial hash entries are removed right away, since the dispatch iterates the copies of the queried records.
+	if (Bucket.SpatialObservers.IsValid())
+	{
+		const TConstArrayView<int32> SpatialRecords = Bucket.SpatialObservers->GetRecords();
+		for (int32 Entry = 0; Entry < SpatialRecords.Num(); Entry++)
+		{
+			const int32 RecordIndex = SpatialRecords[Entry];
+			if (RecordIndex == INDEX_NONE || !Predicate(ObserverRecords[RecordIndex])) continue;
+
+			Bucket.SpatialObservers->Remove(Entry);
+			ObserverRecords[RecordIndex].SpatialEntry = INDEX_NONE;
+			ReleaseRecord(RecordIndex);
+			Count++;
+		}
+	}
+
+	NumRecords -= Count;
+	Bucket.NumRecords -= Count;
+	ChannelIndex.FindChecked(Bucket.Key.Value).NumRecords -= Count;
+	if (Count > 0 && Bucket.NumRecords == 0 && ++NumStaleObservedKeys >= 64)
+		RebuildObservedFilter();
+	return Count;
+}
+
+void ULES_EventSystem::ReleaseRecord(const int32 RecordIndex)
+{
+	// The handler being called may belong to the removed record, so it's released after the dispatch.
+	ObserverRecords.Invalidate(RecordIndex);
+	if (ObserverRecords[RecordIndex].bConcurrent)
+		ConcurrentObservers.Remove(RecordIndex);
+	RetireAsyncObserver(ObserverRecords[RecordIndex]);
+	if (DispatchDepth > 0)
+		DeferredReleases.Add(RecordIndex);
+	else
+		ObserverRecords.Release(RecordIndex);
+}
+
+void ULES_EventSystem::CompactAfterDispatch(const int32 BucketIndex)
+{
+	FBucket& Bucket = Buckets[BucketIndex];
+	if (!Bucket.bHasRemovedRecords)
+	{
+		Bucket.bHasRemovedRecords = true;
+		BucketsToCompact.Add(BucketIndex);
+	}
+}
+
+int ULES_EventSystem::Clean()
+{
+	int Count = 0;
+	for (int32 BucketIndex = 0; BucketIndex < Buckets.Num(); BucketIndex++)
+	{
+		Count += RemoveRecords(BucketIndex, [](const LES::FObserverRecord& Record)
+		{
+			return !Record.Observer.IsValid();
+		});
+	}
+	return Count;
+}
+
+int ULES_EventSystem::RemoveByHandle(const FLES_ObserverHandle& ObserverHandle)
+{
+	if (!ContainsValidHandle(ObserverHandle)) return 0;
+
+	const int32 BucketIndex = FindBucket(ObserverHandle.ObserverKey.Key.Get(), ObserverHandle.ObserverKey.Value);
+	if (BucketIndex == INDEX_NONE) return 0;
+
+	const LES::FObserverRecord* ObserverRecord = &ObserverRecords[ObserverHandle.RecordIndex];
+	return RemoveRecords(BucketIndex, [ObserverRecord](const LES::FObserverRecord& Record)
+	{
+		return &Record == ObserverRecord;
+	});
+}
+
+int ULES_EventSystem::RemoveByObserver(const UObject* Observer)
+{
+	int Count = 0;
+	for (int32 BucketIndex = 0; BucketIndex < Buckets.Num(); BucketIndex++)
+	{
+		Count += RemoveRecords(BucketIndex, [Observer](const LES::FObserverRecord& Record)
+		{
+			return Record.Observer == Observer;
+		});
+	}
+	return Count;
+}
+
+void ULES_EventSystem::RemoveAll()
+{
+	for (int32 BucketIndex = 0; BucketIndex < Buckets.Num(); BucketIndex++)
 	{
-		if (Observer.IsValid() && Callback.IsValid())
+		RemoveRecords(BucketIndex, [](const LES::FObserverRecord&)
 		{
-			struct
-			{
-				ULES_Event* Event;
-			} FuncParams;
+			return true;
+		});
+	}
+}
 
-			FuncParams.Event = Event;
-			Observer->ProcessEvent(Callback.Get(), &FuncParams);
-		}
-	};
-	return AddObserver_Private(EventClass, Observer, CallbackLambda, Channel);
+int ULES_EventSystem::RemoveByChannel(const FName Channel)
+{
+	const FChannelEntry* Entry = ChannelIndex.Find(Channel);
+	if (!Entry) return 0;
+
+	// Buckets are never added nor purged by the removal, so the entry stays valid.
+	int Count = 0;
+	for (const int32 BucketIndex : Entry->Buckets)
+		Count += RemoveBucketRecords(BucketIndex);
+	return Count;
 }
 
-void ULES_EventSystem::SendEvent(ULES_Event* Event)
+int ULES_EventSystem::RemoveByEventClass(const TSubclassOf<ULES_Event>& EventClass)
 {
-	if (!IsValid(Event)) return;
-	if (!BeforeSend(Event)) return;
+	const TArray<int32, TInlineAllocator<4>>* ClassBuckets = EventClassIndex.Find(EventClass.Get());
+	if (!ClassBuckets) return 0;
+
+	int Count = 0;
+	for (const int32 BucketIndex : *ClassBuckets)
+		Count += RemoveBucketRecords(BucketIndex);
+	return Count;
+}
+
+int32 ULES_EventSystem::RemoveBucketRecords(const int32 BucketIndex)
+{
+	if (Buckets[BucketIndex].NumRecords == 0) return 0;
 
-	TArray<FRecord> Records;
-	ObserverRecords.MultiFind({TStrongObjectPtr(Event->GetClass()), Event->Channel}, Records);
-	for (const auto& Record : Records)
+	return RemoveRecords(BucketIndex, [](const LES::FObserverRecord&)
 	{
-		if (!Record->Observer.IsValid()) continue;
-		if (BeforeReceive(Event, Record->Observer.Get()))
-		{
-			Record->Callback(Event);
-			AfterReceive(Event, Record->Observer.Get());
-		}
-	}
-	AfterSend(Event);
+		return true;
+	});
 }
 
-int ULES_EventSystem::Clean()
+int ULES_EventSystem::Num() const
 {
-	int Count = 0;
-	for (auto It = ObserverRecords.CreateIterator(); It; ++It)
+	return NumRecords;
+}
+
+int ULES_EventSystem::GetChannels(TArray<FName>& OutChannels) const
+{
+	OutChannels.Empty(ChannelIndex.Num());
+	for (const TPair<FName, FChannelEntry>& Entry : ChannelIndex)
 	{
-		if (!It.Value()->Observer.IsValid())
-		{
-			It.RemoveCurrent();
-			Count++;
-		}
+		if (Entry.Value.NumRecords > 0)
+			OutChannels.Add(Entry.Key);
 	}
-	return Count;
+	return OutChannels.Num();
 }
 
-int ULES_EventSystem::RemoveByHandle(const FLES_ObserverHandle& ObserverHandle)
+int ULES_EventSystem::GetObserverCount(const TSubclassOf<ULES_Event>& EventClass, const FName Channel) const
 {
-	if (!IsHandleValid(ObserverHandle)) return 0;
+	const int32 BucketIndex = FindBucket(EventClass, Channel);
+	return BucketIndex != INDEX_NONE ? Buckets[BucketIndex].NumRecords : 0;
+}
 
-	const FKey Key{ObserverHandle.ObserverKey.Key.Get(), ObserverHandle.ObserverKey.Value};
-	return ObserverRecords.RemoveSingle(Key, ObserverHandle.ObserverRecord.Pin());
+int ULES_EventSystem::GetChannelObserverCount(const FName Channel) const
+{
+	const FChannelEntry* Entry = ChannelIndex.Find(Channel);
+	return Entry ? Entry->NumRecords : 0;
 }
 
-int ULES_EventSystem::RemoveByObserver(const UObject* Observer)
+int ULES_EventSystem::PurgeUnloadedEventClasses()
 {
+	// Buckets can't be purged while they're iterated. The next garbage collection will purge them.
+	if (DispatchDepth > 0) return 0;
+
 	int Count = 0;
-	for (auto It = ObserverRecords.CreateIterator(); It; ++It)
+	for (int32 BucketIndex = 0; BucketIndex < Buckets.Num(); BucketIndex++)
 	{
-		if (It.Value()->Observer == Observer)
+		FBucket& Bucket = Buckets[BucketIndex];
+		if (!Bucket.EventClass || Bucket.Key.Key.ResolveObjectPtr()) continue;
+
+		PurgeStats.NumPurgedBuckets++;
+		PurgeStats.ReclaimedBytes += GetAllocatedSize(Bucket);
+		int32 NumBucketRecords = 0;
+		ForEachRecord(Bucket, [this, &NumBucketRecords](const int32 RecordIndex)
 		{
-			It.RemoveCurrent();
-			Count++;
-		}
+			if (ObserverRecords[RecordIndex].bConcurrent)
+				ConcurrentObservers.Remove(RecordIndex);
+			RetireAsyncObserver(ObserverRecords[RecordIndex]);
+			ObserverRecords.Invalidate(RecordIndex);
+			ObserverRecords.Release(RecordIndex);
+			NumBucketRecords++;
+		});
+		PurgeStats.NumPurgedRecords += NumBucketRecords;
+		NumRecords -= NumBucketRecords;
+		NumStaleObservedKeys += NumBucketRecords > 0 ? 1 : 0;
+		Bucket.NumRecords = 0;
+
+		BucketIndices.Remove(Bucket.Key);
+		RemoveFromIndices(Bucket.Key, BucketIndex, NumBucketRecords);
+		Bucket.Key = {};
+		Bucket.EventClass = nullptr;
+		Bucket.RecordLists.Empty();
+		Bucket.SpatialObservers.Reset();
+		Bucket.ReservedRecords = 0;
+		Bucket.PeakNumRecords = 0;
+		Bucket.Serial++;
+		FreeBuckets.Add(BucketIndex);
+		Count++;
 	}
+
+	if (NumStaleObservedKeys > 0)
+		RebuildObservedFilter();
 	return Count;
 }
 
-void ULES_EventSystem::RemoveAll()
+void ULES_EventSystem::Reserve(const int32 NumObservers, const int32 NumBuckets)
 {
-	ObserverRecords.Empty();
+	ReservedRecords = FMath::Max(ReservedRecords, NumObservers);
+	ReservedBuckets = FMath::Max(ReservedBuckets, NumBuckets);
+	ObserverRecords.Reserve(ReservedRecords);
+	Buckets.Reserve(ReservedBuckets);
+	BucketIndices.Reserve(ReservedBuckets);
+
+	// Every bucket has at most one new channel and event class.
+	ChannelIndex.Reserve(ReservedBuckets);
+	EventClassIndex.Reserve(ReservedBuckets);
 }
 
-int ULES_EventSystem::Num() const
+void ULES_EventSystem::ReserveObservers(const TSubclassOf<ULES_Event>& EventClass, const FName Channel,
+                                        const int32 NumObservers)
 {
-	return ObserverRecords.Num();
+	if (!IsValid(EventClass)) return;
+
+	FBucket& Bucket = Buckets[FindOrAddBucket(EventClass, Channel)];
+	Bucket.ReservedRecords = FMath::Max(Bucket.ReservedRecords, NumObservers);
+	FindOrAddRecordList(Bucket, 0).Records.Reserve(Bucket.ReservedRecords);
 }
 
-int ULES_EventSystem::GetChannels(TArray<FName>& OutChannels) const
+FLES_UsageReport ULES_EventSystem::GetUsageReport() const
 {
-	TArray<FKey> Keys;
-	ObserverRecords.GetKeys(Keys);
+	FLES_UsageReport Report;
+	Report.ReservedRecords = ReservedRecords;
+	Report.PeakRecords = PeakNumRecords;
+	Report.ReservedBuckets = ReservedBuckets;
+	Report.PeakBuckets = PeakNumBuckets;
+	for (const FBucket& Bucket : Buckets)
+	{
+		if (Bucket.ReservedRecords == 0 || !Bucket.EventClass) continue;
 
-	OutChannels.Empty();
-	for (const auto& [EventClass, Channel] : Keys)
-		OutChannels.AddUnique(Channel);
-	return OutChannels.Num();
+		Report.Buckets.Add({
+			.EventClass = const_cast<UClass*>(Bucket.EventClass),
+			.Channel = Bucket.Key.Value,
+			.ReservedRecords = Bucket.ReservedRecords,
+			.PeakRecords = Bucket.PeakNumRecords,
+			.NumRecords = Bucket.NumRecords,
+		});
+	}
+	return Report;
+}
+
+void ULES_EventSystem::LogUsageReport() const
+{
+	const FLES_UsageReport Report = GetUsageReport();
+	UE_LOG(LogLightEventSystem, Log,
+	       TEXT("%s: peak of %d observer records with %d reserved, %d buckets with %d reserved."), *GetPathName(),
+	       Report.PeakRecords, Report.ReservedRecords, Report.PeakBuckets, Report.ReservedBuckets);
+	for (const FLES_BucketUsage& Usage : Report.Buckets)
+	{
+		UE_LOG(LogLightEventSystem, Log, TEXT("    %s on channel %s: peak of %d records with %d reserved, %d now"),
+		       *GetNameSafe(Usage.EventClass), *Usage.Channel.ToString(), Usage.PeakRecords, Usage.ReservedRecords,
+		       Usage.NumRecords);
+	}
+
+	// Exceeded reservations mean the tables grew after all, so the settings should be raised.
+	if (Report.ReservedRecords > 0 && Report.PeakRecords > Report.ReservedRecords)
+	{
+		UE_LOG(LogLightEventSystem, Warning, TEXT("%s: %d observer records reserved, but the peak was %d."),
+		       *GetPathName(), Report.ReservedRecords, Report.PeakRecords);
+	}
+	for (const FLES_BucketUsage& Usage : Report.Buckets)
+	{
+		if (Usage.PeakRecords > Usage.ReservedRecords)
+		{
+			UE_LOG(LogLightEventSystem, Warning,
+			       TEXT("%s: %d observers of %s on channel %s reserved, but the peak was %d."), *GetPathName(),
+			       Usage.ReservedRecords, *GetNameSafe(Usage.EventClass), *Usage.Channel.ToString(), Usage.PeakRecords);
+		}
+	}
+}
+
+FLES_MemoryReport ULES_EventSystem::GetMemoryReport() const
+{
+	FLES_MemoryReport Report = PurgeStats;
+	Report.NumBuckets = Buckets.Num() - FreeBuckets.Num();
+	Report.NumRecords = NumRecords;
+	Report.RecordCapacity = ObserverRecords.GetCapacity();
+	Report.RecordArenaBytes = ObserverRecords.GetAllocatedSize();
+	Report.AllocatedBytes = Buckets.GetAllocatedSize() + FreeBuckets.GetAllocatedSize() +
+		BucketIndices.GetAllocatedSize() + ChannelIndex.GetAllocatedSize() + EventClassIndex.GetAllocatedSize() +
+		Report.RecordArenaBytes;
+	for (const FBucket& Bucket : Buckets)
+	{
+		Report.AllocatedBytes += Bucket.RecordLists.GetAllocatedSize();
+		for (const FRecordList& RecordList : Bucket.RecordLists)
+		{
+			Report.AllocatedBytes += RecordList.Records.GetAllocatedSize();
+			for (const int32 RecordIndex : RecordList.Records)
+				Report.NumClearedSlots += RecordIndex == INDEX_NONE ? 1 : 0;
+		}
+		if (Bucket.SpatialObservers.IsValid())
+			Report.AllocatedBytes += sizeof(LES::FSpatialHash) + Bucket.SpatialObservers->GetAllocatedSize();
+		ForEachRecord(Bucket, [this, &Report](const int32 RecordIndex)
+		{
+			const SIZE_T CallbackSize = ObserverRecords[RecordIndex].Callback.GetAllocatedSize();
+			Report.NumHeapCallbacks += CallbackSize > 0 ? 1 : 0;
+			Report.AllocatedBytes += CallbackSize;
+		});
+	}
+	return Report;
 }
 
 bool ULES_EventSystem::ContainsObserver(const UObject* Observer) const
 {
-	for (const auto& [Key, Record] : ObserverRecords)
+	bool bContainsObserver = false;
+	for (const FBucket& Bucket : Buckets)
 	{
-		if (Record->Observer == Observer)
+		ForEachRecord(Bucket, [this, Observer, &bContainsObserver](const int32 RecordIndex)
+		{
+			bContainsObserver |= ObserverRecords[RecordIndex].Observer == Observer;
+		});
+		if (bContainsObserver)
 		{
 			return true;
 		}
@@ -136,24 +1018,23 @@ bool ULES_EventSystem::ContainsValidHandle(const FLES_ObserverHandle& ObserverHa
 {
 	if (!IsHandleValid(ObserverHandle)) return false;
 
-	const FKey Key{ObserverHandle.ObserverKey.Key.Get(), ObserverHandle.ObserverKey.Value};
-	return ObserverRecords.Contains(Key);
+	return ObserverHandle.EventSystem == this;
 }
 
 bool ULES_EventSystem::IsHandleValid(const FLES_ObserverHandle& ObserverHandle)
 {
-	return ObserverHandle.ObserverRecord.IsValid() && ObserverHandle.ObserverKey.Key.IsValid();
+	const ULES_EventSystem* EventSystem = ObserverHandle.EventSystem.Get();
+	return EventSystem &&
+		EventSystem->ObserverRecords.IsValid(ObserverHandle.RecordIndex, ObserverHandle.RecordSerial) &&
+		ObserverHandle.ObserverKey.Key.IsValid();
 }
 
 UObject* ULES_EventSystem::GetObserver(const FLES_ObserverHandle& ObserverHandle)
 {
-	if (ObserverHandle.ObserverRecord.IsValid())
-	{
-		const TSharedPtr<LES::FObserverRecord> ObserverRecord = ObserverHandle.ObserverRecord.Pin();
-		if (ObserverRecord->Observer.IsValid())
-			return ObserverRecord->Observer.Get();
-	}
-	return nullptr;
+	if (!IsHandleValid(ObserverHandle)) return nullptr;
+
+	const TWeakObjectPtr<> Observer = ObserverHandle.EventSystem->ObserverRecords[ObserverHandle.RecordIndex].Observer;
+	return Observer.IsValid() ? Observer.Get() : nullptr;
 }
 
 UClass* ULES_EventSystem::GetEventClass(const FLES_ObserverHandle& ObserverHandle)
@@ -208,16 +1089,494 @@ UFunction* ULES_EventSystem::FindCallbackFunction(const UObject* Object, const F
 	return nullptr;
 }
 
+FLES_ObserverHandle ULES_EventSystem::AddObserver_Function(const TSubclassOf<ULES_Event>& EventClass,
+                                                          UObject* Observer, UFunction* Callback, const FName Channel,
+                                                          const FName Group)
+{
+	auto CallbackLambda = [
+			Observer = TWeakObjectPtr<>(Observer),
+			Callback = TWeakObjectPtr<UFunction>(Callback)
+		](ULES_Event* Event)
+	{
+		if (Observer.IsValid() && Callback.IsValid())
+		{
+			struct
+			{
+				ULES_Event* Event;
+			} FuncParams;
+
+			FuncParams.Event = Event;
+			Observer->ProcessEvent(Callback.Get(), &FuncParams);
+		}
+	};
+	const FLES_ObserverHandle Handle = AddObserver_Private(EventClass, Observer, MoveTemp(CallbackLambda), Channel, {},
+	                                                       Group);
+	ObserverRecords[Handle.RecordIndex].CallbackName = Callback->GetFName();
+	return Handle;
+}
+
 FLES_ObserverHandle ULES_EventSystem::AddObserver_Private(const TSubclassOf<ULES_Event>& EventClass, UObject* Observer,
-                                                          TFunction<void(ULES_Event*)>&& Callback, const FName Channel)
+                                                          LES::FObserverCallback&& Callback, const FName Channel,
+                                                          const FLES_StreamOperators& Operators, const FName Group)
 {
-	const LES::FObserverRecord NewRecord{
-		.Channel = Channel,
-		.Observer = Observer,
-		.Callback = Callback,
+	const int32 RecordIndex = ObserverRecords.Allocate();
+	LES::FObserverRecord& Record = ObserverRecords[RecordIndex];
+	Record.Observer = Observer;
+	Record.Callback = MoveTemp(Callback);
+	Record.Group = FindOrAddGroup(Group);
+	Record.CallSite = PLATFORM_RETURN_ADDRESS();
+	if (!Operators.IsEmpty())
+	{
+		Record.Operators = MakeUnique<LES::FStreamOperatorState>(Operators, EventClass.Get());
+		OperatorRecords.Emplace(RecordIndex, Record.Serial);
+	}
+
+	FBucket& Bucket = Buckets[FindOrAddBucket(EventClass, Channel)];
+	FindOrAddRecordList(Bucket, Record.Group).Records.Add(RecordIndex);
+	Bucket.NumRecords++;
+	ChannelIndex.FindChecked(Channel).NumRecords++;
+	Bucket.PeakNumRecords = FMath::Max(Bucket.PeakNumRecords, Bucket.NumRecords);
+	NumRecords++;
+	PeakNumRecords = FMath::Max(PeakNumRecords, NumRecords);
+
+	const auto [FirstBit, SecondBit] = GetObservedFilterBits(EventClass, Channel);
+	ObservedFilter[FirstBit] = true;
+	ObservedFilter[SecondBit] = true;
+	return {
+		.ObserverKey = {EventClass, Channel},
+		.EventSystem = this,
+		.RecordIndex = RecordIndex,
+		.RecordSerial = Record.Serial,
 	};
-	const TSharedPtr<LES::FObserverRecord> ObserverRecord = MakeShared<LES::FObserverRecord>(NewRecord);
+}
+
+FLES_ObserverHandle ULES_EventSystem::AddAsyncObserver_Private(const TSubclassOf<ULES_Event>& EventClass,
+                                                               UObject* Observer, LES::FObserverCallback&& Work,
+                                                               LES::FObserverCallback&& Completion, const FName Channel,
+                                                               const int32 MaxTasksInFlight, const FName Group)
+{
+	const FLES_ObserverHandle Handle = AddObserver_Private(EventClass, Observer, {}, Channel, {}, Group);
+	LES::FObserverRecord& Record = ObserverRecords[Handle.RecordIndex];
+	Record.AsyncObserver = MakeUnique<LES::FAsyncObserver>(MoveTemp(Work), MoveTemp(Completion), MaxTasksInFlight);
+	Record.CallSite = PLATFORM_RETURN_ADDRESS();
+	AsyncRecords.Emplace(Handle.RecordIndex, Handle.RecordSerial);
+	return Handle;
+}
+
+FLES_ObserverHandle ULES_EventSystem::AddBatchObserver_Private(const TSubclassOf<ULES_Event>& EventClass,
+                                                               UObject* Observer, LES::FBatchCallback&& Callback,
+                                                               const FName Channel, const int32 MaxBatchSize,
+                                                               const FName Group)
+{
+	const FLES_ObserverHandle Handle = AddObserver_Private(EventClass, Observer, {}, Channel, {}, Group);
+	LES::FObserverRecord& Record = ObserverRecords[Handle.RecordIndex];
+	Record.Mailbox = MakeUnique<LES::FEventMailbox>(MoveTemp(Callback), MaxBatchSize);
+	Record.CallSite = PLATFORM_RETURN_ADDRESS();
+	MailboxRecords.Emplace(Handle.RecordIndex, Handle.RecordSerial);
+	return Handle;
+}
+
+FLES_ObserverHandle ULES_EventSystem::AddConcurrentObserver_Private(const TSubclassOf<ULES_Event>& EventClass,
+                                                                    UObject* Observer,
+                                                                    LES::FObserverCallback&& Callback,
+                                                                    LES::FObserverCallback&& ConcurrentCallback,
+                                                                    const FName Channel)
+{
+	const FLES_ObserverHandle Handle = AddObserver_Private(EventClass, Observer, MoveTemp(Callback), Channel);
+	LES::FObserverRecord& Record = ObserverRecords[Handle.RecordIndex];
+	Record.CallSite = PLATFORM_RETURN_ADDRESS();
+	Record.bConcurrent = true;
+	ConcurrentObservers.Add(Handle.RecordIndex, EventClass, Channel, MoveTemp(ConcurrentCallback));
+	return Handle;
+}
+
+LES::FInstanceList& ULES_EventSystem::FindOrAddClassInstances(UClass* ObserverClass)
+{
+	if (!ClassInstances.IsValid())
+		ClassInstances = MakeUnique<LES::FClassInstances>();
+	return ClassInstances->FindOrAdd(ObserverClass);
+}
+
+TPair<int32, int32> ULES_EventSystem::GetObservedFilterBits(const UClass* EventClass, const FName Channel)
+{
+	const uint32 Hash = MurmurFinalize32(HashCombineFast(PointerHash(EventClass), GetTypeHash(Channel)));
+	return {Hash & (ObservedFilterSize - 1), (Hash >> 16) & (ObservedFilterSize - 1)};
+}
+
+void ULES_EventSystem::RebuildObservedFilter()
+{
+	ObservedFilter = TStaticBitArray<ObservedFilterSize>();
+	for (const FBucket& Bucket : Buckets)
+	{
+		if (Bucket.NumRecords == 0) continue;
+
+		const auto [FirstBit, SecondBit] = GetObservedFilterBits(Bucket.EventClass, Bucket.Key.Value);
+		ObservedFilter[FirstBit] = true;
+		ObservedFilter[SecondBit] = true;
+	}
+	NumStaleObservedKeys = 0;
+}
+
+int32 ULES_EventSystem::FindObservedBucketForLazySend(const UClass* EventClass, const FName Channel)
+{
+	const int32 BucketIndex = FindObservedBucket(EventClass, Channel);
+	if (BucketIndex == INDEX_NONE)
+		TrackUnobservedSend(EventClass, Channel, nullptr, PLATFORM_RETURN_ADDRESS());
+	return BucketIndex;
+}
+
+void ULES_EventSystem::SendEventToBucket(const int32 BucketIndex, ULES_Event* Event)
+{
+	if (!BeforeSend(Event)) return;
+
+	// The factory may have removed the observers in the meantime, which leaves the bucket empty, but valid.
+	DispatchEvent(BucketIndex, Event);
+	AfterSend(Event);
+}
+
+void ULES_EventSystem::TrackUnobservedSend(const UClass* EventClass, const FName Channel, const UObject* Sender,
+                                           const void* CallSite)
+{
+#if LES_WITH_SEND_REPORT
+	FUnobservedSendStats& Stats = UnobservedSends.FindOrAdd({EventClass, Channel, reinterpret_cast<UPTRINT>(CallSite)});
+	Stats.NumSends++;
+	if (Sender && Stats.SenderClass.IsNone())
+		Stats.SenderClass = Sender->GetClass()->GetFName();
+#endif
+}
+
+int32 ULES_EventSystem::FindOrAddGroup(const FName Group)
+{
+	if (Group.IsNone()) return 0;
+
+	if (const int32* GroupIndex = GroupIndices.Find(Group))
+		return *GroupIndex;
+
+	const int32 GroupIndex = Groups.Add({.Name = Group});
+	GroupIndices.Add(Group, GroupIndex);
+	return GroupIndex;
+}
+
+ULES_EventSystem::FRecordList& ULES_EventSystem::FindOrAddRecordList(FBucket& Bucket, const int32 Group)
+{
+	for (FRecordList& RecordList : Bucket.RecordLists)
+	{
+		if (RecordList.Group == Group)
+			return RecordList;
+	}
+	return Bucket.RecordLists.Add_GetRef({.Group = Group});
+}
+
+int32 ULES_EventSystem::FindBucket(const UClass* EventClass, const FName Channel) const
+{
+	const int32* BucketIndex = BucketIndices.Find(FKey{EventClass, Channel});
+	return BucketIndex ? *BucketIndex : INDEX_NONE;
+}
+
+int32 ULES_EventSystem::FindObservedBucket(const UClass* EventClass, const FName Channel) const
+{
+	const auto [FirstBit, SecondBit] = GetObservedFilterBits(EventClass, Channel);
+	if (!ObservedFilter[FirstBit] || !ObservedFilter[SecondBit]) return INDEX_NONE;
+
+	const int32 BucketIndex = FindBucket(EventClass, Channel);
+	return BucketIndex != INDEX_NONE && Buckets[BucketIndex].NumRecords > 0 ? BucketIndex : INDEX_NONE;
+}
+
+int32 ULES_EventSystem::FindOrAddBucket(const UClass* EventClass, const FName Channel)
+{
+	const FKey Key{EventClass, Channel};
+	if (const int32* BucketIndex = BucketIndices.Find(Key))
+		return *BucketIndex;
+
+	const int32 BucketIndex = FreeBuckets.Num() > 0 ? FreeBuckets.Pop(EAllowShrinking::No) : Buckets.AddDefaulted();
+	Buckets[BucketIndex].Key = Key;
+	Buckets[BucketIndex].EventClass = EventClass;
+	BucketIndices.Add(Key, BucketIndex);
+	ChannelIndex.FindOrAdd(Channel).Buckets.Add(BucketIndex);
+	EventClassIndex.FindOrAdd(Key.Key).Add(BucketIndex);
+	PeakNumBuckets = FMath::Max(PeakNumBuckets, Buckets.Num() - FreeBuckets.Num());
+	return BucketIndex;
+}
+
+void ULES_EventSystem::RemoveFromIndices(const FKey& Key, const int32 BucketIndex, const int32 NumBucketRecords)
+{
+	FChannelEntry& Entry = ChannelIndex.FindChecked(Key.Value);
+	Entry.NumRecords -= NumBucketRecords;
+	Entry.Buckets.RemoveSingleSwap(BucketIndex, EAllowShrinking::No);
+	if (Entry.Buckets.IsEmpty())
+		ChannelIndex.Remove(Key.Value);
+
+	TArray<int32, TInlineAllocator<4>>& ClassBuckets = EventClassIndex.FindChecked(Key.Key);
+	ClassBuckets.RemoveSingleSwap(BucketIndex, EAllowShrinking::No);
+	if (ClassBuckets.IsEmpty())
+		EventClassIndex.Remove(Key.Key);
+}
+
+SIZE_T ULES_EventSystem::GetAllocatedSize(const FBucket& Bucket) const
+{
+	SIZE_T Size = sizeof(FBucket) + Bucket.RecordLists.GetAllocatedSize();
+	for (const FRecordList& RecordList : Bucket.RecordLists)
+		Size += RecordList.Records.GetAllocatedSize();
+	if (Bucket.SpatialObservers.IsValid())
+		Size += sizeof(LES::FSpatialHash) + Bucket.SpatialObservers->GetAllocatedSize();
+	ForEachRecord(Bucket, [this, &Size](const int32 RecordIndex)
+	{
+		Size += sizeof(LES::FObserverRecord) + ObserverRecords[RecordIndex].Callback.GetAllocatedSize();
+	});
+	return Size;
+}
+
+void ULES_EventSystem::DispatchEvent(const int32 BucketIndex, ULES_Event* Event, const bool* StopFlag)
+{
+	// The bucket is iterated in place. Handlers may add observers, which are appended to the bucket and don't receive
+	// the event being dispatched, and remove observers, which only clears their slots until the dispatch finishes. The
+	// bucket may be reallocated in the meantime, so it's looked up again for every record.
+	const int32 FirstList = NumRecordsToNotify.Num();
+	for (const FRecordList& RecordList : Buckets[BucketIndex].RecordLists)
+		NumRecordsToNotify.Add(RecordList.Records.Num());
+	const int32 NumLists = NumRecordsToNotify.Num() - FirstList;
+
+	// Spatial observers are queried up front, so that the observers moved to the spatial hash by the handlers don't
+	// receive the event twice. Spatial filters can only be set for the classes of spatial events.
+	const int32 FirstSpatialCandidate = SpatialCandidates.Num();
+	if (Buckets[BucketIndex].SpatialObservers.IsValid())
+	{
+		const ULES_SpatialEvent* SpatialEvent = CastChecked<ULES_SpatialEvent>(Event);
+		Buckets[BucketIndex].SpatialObservers->Query(SpatialEvent->Location, SpatialEvent->Radius, SpatialCandidates);
+	}
+	const int32 LastSpatialCandidate = SpatialCandidates.Num();
+	const float Budget = GetHandlerBudget(Event->Channel);
+
+	// The stop flag is checked before each observer, so the cleanup below still runs after a query is decided.
+	auto IsStopped = [StopFlag] { return StopFlag && *StopFlag; };
+
+	DispatchDepth++;
+	for (int32 ListIndex = 0; ListIndex < NumLists && !IsStopped(); ListIndex++)
+	{
+		// Lists of the suspended groups are skipped as a whole.
+		if (Groups[Buckets[BucketIndex].RecordLists[ListIndex].Group].bSuspended) continue;
+
+		for (int32 RecordIndex = 0; RecordIndex < NumRecordsToNotify[FirstList + ListIndex] && !IsStopped();
+		     RecordIndex++)
+		{
+			const int32 ObserverRecordIndex = Buckets[BucketIndex].RecordLists[ListIndex].Records[RecordIndex];
+			if (ObserverRecordIndex == INDEX_NONE) continue;
+
+			const LES::FObserverRecord& Record = ObserverRecords[ObserverRecordIndex];
+			if (!Record.Observer.IsValid()) continue;
+			if (Record.Operators.IsValid() && !Record.Operators->Receive(Event, CurrentTime)) continue;
+			NotifyObserver(ObserverRecordIndex, Event, Budget);
+		}
+	}
+
+	for (int32 Candidate = FirstSpatialCandidate; Candidate < LastSpatialCandidate && !IsStopped(); Candidate++)
+	{
+		// Removed records are released only after the dispatch, so their slots can't be reused in the meantime.
+		const LES::FObserverRecord& Record = ObserverRecords[SpatialCandidates[Candidate]];
+		if (Record.SpatialEntry == INDEX_NONE || Groups[Record.Group].bSuspended) continue;
+		if (!Record.Observer.IsValid()) continue;
+		if (Record.Operators.IsValid() && !Record.Operators->Receive(Event, CurrentTime)) continue;
+		NotifyObserver(SpatialCandidates[Candidate], Event, Budget);
+	}
+	SpatialCandidates.SetNum(FirstSpatialCandidate, EAllowShrinking::No);
+	NumRecordsToNotify.SetNum(FirstList, EAllowShrinking::No);
+
+	if (--DispatchDepth == 0 && HasDeferredRemovals())
+		ApplyDeferredRemovals();
+}
+
+void ULES_EventSystem::ApplyDeferredRemovals()
+{
+	for (const int32 BucketIndex : BucketsToCompact)
+	{
+		FBucket& Bucket = Buckets[BucketIndex];
+		for (FRecordList& RecordList : Bucket.RecordLists)
+			RecordList.Records.RemoveAll([](const int32 RecordIndex) { return RecordIndex == INDEX_NONE; });
+		Bucket.bHasRemovedRecords = false;
+	}
+	BucketsToCompact.Reset();
+
+	for (const int32 RecordIndex : DeferredReleases)
+		ObserverRecords.Release(RecordIndex);
+	DeferredReleases.Reset();
+}
+
+float ULES_EventSystem::GetHandlerBudget(const FName Channel) const
+{
+	const float* Budget = ChannelHandlerBudgets.IsEmpty() ? nullptr : ChannelHandlerBudgets.Find(Channel);
+	return Budget ? *Budget : DefaultHandlerBudget;
+}
+
+void ULES_EventSystem::NotifyObserver(const int32 RecordIndex, ULES_Event* Event, const float Budget)
+{
+	const LES::FObserverRecord& Record = ObserverRecords[RecordIndex];
+	if (Record.bDeferred)
+	{
+		DeferredDeliveries.Add({.RecordIndex = RecordIndex, .RecordSerial = Record.Serial, .Event = Event});
+		return;
+	}
+	InvokeObserver(RecordIndex, Event, Budget);
+}
+
+void ULES_EventSystem::InvokeObserver(const int32 RecordIndex, ULES_Event* Event, const float Budget)
+{
+	const LES::FObserverRecord& Record = ObserverRecords[RecordIndex];
+	if (!BeforeReceive(Event, Record.Observer.Get())) return;
+
+	// Batch handlers are timed and followed by the AfterReceive hook when their mailbox is flushed.
+	if (Record.Mailbox.IsValid())
+	{
+		if (Record.Mailbox->Add(Event))
+			FlushMailbox(RecordIndex);
+		return;
+	}
+
+	// Async handlers aren't timed, since they don't block the sender, and AfterReceive follows their completion.
+	if (Record.AsyncObserver.IsValid())
+	{
+		Record.AsyncObserver->Add(Event);
+		return;
+	}
+
+	if (Budget > 0.0f)
+	{
+		// The serial is read up front, since the handler may remove its own record.
+		const uint32 RecordSerial = Record.Serial;
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+		Record.Callback(Event);
+		const double CallTime = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles);
+
+		WatchdogStats.NumTimedCalls++;
+		WatchdogStats.SlowestCallTime = FMath::Max(WatchdogStats.SlowestCallTime, CallTime);
+		if (CallTime > Budget)
+			ReportSlowHandler(RecordIndex, RecordSerial, Event, CallTime, Budget);
+	}
+	else
+	{
+		Record.Callback(Event);
+	}
+	AfterReceive(Event, Record.Observer.Get());
+}
+
+void ULES_EventSystem::ReportSlowHandler(const int32 RecordIndex, const uint32 RecordSerial, const ULES_Event* Event,
+                                         const double CallTime, const float Budget)
+{
+	LES::FObserverRecord& Record = ObserverRecords[RecordIndex];
+	WatchdogStats.NumOverBudgetCalls++;
+
+	const uint64 CallSite = reinterpret_cast<UPTRINT>(Record.CallSite);
+	FSlowHandlerStats& Stats = SlowHandlers.FindOrAdd({
+		CallSite, Record.CallbackName, Event->GetClass(), Event->Channel
+	});
+	Stats.NumOverBudgetCalls++;
+	Stats.SlowestCallTime = FMath::Max(Stats.SlowestCallTime, CallTime);
+
+	// Symbolication is slow, so the call site is logged as a raw address and symbolicated by LogWatchdogStats. Each
+	// handler is logged only the first time it goes over the budget.
+	if (Stats.ObserverName.IsEmpty())
+	{
+		Stats.ObserverName = GetNameSafe(Record.Observer.Get());
+		UE_LOG(LogLightEventSystem, Warning,
+		       TEXT("%s took %.3f ms to receive %s on channel %s, over the budget of %.3f ms."),
+		       *DescribeHandler(CallSite, Record.CallbackName, Stats.ObserverName, false), CallTime,
+		       *GetNameSafe(Event->GetClass()), *Event->Channel.ToString(), Budget);
+	}
+
+	if (bDeferSlowHandlers && !Record.bDeferred && ObserverRecords.IsValid(RecordIndex, RecordSerial))
+	{
+		Record.bDeferred = true;
+		WatchdogStats.NumDemotedRecords++;
+		UE_LOG(LogLightEventSystem, Log, TEXT("%s now receives its events when the Event System is ticked."),
+		       *DescribeHandler(CallSite, Record.CallbackName, Stats.ObserverName, false));
+	}
+}
+
+void ULES_EventSystem::DeliverDeferredEvents()
+{
+	// Deliveries are moved out of the queue first, so that the events sent to the deferred records in the meantime
+	// wait for the next tick.
+	check(DueDeliveries.IsEmpty());
+	Swap(DueDeliveries, DeferredDeliveries);
+
+	DispatchDepth++;
+	for (const FDeferredDelivery& Delivery : DueDeliveries)
+	{
+		if (!ObserverRecords.IsValid(Delivery.RecordIndex, Delivery.RecordSerial) || !IsValid(Delivery.Event)) continue;
+
+		const LES::FObserverRecord& Record = ObserverRecords[Delivery.RecordIndex];
+		if (!Record.Observer.IsValid() || Groups[Record.Group].bSuspended) continue;
+
+		WatchdogStats.NumDeferredDeliveries++;
+		InvokeObserver(Delivery.RecordIndex, Delivery.Event, GetHandlerBudget(Delivery.Event->Channel));
+	}
+	DueDeliveries.Reset();
+
+	if (--DispatchDepth == 0 && HasDeferredRemovals())
+		ApplyDeferredRemovals();
+}
+
+void ULES_EventSystem::FlushMailbox(const int32 RecordIndex)
+{
+	// Removing the record is deferred while the handler runs, so the record and its mailbox stay put even if the
+	// handler removes its own observer.
+	const LES::FObserverRecord& Record = ObserverRecords[RecordIndex];
+	LES::FEventMailbox& Mailbox = *Record.Mailbox;
+	if (!Mailbox.CanFlush()) return;
+
+	const TArrayView<ULES_Event* const> Batch = Mailbox.BeginFlush();
+	if (Batch.IsEmpty())
+	{
+		Mailbox.EndFlush();
+		return;
+	}
+
+	DispatchDepth++;
+	const float Budget = GetHandlerBudget(Batch[0]->Channel);
+	if (Budget > 0.0f)
+	{
+		const uint32 RecordSerial = Record.Serial;
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+		Mailbox.Invoke(Batch);
+		const double CallTime = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles);
+
+		WatchdogStats.NumTimedCalls++;
+		WatchdogStats.SlowestCallTime = FMath::Max(WatchdogStats.SlowestCallTime, CallTime);
+		if (CallTime > Budget)
+			ReportSlowHandler(RecordIndex, RecordSerial, Batch[0], CallTime, Budget);
+	}
+	else
+	{
+		Mailbox.Invoke(Batch);
+	}
+	for (ULES_Event* Event : Batch)
+		AfterReceive(Event, Record.Observer.Get());
+	Mailbox.EndFlush();
+
+	if (--DispatchDepth == 0 && HasDeferredRemovals())
+		ApplyDeferredRemovals();
+}
+
+void ULES_EventSystem::FlushAsyncObserver(const int32 RecordIndex)
+{
+	// The completion handler may remove its own record, which retires the async observer without destroying it.
+	const LES::FObserverRecord& Record = ObserverRecords[RecordIndex];
+	if (!Record.AsyncObserver.IsValid()) return;
+
+	DispatchDepth++;
+	Record.AsyncObserver->Flush([this, &Record](ULES_Event* Event)
+	{
+		AfterReceive(Event, Record.Observer.Get());
+	});
+	if (--DispatchDepth == 0 && HasDeferredRemovals())
+		ApplyDeferredRemovals();
+}
+
+void ULES_EventSystem::RetireAsyncObserver(LES::FObserverRecord& Record)
+{
+	if (!Record.AsyncObserver.IsValid()) return;
 
-	ObserverRecords.Add(FKey{EventClass, Channel}, ObserverRecord);
-	return {{EventClass, Channel}, ObserverRecord};
+	// Removing the record doesn't wait for its running tasks. They're collected on the ticks instead.
+	Record.AsyncObserver->Retire();
+	if (!Record.AsyncObserver->IsIdle())
+		RetiredAsyncObservers.Add(MoveTemp(Record.AsyncObserver));
 }
@@ -0,0 +1,27 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+
+#include "EventSystemSettings.h"
+
+#include "EventSystem.h"
+
+void ULES_EventSystemSettings::ApplyTo(ULES_EventSystem* EventSystem) const
+{
+	if (!IsValid(EventSystem)) return;
+
+	int32 NumObservers = 0;
+	for (const FLES_ExpectedObservers& Expected : ExpectedObservers)
+		NumObservers += Expected.NumObservers;
+	EventSystem->Reserve(FMath::Max(ExpectedNumObservers, NumObservers),
+	                     FMath::Max(ExpectedNumBuckets, ExpectedObservers.Num()));
+
+	for (const FLES_ExpectedObservers& Expected : ExpectedObservers)
+	{
+		UClass* EventClass = bWarmUpEventClasses ? Expected.EventClass.LoadSynchronous() : Expected.EventClass.Get();
+		if (!EventClass) continue;
+
+		EventSystem->ReserveObservers(EventClass, Expected.Channel, Expected.NumObservers);
+		if (bWarmUpEventClasses)
+			NewObject<ULES_Event>(GetTransientPackage(), EventClass);
+	}
+}
@@ -2,11 +2,16 @@
 
 #include "LightEventSystemModule.h"
 
+#include "NativeChannel.h"
+
 #define LOCTEXT_NAMESPACE "FLightEventSystemModule"
 
+DEFINE_LOG_CATEGORY(LogLightEventSystem);
+
 void FLightEventSystemModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
+	LES::FNativeChannel::ResolveRegisteredChannels();
 }
 
 void FLightEventSystemModule::ShutdownModule()
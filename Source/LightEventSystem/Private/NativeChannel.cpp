@@ -0,0 +1,61 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+
+#include "NativeChannel.h"
+
+namespace LES
+{
+	bool FNativeChannel::bModuleStarted = false;
+
+	FNativeChannel::FNativeChannel(const TCHAR* InChannelName)
+		: ChannelName(InChannelName)
+	{
+		FNativeChannel*& Head = GetHead();
+		Next = Head;
+		Head = this;
+
+		if (bModuleStarted)
+			Resolve();
+	}
+
+	FNativeChannel::~FNativeChannel()
+	{
+		// Channels defined in modules that are being unloaded must be unlinked from the list.
+		for (FNativeChannel** Link = &GetHead(); *Link; Link = &(*Link)->Next)
+		{
+			if (*Link == this)
+			{
+				*Link = Next;
+				break;
+			}
+		}
+	}
+
+	void FNativeChannel::ResolveRegisteredChannels()
+	{
+		bModuleStarted = true;
+		for (const FNativeChannel* Channel = GetHead(); Channel; Channel = Channel->Next)
+		{
+			if (!Channel->bResolved)
+				Channel->Resolve();
+		}
+	}
+
+	void FNativeChannel::GetRegisteredChannels(TArray<FName>& OutChannels)
+	{
+		for (const FNativeChannel* Channel = GetHead(); Channel; Channel = Channel->Next)
+			OutChannels.Add(Channel->GetName());
+	}
+
+	void FNativeChannel::Resolve() const
+	{
+		Name = FName(ChannelName);
+		bResolved = true;
+	}
+
+	FNativeChannel*& FNativeChannel::GetHead()
+	{
+		static FNativeChannel* Head = nullptr;
+		return Head;
+	}
+}
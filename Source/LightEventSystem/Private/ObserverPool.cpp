@@ -0,0 +1,59 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+
+#include "ObserverPool.h"
+
+namespace LES
+{
+	int32 FObserverPool::Allocate()
+	{
+		if (FreeSlots.Num() > 0)
+			return FreeSlots.Pop(EAllowShrinking::No);
+
+		if (NumSlots == Chunks.Num() * RecordsPerChunk)
+			Chunks.Add(MakeUnique<FObserverRecord[]>(RecordsPerChunk));
+		return NumSlots++;
+	}
+
+	void FObserverPool::Reserve(const int32 NumRecords)
+	{
+		const int32 NumChunks = FMath::DivideAndRoundUp(NumRecords, RecordsPerChunk);
+		Chunks.Reserve(NumChunks);
+		while (Chunks.Num() < NumChunks)
+			Chunks.Add(MakeUnique<FObserverRecord[]>(RecordsPerChunk));
+		FreeSlots.Reserve(NumRecords);
+	}
+
+	void FObserverPool::Invalidate(const int32 Index)
+	{
+		(*this)[Index].Serial++;
+	}
+
+	void FObserverPool::Release(const int32 Index)
+	{
+		FObserverRecord& Record = (*this)[Index];
+		Record.Observer = nullptr;
+		Record.Callback.Reset();
+		Record.Operators.Reset();
+		Record.Mailbox.Reset();
+		Record.AsyncObserver.Reset();
+		Record.SpatialEntry = INDEX_NONE;
+		Record.Group = 0;
+		Record.CallSite = nullptr;
+		Record.CallbackName = NAME_None;
+		Record.bDeferred = false;
+		Record.bConcurrent = false;
+		FreeSlots.Add(Index);
+	}
+
+	bool FObserverPool::IsValid(const int32 Index, const uint32 Serial) const
+	{
+		return Index >= 0 && Index < NumSlots && (*this)[Index].Serial == Serial;
+	}
+
+	SIZE_T FObserverPool::GetAllocatedSize() const
+	{
+		return Chunks.GetAllocatedSize() + FreeSlots.GetAllocatedSize() +
+			Chunks.Num() * RecordsPerChunk * sizeof(FObserverRecord);
+	}
+}
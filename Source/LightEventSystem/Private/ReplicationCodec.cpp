@@ -0,0 +1,277 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+
+#include "ReplicationCodec.h"
+
+#include "BasicEvents.h"
+#include "Serialization/ObjectAndNameAsStringProxyArchive.h"
+#include "Serialization/StructuredArchive.h"
+#include "UObject/UnrealType.h"
+
+namespace LES
+{
+	int32 FReplicationTable::AddEventClass(UClass* EventClass)
+	{
+		if (!EventClass) return INDEX_NONE;
+		if (const int32* Index = EventClassIndices.Find(EventClass))
+			return *Index;
+		const int32 Index = EventClasses.Add(EventClass);
+		EventClassIndices.Add(EventClass, Index);
+		return Index;
+	}
+
+	int32 FReplicationTable::AddChannel(const FName Channel)
+	{
+		if (const int32* Index = ChannelIndices.Find(Channel))
+			return *Index;
+		const int32 Index = Channels.Add(Channel);
+		ChannelIndices.Add(Channel, Index);
+		return Index;
+	}
+
+	int32 FReplicationTable::FindEventClass(const UClass* EventClass) const
+	{
+		const int32* Index = EventClassIndices.Find(EventClass);
+		return Index ? *Index : INDEX_NONE;
+	}
+
+	int32 FReplicationTable::FindChannel(const FName Channel) const
+	{
+		const int32* Index = ChannelIndices.Find(Channel);
+		return Index ? *Index : INDEX_NONE;
+	}
+
+	UClass* FReplicationTable::GetEventClass(const int32 Index) const
+	{
+		return EventClasses.IsValidIndex(Index) ? EventClasses[Index].Get() : nullptr;
+	}
+
+	// All the helpers below are symmetric: they write the value when the archive is saving, and read it otherwise.
+	namespace
+	{
+		void SerializeBit(FArchive& Ar, bool& bValue)
+		{
+			uint8 Bit = bValue ? 1 : 0;
+			Ar.SerializeBits(&Bit, 1);
+			bValue = Bit != 0;
+		}
+
+		/** Writes the value in groups of 7 bits, each followed by a bit telling whether more groups follow. */
+		void SerializeVarInt(FArchive& Ar, uint64& Value)
+		{
+			if (Ar.IsSaving())
+			{
+				uint64 Remaining = Value;
+				do
+				{
+					uint8 Group = Remaining & 0x7F;
+					Remaining >>= 7;
+					uint8 bMore = Remaining != 0 ? 1 : 0;
+					Ar.SerializeBits(&Group, 7);
+					Ar.SerializeBits(&bMore, 1);
+				}
+				while (Remaining);
+				return;
+			}
+
+			Value = 0;
+			for (int32 Shift = 0; Shift < 64 && !Ar.IsError(); Shift += 7)
+			{
+				uint8 Group = 0;
+				uint8 bMore = 0;
+				Ar.SerializeBits(&Group, 7);
+				Ar.SerializeBits(&bMore, 1);
+				Value |= static_cast<uint64>(Group) << Shift;
+				if (!bMore) break;
+			}
+		}
+
+		/** Writes the difference from the \a Last value, zigzag encoded so small negative differences stay small. */
+		void SerializeDelta(FArchive& Ar, int64& Value, int64& Last)
+		{
+			uint64 ZigZag = 0;
+			if (Ar.IsSaving())
+			{
+				const int64 Delta = Value - Last;
+				ZigZag = static_cast<uint64>(Delta) << 1 ^ static_cast<uint64>(Delta >> 63);
+			}
+			SerializeVarInt(Ar, ZigZag);
+			if (Ar.IsLoading())
+				Value = Last + (static_cast<int64>(ZigZag >> 1) ^ -static_cast<int64>(ZigZag & 1));
+			Last = Value;
+		}
+
+		/** Writes a single bit if the value is the same as the \a Last value, or the full value otherwise. */
+		template <typename T>
+		void SerializeIfChanged(FArchive& Ar, T& Value, T& Last)
+		{
+			bool bChanged = Ar.IsSaving() && !(Value == Last);
+			SerializeBit(Ar, bChanged);
+			if (bChanged)
+			{
+				Ar << Value;
+				Last = Value;
+			}
+			else
+				Value = Last;
+		}
+
+		void SerializeQuantizedVector(FArchive& Ar, FVector& Value, int64 (&Last)[3])
+		{
+			for (int32 Axis = 0; Axis < 3; Axis++)
+			{
+				int64 Quantized = Ar.IsSaving()
+					                  ? FMath::RoundToInt64(Value[Axis] * FEventPacketCodec::VectorPrecision)
+					                  : 0;
+				SerializeDelta(Ar, Quantized, Last[Axis]);
+				Value[Axis] = Quantized / FEventPacketCodec::VectorPrecision;
+			}
+		}
+
+		void SerializeQuantizedRotator(FArchive& Ar, FRotator& Value, uint16 (&Last)[3])
+		{
+			double* Axes[] = {&Value.Pitch, &Value.Yaw, &Value.Roll};
+			for (int32 Axis = 0; Axis < 3; Axis++)
+			{
+				uint16 Quantized = Ar.IsSaving() ? FRotator::CompressAxisToShort(*Axes[Axis]) : 0;
+				SerializeIfChanged(Ar, Quantized, Last[Axis]);
+				*Axes[Axis] = FRotator::DecompressAxisFromShort(Quantized);
+			}
+		}
+
+		/** Serializes the value of the \a Event if it's exactly of the \a TEvent class. Returns false otherwise. */
+		template <typename TEvent, typename TFunc>
+		bool SerializeValue(FArchive& Ar, ULES_Event* Event, TFunc&& Func)
+		{
+			if (Event->GetClass() != TEvent::StaticClass()) return false;
+
+			// Work on a copy, so quantizing the value doesn't modify the event being sent.
+			auto Value = static_cast<TEvent*>(Event)->Value;
+			Func(Value);
+			if (Ar.IsLoading())
+				static_cast<TEvent*>(Event)->Value = MoveTemp(Value);
+			return true;
+		}
+	}
+
+	FEventPacketCodec::FEventPacketCodec(const TSharedRef<const FReplicationTable>& InTable)
+		: Table(InTable)
+	{
+	}
+
+	bool FEventPacketCodec::Write(FArchive& Ar, ULES_Event* Event)
+	{
+		if (!Event) return false;
+
+		const int32 ClassIndex = Table->FindEventClass(Event->GetClass());
+		const int32 ChannelIndex = Table->FindChannel(Event->Channel);
+		if (ClassIndex == INDEX_NONE || ChannelIndex == INDEX_NONE) return false;
+
+		uint64 ClassIndexValue = ClassIndex;
+		uint64 ChannelIndexValue = ChannelIndex;
+		SerializeVarInt(Ar, ClassIndexValue);
+		SerializeVarInt(Ar, ChannelIndexValue);
+		SerializePayload(Ar, Event, DeltaStates.FindOrAdd(ClassIndexValue << 32 | ChannelIndexValue));
+		return true;
+	}
+
+	ULES_Event* FEventPacketCodec::Read(FArchive& Ar, UObject* Outer)
+	{
+		uint64 ClassIndex = 0;
+		uint64 ChannelIndex = 0;
+		SerializeVarInt(Ar, ClassIndex);
+		SerializeVarInt(Ar, ChannelIndex);
+
+		UClass* EventClass = ClassIndex <= MAX_int32 ? Table->GetEventClass(static_cast<int32>(ClassIndex)) : nullptr;
+		if (Ar.IsError() || !EventClass || ChannelIndex > MAX_int32 ||
+			!Table->IsValidChannel(static_cast<int32>(ChannelIndex)))
+		{
+			Ar.SetError();
+			return nullptr;
+		}
+
+		ULES_Event* Event = NewObject<ULES_Event>(Outer, EventClass);
+		Event->Channel = Table->GetChannel(static_cast<int32>(ChannelIndex));
+		SerializePayload(Ar, Event, DeltaStates.FindOrAdd(ClassIndex << 32 | ChannelIndex));
+		return Ar.IsError() ? nullptr : Event;
+	}
+
+	void FEventPacketCodec::Reset()
+	{
+		DeltaStates.Reset();
+	}
+
+	void FEventPacketCodec::SerializePayload(FArchive& Ar, ULES_Event* Event, FDeltaState& State)
+	{
+		// Names, texts and object references are written as strings, so both ends don't need matching name tables.
+		FObjectAndNameAsStringProxyArchive ProxyAr(Ar, false);
+
+		const bool bBasicEvent =
+			SerializeValue<ULES_BooleanEvent>(ProxyAr, Event, [&](bool& Value)
+			{
+				SerializeBit(ProxyAr, Value);
+			}) ||
+			SerializeValue<ULES_ByteEvent>(ProxyAr, Event, [&](uint8& Value)
+			{
+				SerializeIfChanged(ProxyAr, Value, State.Byte);
+			}) ||
+			SerializeValue<ULES_IntegerEvent>(ProxyAr, Event, [&](int32& Value)
+			{
+				int64 Value64 = Value;
+				SerializeDelta(ProxyAr, Value64, State.Integer);
+				Value = static_cast<int32>(Value64);
+			}) ||
+			SerializeValue<ULES_Integer64Event>(ProxyAr, Event, [&](int64& Value)
+			{
+				SerializeDelta(ProxyAr, Value, State.Integer);
+			}) ||
+			SerializeValue<ULES_FloatEvent>(ProxyAr, Event, [&](float& Value)
+			{
+				SerializeIfChanged(ProxyAr, Value, State.Float);
+			}) ||
+			SerializeValue<ULES_DoubleEvent>(ProxyAr, Event, [&](double& Value)
+			{
+				SerializeIfChanged(ProxyAr, Value, State.Double);
+			}) ||
+			SerializeValue<ULES_NameEvent>(ProxyAr, Event, [&](FName& Value)
+			{
+				FString String = Value.ToString();
+				SerializeIfChanged(ProxyAr, String, State.String);
+				Value = FName(String);
+			}) ||
+			SerializeValue<ULES_StringEvent>(ProxyAr, Event, [&](FString& Value)
+			{
+				SerializeIfChanged(ProxyAr, Value, State.String);
+			}) ||
+			SerializeValue<ULES_VectorEvent>(ProxyAr, Event, [&](FVector& Value)
+			{
+				SerializeQuantizedVector(ProxyAr, Value, State.Vector);
+			}) ||
+			SerializeValue<ULES_RotatorEvent>(ProxyAr, Event, [&](FRotator& Value)
+			{
+				SerializeQuantizedRotator(ProxyAr, Value, State.Rotator);
+			}) ||
+			SerializeValue<ULES_TransformEvent>(ProxyAr, Event, [&](FTransform& Value)
+			{
+				FVector Translation = Value.GetTranslation();
+				FRotator Rotation = Value.Rotator();
+				FVector Scale = Value.GetScale3D();
+				SerializeQuantizedVector(ProxyAr, Translation, State.Vector);
+				SerializeQuantizedRotator(ProxyAr, Rotation, State.Rotator);
+				SerializeQuantizedVector(ProxyAr, Scale, State.Scale);
+				Value = FTransform(Rotation, Translation, Scale);
+			});
+		if (bBasicEvent) return;
+
+		// Other events, including texts and objects, are written in full, skipping the properties common to all events.
+		for (TFieldIterator<FProperty> It(Event->GetClass()); It; ++It)
+		{
+			if (It->GetOwnerClass() == ULES_Event::StaticClass()) continue;
+			for (int32 Index = 0; Index < It->ArrayDim; Index++)
+			{
+				FStructuredArchiveFromArchive StructuredAr(ProxyAr);
+				It->SerializeItem(StructuredAr.GetSlot(), It->ContainerPtrToValuePtr<void>(Event, Index));
+			}
+		}
+	}
+}
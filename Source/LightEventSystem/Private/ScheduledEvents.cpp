@@ -0,0 +1,151 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+
+#include "ScheduledEvents.h"
+
+namespace LES
+{
+	FTimingWheel::FTimingWheel(const double InTickLength, const int32 InNumSlots)
+		: TickLength(FMath::Max(InTickLength, UE_DOUBLE_KINDA_SMALL_NUMBER)),
+		  SlotMask(static_cast<int32>(FMath::RoundUpToPowerOfTwo(FMath::Max(InNumSlots, 1))) - 1)
+	{
+		SlotHeads.Init(INDEX_NONE, SlotMask + 1);
+	}
+
+	FLES_ScheduledEventHandle FTimingWheel::Schedule(ULES_Event* Event, const double FireTime)
+	{
+		if (!IsValid(Event)) return {};
+
+		int32 Index;
+		if (FreeEntries.Num() > 0)
+		{
+			Index = FreeEntries.Pop(EAllowShrinking::No);
+		}
+		else
+		{
+			Index = Entries.AddDefaulted();
+		}
+
+		FEntry& Entry = Entries[Index];
+		Entry.Event = Event;
+		Entry.FireTick = FMath::Max(TimeToTick(FireTime), ProcessedTick);
+		Entry.Sequence = NextSequence++;
+		Link(Index);
+
+		NumScheduled++;
+		return {Index, Entry.Serial};
+	}
+
+	bool FTimingWheel::Cancel(const FLES_ScheduledEventHandle& Handle)
+	{
+		if (!IsScheduled(Handle)) return false;
+
+		Unlink(Handle.Index);
+		Release(Handle.Index);
+		return true;
+	}
+
+	bool FTimingWheel::IsScheduled(const FLES_ScheduledEventHandle& Handle) const
+	{
+		return Entries.IsValidIndex(Handle.Index) &&
+			Entries[Handle.Index].Serial == Handle.Serial &&
+			Entries[Handle.Index].Event != nullptr;
+	}
+
+	void FTimingWheel::Advance(const double NewTime, TArray<ULES_Event*>& OutDueEvents)
+	{
+		const int64 NewTick = FMath::FloorToInt64(NewTime / TickLength + UE_DOUBLE_KINDA_SMALL_NUMBER);
+		if (NewTick < ProcessedTick) return;
+
+		// The slot of the last processed tick is visited again, since events may have been scheduled into it after the
+		// previous advance. If more than one revolution has passed, every slot is visited exactly once.
+		const int64 NumTicks = FMath::Min<int64>(NewTick - ProcessedTick + 1, SlotMask + 1);
+		DueEntries.Reset();
+		for (int64 Tick = ProcessedTick; Tick < ProcessedTick + NumTicks; Tick++)
+		{
+			for (int32 Index = SlotHeads[Tick & SlotMask]; Index != INDEX_NONE; Index = Entries[Index].Next)
+			{
+				if (Entries[Index].FireTick <= NewTick)
+					DueEntries.Add(Index);
+			}
+		}
+		ProcessedTick = NewTick;
+
+		DueEntries.Sort([this](const int32 A, const int32 B)
+		{
+			return Entries[A].FireTick != Entries[B].FireTick
+				       ? Entries[A].FireTick < Entries[B].FireTick
+				       : Entries[A].Sequence < Entries[B].Sequence;
+		});
+
+		OutDueEvents.Reserve(OutDueEvents.Num() + DueEntries.Num());
+		for (const int32 Index : DueEntries)
+		{
+			OutDueEvents.Add(Entries[Index].Event);
+			Unlink(Index);
+			Release(Index);
+		}
+	}
+
+	void FTimingWheel::Empty()
+	{
+		for (int32 Index = 0; Index < Entries.Num(); Index++)
+		{
+			if (Entries[Index].Event != nullptr)
+			{
+				Unlink(Index);
+				Release(Index);
+			}
+		}
+	}
+
+	void FTimingWheel::AddReferencedObjects(FReferenceCollector& Collector)
+	{
+		for (FEntry& Entry : Entries)
+		{
+			if (Entry.Event != nullptr)
+				Collector.AddReferencedObject(Entry.Event);
+		}
+	}
+
+	int64 FTimingWheel::TimeToTick(const double Time) const
+	{
+		return FMath::CeilToInt64(Time / TickLength - UE_DOUBLE_KINDA_SMALL_NUMBER);
+	}
+
+	void FTimingWheel::Link(const int32 Index)
+	{
+		FEntry& Entry = Entries[Index];
+		int32& Head = SlotHeads[Entry.FireTick & SlotMask];
+
+		Entry.Prev = INDEX_NONE;
+		Entry.Next = Head;
+		if (Head != INDEX_NONE)
+			Entries[Head].Prev = Index;
+		Head = Index;
+	}
+
+	void FTimingWheel::Unlink(const int32 Index)
+	{
+		const FEntry& Entry = Entries[Index];
+		if (Entry.Prev != INDEX_NONE)
+			Entries[Entry.Prev].Next = Entry.Next;
+		else
+			SlotHeads[Entry.FireTick & SlotMask] = Entry.Next;
+
+		if (Entry.Next != INDEX_NONE)
+			Entries[Entry.Next].Prev = Entry.Prev;
+	}
+
+	void FTimingWheel::Release(const int32 Index)
+	{
+		FEntry& Entry = Entries[Index];
+		Entry.Event = nullptr;
+		Entry.Prev = INDEX_NONE;
+		Entry.Next = INDEX_NONE;
+		Entry.Serial++;
+
+		FreeEntries.Add(Index);
+		NumScheduled--;
+	}
+}
@@ -0,0 +1,345 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+
+#include "ShardedEventBus.h"
+
+#include "Async/UniqueLock.h"
+#include "HAL/Event.h"
+#include "HAL/RunnableThread.h"
+#include "UObject/GarbageCollection.h"
+
+ULES_ShardedEventBus::FShard::FShard(ULES_EventSystem* InEventSystem, const float InTickInterval)
+	: EventSystem(InEventSystem),
+	  TickInterval(FMath::Max(InTickInterval, 0.001f)),
+	  LastTickTime(FPlatformTime::Seconds())
+{
+	WakeUp = FPlatformProcess::GetSynchEventFromPool();
+	Thread = FRunnableThread::Create(this, *FString::Printf(TEXT("LES_Shard_%s"), *EventSystem->GetName()));
+}
+
+ULES_ShardedEventBus::FShard::~FShard()
+{
+	StopThread();
+	FPlatformProcess::ReturnSynchEventToPool(WakeUp);
+}
+
+void ULES_ShardedEventBus::FShard::Post(FMessage&& Message)
+{
+	// Counted as pending before it's counted as posted, which Flush relies on.
+	Counters.NumPending++;
+	Counters.NumPosted++;
+	{
+		UE::TUniqueLock Lock(InboxLock);
+		Inbox.Add(MoveTemp(Message));
+	}
+	WakeUp->Trigger();
+}
+
+void ULES_ShardedEventBus::FShard::Execute(TFunctionRef<void()> Command)
+{
+	if (!Thread || IsInThread())
+	{
+		Command();
+		return;
+	}
+
+	FEvent* Done = FPlatformProcess::GetSynchEventFromPool();
+	Post({.Command = [&Command, Done]
+	{
+		Command();
+		Done->Trigger();
+	}});
+	Done->Wait();
+	FPlatformProcess::ReturnSynchEventToPool(Done);
+}
+
+bool ULES_ShardedEventBus::FShard::IsInThread() const
+{
+	return FPlatformTLS::GetCurrentThreadId() == ThreadId;
+}
+
+void ULES_ShardedEventBus::FShard::StopThread()
+{
+	if (!Thread) return;
+
+	Stop();
+	Thread->WaitForCompletion();
+	delete Thread;
+	Thread = nullptr;
+	ThreadId = 0;
+}
+
+void ULES_ShardedEventBus::FShard::Discard()
+{
+	bDiscarded = true;
+	Stop();
+}
+
+void ULES_ShardedEventBus::FShard::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	// The messages being handled block the garbage collection, so only the inbox has to be reported.
+	UE::TUniqueLock Lock(InboxLock);
+	for (FMessage& Message : Inbox)
+		Collector.AddReferencedObject(Message.Event);
+}
+
+uint32 ULES_ShardedEventBus::FShard::Run()
+{
+	ThreadId = FPlatformTLS::GetCurrentThreadId();
+	const uint32 WaitTime = FMath::Max(FMath::FloorToInt32(TickInterval * 1000.0f), 1);
+	while (!bStopping)
+	{
+		WakeUp->Wait(WaitTime);
+		Drain();
+	}
+	Drain();
+	return 0;
+}
+
+void ULES_ShardedEventBus::FShard::Stop()
+{
+	bStopping = true;
+	WakeUp->Trigger();
+}
+
+void ULES_ShardedEventBus::FShard::Drain()
+{
+	FGCScopeGuard GarbageCollectionGuard;
+	{
+		UE::TUniqueLock Lock(InboxLock);
+		if (bDiscarded)
+		{
+			Counters.NumPending -= Inbox.Num();
+			Inbox.Empty();
+			return;
+		}
+		Swap(Inbox, Processing);
+	}
+
+	// Messages posted by the handlers to this shard wait for the next drain, which starts right away.
+	for (FMessage& Message : Processing)
+	{
+		if (Message.Command)
+		{
+			Message.Command();
+		}
+		else if (IsValid(Message.Event))
+		{
+			if (Message.ForwardedHandler.IsValid())
+			{
+				if (const TSharedPtr<FForwardedHandler, ESPMode::ThreadSafe> Handler = Message.ForwardedHandler.Pin())
+					Handler->Callback(Message.Event);
+			}
+			else
+			{
+				EventSystem->SendEvent(Message.Event);
+			}
+		}
+	}
+	Counters.NumPending -= Processing.Num();
+	Processing.Reset();
+
+	if (bGarbageCollected.exchange(false))
+	{
+		if (EventSystem->bCleanAfterGarbageCollection)
+			EventSystem->Clean();
+		EventSystem->PurgeUnloadedEventClasses();
+	}
+
+	const double Time = FPlatformTime::Seconds();
+	if (Time - LastTickTime >= TickInterval)
+	{
+		EventSystem->Tick(Time - LastTickTime);
+		LastTickTime = Time;
+	}
+}
+
+void ULES_ShardedEventBus::Start(const int32 NumShards, const float TickInterval)
+{
+	check(IsInGameThread());
+	if (IsRunning()) return;
+
+	for (int32 ShardIndex = 0; ShardIndex < FMath::Max(NumShards, 1); ShardIndex++)
+	{
+		// The shard cleans its Event System on its own thread, instead of right after the garbage collection.
+		ULES_EventSystem* EventSystem = ShardEventSystems.Add_GetRef(NewObject<ULES_EventSystem>(this));
+		FCoreUObjectDelegates::GetPostGarbageCollect().Remove(EventSystem->PostGarbageCollectHandle);
+		EventSystem->PostGarbageCollectHandle.Reset();
+		EventSystem->bOwnedByShard = true;
+		Shards.Add(MakeUnique<FShard>(EventSystem, TickInterval));
+	}
+
+	PostGarbageCollectHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddWeakLambda(this, [this]
+	{
+		for (const TUniquePtr<FShard>& Shard : Shards)
+			Shard->NotifyGarbageCollected();
+	});
+}
+
+void ULES_ShardedEventBus::Stop()
+{
+	check(IsInGameThread());
+	FCoreUObjectDelegates::GetPostGarbageCollect().Remove(PostGarbageCollectHandle);
+	PostGarbageCollectHandle.Reset();
+
+	// Shards may forward messages to each other until all of them are stopped.
+	Flush();
+	for (const TUniquePtr<FShard>& Shard : Shards)
+		Shard->StopThread();
+	Shards.Empty();
+	ShardEventSystems.Empty();
+}
+
+int32 ULES_ShardedEventBus::GetShard(const FName Channel) const
+{
+	if (Shards.IsEmpty()) return INDEX_NONE;
+
+	return static_cast<int32>(MurmurFinalize32(GetTypeHash(Channel)) % static_cast<uint32>(Shards.Num()));
+}
+
+ULES_EventSystem* ULES_ShardedEventBus::GetShardEventSystem(const int32 ShardIndex) const
+{
+	return Shards.IsValidIndex(ShardIndex) ? Shards[ShardIndex]->EventSystem : nullptr;
+}
+
+bool ULES_ShardedEventBus::IsInShardThread(const int32 ShardIndex) const
+{
+	return Shards.IsValidIndex(ShardIndex) && Shards[ShardIndex]->IsInThread();
+}
+
+void ULES_ShardedEventBus::PinObserver(const UObject* Observer, const int32 ShardIndex)
+{
+	UE::TUniqueLock Lock(PinLock);
+	if (ShardIndex == INDEX_NONE)
+		PinnedObservers.Remove(Observer);
+	else
+		PinnedObservers.Add(Observer, ShardIndex);
+}
+
+int32 ULES_ShardedEventBus::GetPinnedShard(const UObject* Observer) const
+{
+	UE::TUniqueLock Lock(PinLock);
+	const int32* ShardIndex = PinnedObservers.Find(Observer);
+	return ShardIndex ? *ShardIndex : INDEX_NONE;
+}
+
+bool ULES_ShardedEventBus::RemoveByHandle(const FLES_ObserverHandle& ObserverHandle)
+{
+	const int32 ShardIndex = GetShard(ObserverHandle.ObserverKey.Value);
+	if (ShardIndex == INDEX_NONE) return false;
+
+	bool bRemoved = false;
+	FShard& Shard = *Shards[ShardIndex];
+	Shard.Execute([&Shard, &ObserverHandle, &bRemoved]
+	{
+		bRemoved = Shard.EventSystem->RemoveByHandle(ObserverHandle);
+	});
+	return bRemoved;
+}
+
+int32 ULES_ShardedEventBus::Num() const
+{
+	int32 NumRecords = 0;
+	for (const TUniquePtr<FShard>& Shard : Shards)
+	{
+		Shard->Execute([&Shard, &NumRecords]
+		{
+			NumRecords += Shard->EventSystem->Num();
+		});
+	}
+	return NumRecords;
+}
+
+void ULES_ShardedEventBus::SendEvent(ULES_Event* Event)
+{
+	const int32 ShardIndex = Event ? GetShard(Event->Channel) : INDEX_NONE;
+	if (ShardIndex == INDEX_NONE) return;
+
+	Shards[ShardIndex]->Post({.Event = Event});
+}
+
+bool ULES_ShardedEventBus::Flush(const double Timeout) const
+{
+	auto GetNumPostedMessages = [this]
+	{
+		uint64 NumPosted = 0;
+		for (const TUniquePtr<FShard>& Shard : Shards)
+			NumPosted += Shard->GetNumPostedMessages();
+		return NumPosted;
+	};
+
+	// The shards are read one by one, so a handler may post to a shard that has already been read as idle. Messages
+	// are counted as pending before they're counted as posted, so such a post shows in the posted count read after.
+	const double EndTime = FPlatformTime::Seconds() + Timeout;
+	while (true)
+	{
+		const uint64 NumPosted = GetNumPostedMessages();
+		if (GetNumPendingMessages() == 0 && GetNumPostedMessages() == NumPosted) return true;
+		if (FPlatformTime::Seconds() > EndTime) return false;
+		FPlatformProcess::Sleep(0.0f);
+	}
+}
+
+int32 ULES_ShardedEventBus::GetNumPendingMessages() const
+{
+	int32 NumPending = 0;
+	for (const TUniquePtr<FShard>& Shard : Shards)
+		NumPending += Shard->GetNumPendingMessages();
+	return NumPending;
+}
+
+void ULES_ShardedEventBus::AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector)
+{
+	Super::AddReferencedObjects(InThis, Collector);
+
+	const ULES_ShardedEventBus* This = CastChecked<ULES_ShardedEventBus>(InThis);
+	for (const TUniquePtr<FShard>& Shard : This->Shards)
+		Shard->AddReferencedObjects(Collector);
+}
+
+void ULES_ShardedEventBus::BeginDestroy()
+{
+	FCoreUObjectDelegates::GetPostGarbageCollect().Remove(PostGarbageCollectHandle);
+	PostGarbageCollectHandle.Reset();
+
+	// The events left in the inboxes aren't referenced anymore, so the threads stop without handling them. They're
+	// joined once the garbage collection has finished, since they may be waiting for it.
+	for (const TUniquePtr<FShard>& Shard : Shards)
+		Shard->Discard();
+	Super::BeginDestroy();
+}
+
+void ULES_ShardedEventBus::FinishDestroy()
+{
+	Shards.Empty();
+	Super::FinishDestroy();
+}
+
+FLES_ObserverHandle ULES_ShardedEventBus::AddObserver_Private(const TSubclassOf<ULES_Event>& EventClass,
+                                                              UObject* Observer, LES::FObserverCallback&& Callback,
+                                                              const FName Channel)
+{
+	const int32 ShardIndex = GetShard(Channel);
+	if (ShardIndex == INDEX_NONE) return {};
+
+	// Deliveries to an observer pinned to another shard are forwarded, keeping the order of its channel's shard.
+	const int32 PinnedShard = GetPinnedShard(Observer);
+	if (Shards.IsValidIndex(PinnedShard) && PinnedShard != ShardIndex)
+	{
+		const auto Handler = MakeShared<FForwardedHandler, ESPMode::ThreadSafe>();
+		Handler->Callback = MoveTemp(Callback);
+		Handler->ShardIndex = PinnedShard;
+		Callback = LES::FObserverCallback([this, Handler](ULES_Event* Event)
+		{
+			Shards[Handler->ShardIndex]->Post({.Event = Event, .ForwardedHandler = Handler});
+		});
+	}
+
+	FLES_ObserverHandle Handle;
+	FShard& Shard = *Shards[ShardIndex];
+	Shard.Execute([&]
+	{
+		Handle = Shard.EventSystem->AddObserver_Private(EventClass, Observer, MoveTemp(Callback), Channel);
+	});
+	return Handle;
+}
@@ -0,0 +1,349 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+
+#include "SharedMemoryBridge.h"
+
+#include "LightEventSystemModule.h"
+#include "Misc/CoreDelegates.h"
+#include "UObject/UnrealType.h"
+
+namespace
+{
+	void AppendBytes(TArray<uint8>& Bytes, const void* Data, const int32 Size)
+	{
+		Bytes.Append(static_cast<const uint8*>(Data), Size);
+	}
+
+	void AppendUTF8(TArray<uint8>& Bytes, const FString& String)
+	{
+		const FTCHARToUTF8 UTF8(*String);
+		AppendBytes(Bytes, UTF8.Get(), UTF8.Length());
+	}
+
+	/**
+	 * Returns true if the \a Property holds values that only mean something in this process, even if they're plain old
+	 * data: name table indices, object pointers and delegates. Their bits mean nothing to the tools, and the garbage
+	 * collector would follow the pointers injected by them.
+	 */
+	bool IsProcessLocal(const FProperty* Property)
+	{
+		if (Property->IsA<FNameProperty>() || Property->IsA<FObjectPropertyBase>() ||
+			Property->IsA<FInterfaceProperty>() || Property->IsA<FDelegateProperty>() ||
+			Property->IsA<FMulticastDelegateProperty>())
+			return true;
+
+		if (const FStructProperty* StructProperty = CastField<FStructProperty>(Property))
+		{
+			for (TFieldIterator<FProperty> It(StructProperty->Struct); It; ++It)
+			{
+				if (IsProcessLocal(*It)) return true;
+			}
+		}
+		return false;
+	}
+}
+
+bool ULES_SharedMemoryBridge::Open(ULES_EventSystem* InEventSystem, const FString& Name, const int32 Capacity,
+                                   const int32 SchemaCapacity)
+{
+	Close();
+	if (!IsValid(InEventSystem) || Capacity <= 0 || SchemaCapacity <= 0) return false;
+
+	const uint32 RingCapacity = FMath::Max(FMath::RoundUpToPowerOfTwo(static_cast<uint32>(Capacity)), 64u);
+	const uint64 RegionSize = LES::Bridge::GetRegionSize(RingCapacity, SchemaCapacity);
+	Region = FPlatformMemory::MapNamedSharedMemoryRegion(
+		Name, true, FPlatformMemory::ESharedMemoryAccess::Read | FPlatformMemory::ESharedMemoryAccess::Write,
+		RegionSize);
+	if (!Region)
+	{
+		UE_LOG(LogLightEventSystem, Warning, TEXT("Couldn't create the shared memory region %s."), *Name);
+		return false;
+	}
+
+	EventSystem = InEventSystem;
+	LES::Bridge::InitializeRegion(Region->GetAddress(), RingCapacity, SchemaCapacity);
+	Header = LES::Bridge::GetRegionHeader(Region->GetAddress(), Region->GetSize());
+	Writer = LES::Bridge::FRingWriter(Header, LES::Bridge::GameToTools);
+	Reader = LES::Bridge::FRingReader(Header, LES::Bridge::ToolsToGame);
+
+	// Classes registered before reopening the bridge keep their ids.
+	for (const TWeakObjectPtr<UClass>& EventClass : ClassesById)
+	{
+		if (const FClassSchema* Schema = Schemas.Find(EventClass.Get()))
+			PublishSchema(EventClass.Get(), *Schema);
+	}
+
+	BeginFrameHandle = FCoreDelegates::OnBeginFrame.AddWeakLambda(this, [this]
+	{
+		if (bReceiveAtBeginningOfFrame)
+			ReceiveInjectedEvents();
+	});
+	return true;
+}
+
+void ULES_SharedMemoryBridge::Close()
+{
+	FCoreDelegates::OnBeginFrame.Remove(BeginFrameHandle);
+	BeginFrameHandle.Reset();
+	Writer = {};
+	Reader = {};
+	Header = nullptr;
+	if (Region)
+	{
+		FPlatformMemory::UnmapNamedSharedMemoryRegion(Region);
+		Region = nullptr;
+	}
+}
+
+bool ULES_SharedMemoryBridge::Mirror(const TSubclassOf<ULES_Event>& EventClass, const FName Channel)
+{
+	if (!IsValid(EventSystem) || !EventClass) return false;
+	FindOrAddSchema(EventClass);
+
+	TArray<uint8> ChannelUTF8;
+	AppendUTF8(ChannelUTF8, Channel.ToString());
+	EventSystem->AddObserver_Private(EventClass, this, [this, ChannelUTF8 = MoveTemp(ChannelUTF8)](ULES_Event* Event)
+	{
+		MirrorEvent(Event, ChannelUTF8);
+	}, Channel);
+	return true;
+}
+
+bool ULES_SharedMemoryBridge::AllowInjection(const TSubclassOf<ULES_Event>& EventClass)
+{
+	if (!EventClass) return false;
+	FindOrAddSchema(EventClass)->bInjectable = true;
+	return true;
+}
+
+int32 ULES_SharedMemoryBridge::ReceiveInjectedEvents()
+{
+	if (!Header || !IsValid(EventSystem)) return 0;
+
+	int32 NumReceived = 0;
+	LES::Bridge::FRecordHeader RecordHeader;
+	const uint8* Body = nullptr;
+	uint32 BodySize = 0;
+	while (Reader.Peek(RecordHeader, Body, BodySize))
+	{
+		// The event is decoded before popping, since the body lives in the ring.
+		ULES_Event* Event = RecordHeader.Type == LES::Bridge::ERecordType::Event ? DecodeEvent(Body, BodySize) : nullptr;
+		Reader.Pop();
+		if (!Event)
+		{
+			UE_LOG(LogLightEventSystem, Warning, TEXT("Skipped an injected event that couldn't be decoded."));
+			continue;
+		}
+
+		NumInjected++;
+		NumReceived++;
+		EventSystem->SendEvent(Event);
+	}
+	return NumReceived;
+}
+
+int64 ULES_SharedMemoryBridge::GetNumDropped() const
+{
+	return Header ? Header->Rings[LES::Bridge::GameToTools].NumDropped.load(std::memory_order_relaxed) : 0;
+}
+
+void ULES_SharedMemoryBridge::BeginDestroy()
+{
+	Close();
+	Super::BeginDestroy();
+}
+
+ULES_SharedMemoryBridge::FClassSchema* ULES_SharedMemoryBridge::FindOrAddSchema(UClass* EventClass)
+{
+	if (FClassSchema* Schema = Schemas.Find(EventClass))
+		return Schema;
+
+	FClassSchema Schema;
+	Schema.ClassId = ClassesById.Add(EventClass);
+	for (TFieldIterator<FProperty> It(EventClass); It; ++It)
+	{
+		if (It->GetOwnerClass() == ULES_Event::StaticClass()) continue;
+
+		// Bitfield booleans share their byte with other properties, so they can't be copied on their own.
+		const FBoolProperty* BoolProperty = CastField<FBoolProperty>(*It);
+		if (It->HasAnyPropertyFlags(CPF_IsPlainOldData) && !IsProcessLocal(*It) &&
+			(!BoolProperty || BoolProperty->IsNativeBool()))
+		{
+			Schema.Fields.Add({.Property = *It, .bRaw = true});
+			Schema.RawSize += It->GetSize();
+			continue;
+		}
+
+		for (int32 Index = 0; Index < It->ArrayDim; Index++)
+			Schema.Fields.Add({.Property = *It, .ArrayIndex = Index});
+		Schema.bHasTextFields = true;
+	}
+
+	PublishSchema(EventClass, Schema);
+	return &Schemas.Add(EventClass, MoveTemp(Schema));
+}
+
+void ULES_SharedMemoryBridge::PublishSchema(const UClass* EventClass, const FClassSchema& Schema) const
+{
+	if (!Header) return;
+
+	TArray<uint8> ClassName;
+	AppendUTF8(ClassName, EventClass->GetPathName());
+	const uint16 NumFields = Schema.Fields.Num();
+	const uint16 ClassNameLength = ClassName.Num();
+
+	TArray<uint8> Body;
+	AppendBytes(Body, &Schema.ClassId, sizeof(Schema.ClassId));
+	AppendBytes(Body, &NumFields, sizeof(NumFields));
+	AppendBytes(Body, &ClassNameLength, sizeof(ClassNameLength));
+	Body.Append(ClassName);
+	for (const FField& Field : Schema.Fields)
+	{
+		TArray<uint8> Name;
+		AppendUTF8(Name, Field.bRaw || Field.Property->ArrayDim == 1
+			                 ? Field.Property->GetName()
+			                 : FString::Printf(TEXT("%s[%d]"), *Field.Property->GetName(), Field.ArrayIndex));
+		const uint16 NameLength = Name.Num();
+		const LES::Bridge::EFieldKind Kind = Field.bRaw ? LES::Bridge::EFieldKind::Raw : LES::Bridge::EFieldKind::Text;
+		const uint8 Reserved = 0;
+		const uint32 Size = Field.bRaw ? Field.Property->GetSize() : 0;
+		AppendBytes(Body, &NameLength, sizeof(NameLength));
+		AppendBytes(Body, &Kind, sizeof(Kind));
+		AppendBytes(Body, &Reserved, sizeof(Reserved));
+		AppendBytes(Body, &Size, sizeof(Size));
+		Body.Append(Name);
+	}
+
+	if (!LES::Bridge::AppendSchema(Header, Body.GetData(), Body.Num()))
+	{
+		UE_LOG(LogLightEventSystem, Warning, TEXT("Schema log of the bridge is full, can't publish class %s."),
+		       *EventClass->GetName());
+	}
+}
+
+void ULES_SharedMemoryBridge::MirrorEvent(ULES_Event* Event, const TArray<uint8>& Channel)
+{
+	if (!Header) return;
+
+	const FClassSchema* Schema = FindOrAddSchema(Event->GetClass());
+	TextScratch.Reset();
+	TextLengths.Reset();
+	if (Schema->bHasTextFields)
+	{
+		for (const FField& Field : Schema->Fields)
+		{
+			if (Field.bRaw) continue;
+			ExportField(Field, Event);
+			const FTCHARToUTF8 UTF8(*TextValue);
+			TextLengths.Add(UTF8.Length());
+			AppendBytes(TextScratch, UTF8.Get(), UTF8.Length());
+		}
+	}
+
+	const uint32 BodySize = sizeof(uint32) + 2 * sizeof(uint16) + Channel.Num() + Schema->RawSize +
+		TextLengths.Num() * sizeof(uint32) + TextScratch.Num();
+	uint8* Body = Writer.BeginWrite(LES::Bridge::ERecordType::Event, BodySize);
+	if (!Body) return;
+
+	const auto Write = [&Body](const void* Data, const SIZE_T Size)
+	{
+		FMemory::Memcpy(Body, Data, Size);
+		Body += Size;
+	};
+	const uint16 ChannelLength = Channel.Num();
+	const uint16 Reserved = 0;
+	Write(&Schema->ClassId, sizeof(Schema->ClassId));
+	Write(&ChannelLength, sizeof(ChannelLength));
+	Write(&Reserved, sizeof(Reserved));
+	Write(Channel.GetData(), Channel.Num());
+
+	int32 TextIndex = 0;
+	int32 TextOffset = 0;
+	for (const FField& Field : Schema->Fields)
+	{
+		if (Field.bRaw)
+		{
+			Write(Field.Property->ContainerPtrToValuePtr<void>(Event), Field.Property->GetSize());
+			continue;
+		}
+
+		const uint32 Length = TextLengths[TextIndex++];
+		Write(&Length, sizeof(Length));
+		Write(TextScratch.GetData() + TextOffset, Length);
+		TextOffset += Length;
+	}
+	Writer.EndWrite();
+	NumMirrored++;
+}
+
+ULES_Event* ULES_SharedMemoryBridge::DecodeEvent(const uint8* Body, const uint32 BodySize)
+{
+	uint32 Offset = 0;
+	const auto Read = [&](void* Data, const uint32 Size)
+	{
+		if (BodySize - Offset < Size) return false;
+		FMemory::Memcpy(Data, Body + Offset, Size);
+		Offset += Size;
+		return true;
+	};
+
+	uint32 ClassId = 0;
+	uint16 ChannelLength = 0;
+	uint16 Reserved = 0;
+	if (!Read(&ClassId, sizeof(ClassId)) || !Read(&ChannelLength, sizeof(ChannelLength)) ||
+		!Read(&Reserved, sizeof(Reserved)) || BodySize - Offset < ChannelLength)
+		return nullptr;
+
+	UClass* EventClass = ClassesById.IsValidIndex(ClassId) ? ClassesById[ClassId].Get() : nullptr;
+	const FClassSchema* Schema = EventClass ? Schemas.Find(EventClass) : nullptr;
+	if (!Schema || !Schema->bInjectable) return nullptr;
+
+	const FUTF8ToTCHAR Channel(reinterpret_cast<const ANSICHAR*>(Body + Offset), ChannelLength);
+	Offset += ChannelLength;
+
+	ULES_Event* Event = NewObject<ULES_Event>(this, EventClass);
+	Event->Channel = FName(Channel.Length(), Channel.Get());
+	for (const FField& Field : Schema->Fields)
+	{
+		if (Field.bRaw)
+		{
+			if (!Read(Field.Property->ContainerPtrToValuePtr<void>(Event), Field.Property->GetSize())) return nullptr;
+			continue;
+		}
+
+		uint32 Length = 0;
+		if (!Read(&Length, sizeof(Length)) || BodySize - Offset < Length) return nullptr;
+		const FUTF8ToTCHAR Text(reinterpret_cast<const ANSICHAR*>(Body + Offset), Length);
+		Offset += Length;
+		TextValue = FString(Text.Length(), Text.Get());
+		ImportField(Field, Event);
+	}
+	return Event;
+}
+
+void ULES_SharedMemoryBridge::ExportField(const FField& Field, const ULES_Event* Event)
+{
+	const void* Value = Field.Property->ContainerPtrToValuePtr<void>(Event, Field.ArrayIndex);
+	TextValue.Reset();
+	if (CastField<FStrProperty>(Field.Property))
+		TextValue.Append(*static_cast<const FString*>(Value));
+	else if (CastField<FNameProperty>(Field.Property))
+		static_cast<const FName*>(Value)->AppendString(TextValue);
+	else if (CastField<FTextProperty>(Field.Property))
+		TextValue.Append(static_cast<const FText*>(Value)->ToString());
+	else
+		Field.Property->ExportTextItem_Direct(TextValue, Value, nullptr, nullptr, PPF_None);
+}
+
+void ULES_SharedMemoryBridge::ImportField(const FField& Field, ULES_Event* Event) const
+{
+	void* Value = Field.Property->ContainerPtrToValuePtr<void>(Event, Field.ArrayIndex);
+	if (CastField<FStrProperty>(Field.Property))
+		*static_cast<FString*>(Value) = TextValue;
+	else if (CastField<FNameProperty>(Field.Property))
+		*static_cast<FName*>(Value) = FName(*TextValue);
+	else if (CastField<FTextProperty>(Field.Property))
+		*static_cast<FText*>(Value) = FText::FromString(TextValue);
+	else
+		Field.Property->ImportText_Direct(*TextValue, Value, Event, PPF_None);
+}
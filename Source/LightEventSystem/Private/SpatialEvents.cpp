@@ -0,0 +1,230 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+
+#include "SpatialEvents.h"
+
+#include "Components/SceneComponent.h"
+
+namespace LES
+{
+	FSpatialHash::FSpatialHash(const float InCellSize)
+		: CellSize(FMath::Max(InCellSize, 1.0f)),
+		  InverseCellSize(1.0f / CellSize)
+	{
+	}
+
+	int32 FSpatialHash::Add(const int32 Record, const FVector& Position, const float Radius,
+	                        const USceneComponent* Source)
+	{
+		int32 Entry;
+		if (FreeEntries.Num() > 0)
+		{
+			Entry = FreeEntries.Pop(EAllowShrinking::No);
+		}
+		else
+		{
+			Entry = Entries.AddDefaulted();
+			EntryRecords.Add(INDEX_NONE);
+		}
+
+		Entries[Entry].Source = Source;
+		EntryRecords[Entry] = Record;
+		NumEntries++;
+
+		const FVector EntryPosition = IsValid(Source) ? Source->GetComponentLocation() : Position;
+		const float EntryRadius = FMath::Max(Radius, 0.0f);
+		MaxRadius = FMath::Max(MaxRadius, EntryRadius);
+		Bin(Entry, GetCell(EntryPosition), EntryPosition, EntryRadius);
+		return Entry;
+	}
+
+	void FSpatialHash::Remove(const int32 Entry)
+	{
+		Unbin(Entry);
+		Entries[Entry].Source = nullptr;
+		EntryRecords[Entry] = INDEX_NONE;
+		FreeEntries.Add(Entry);
+		NumEntries--;
+		bMaxRadiusDirty = true;
+	}
+
+	void FSpatialHash::SetSource(const int32 Entry, const USceneComponent* Source, const float Radius)
+	{
+		const FCell& Cell = Cells.FindChecked(Entries[Entry].Cell);
+		const int32 Slot = Entries[Entry].Slot;
+		const FVector Position = IsValid(Source)
+			                         ? Source->GetComponentLocation()
+			                         : FVector(Cell.X[Slot], Cell.Y[Slot], Cell.Z[Slot]);
+		const float EntryRadius = FMath::Max(Radius, 0.0f);
+
+		Entries[Entry].Source = Source;
+		Unbin(Entry);
+		MaxRadius = FMath::Max(MaxRadius, EntryRadius);
+		bMaxRadiusDirty = true;
+		Bin(Entry, GetCell(Position), Position, EntryRadius);
+	}
+
+	void FSpatialHash::SetPosition(const int32 Entry, const FVector& Position)
+	{
+		FEntry& EntryData = Entries[Entry];
+		const FIntVector NewCell = GetCell(Position);
+		if (NewCell == EntryData.Cell)
+		{
+			const FVector3f Location(Position);
+			FCell& Cell = Cells.FindChecked(NewCell);
+			Cell.X[EntryData.Slot] = Location.X;
+			Cell.Y[EntryData.Slot] = Location.Y;
+			Cell.Z[EntryData.Slot] = Location.Z;
+			return;
+		}
+
+		const float Radius = Cells.FindChecked(EntryData.Cell).Radius[EntryData.Slot];
+		Unbin(Entry);
+		Bin(Entry, NewCell, Position, Radius);
+	}
+
+	void FSpatialHash::Update()
+	{
+		for (int32 Entry = 0; Entry < Entries.Num(); Entry++)
+		{
+			if (EntryRecords[Entry] == INDEX_NONE) continue;
+
+			// Entries whose source has been destroyed stay where the source was last seen.
+			if (const USceneComponent* Source = Entries[Entry].Source.Get())
+				SetPosition(Entry, Source->GetComponentLocation());
+		}
+
+		if (bMaxRadiusDirty)
+		{
+			MaxRadius = 0.0f;
+			for (const TPair<FIntVector, FCell>& Cell : Cells)
+			{
+				for (const float Radius : Cell.Value.Radius)
+					MaxRadius = FMath::Max(MaxRadius, Radius);
+			}
+			bMaxRadiusDirty = false;
+		}
+	}
+
+	void FSpatialHash::Query(const FVector& Center, const float Radius, TArray<int32>& OutRecords) const
+	{
+		if (NumEntries == 0) return;
+
+		// Broad phase: the cells overlapping the bounds of the query, grown by the largest radius of the entries.
+		const double Reach = FMath::Max(Radius, 0.0f) + MaxRadius;
+		const FIntVector MinCell = GetCell(Center - FVector(Reach));
+		const FIntVector MaxCell = GetCell(Center + FVector(Reach));
+		const int64 NumCellsInBounds = Reach * InverseCellSize < 1024.0
+			                               ? static_cast<int64>(MaxCell.X - MinCell.X + 1) *
+			                               (MaxCell.Y - MinCell.Y + 1) * (MaxCell.Z - MinCell.Z + 1)
+			                               : MAX_int64;
+
+		const FVector3f QueryCenter(Center);
+		const float QueryRadius = FMath::Max(Radius, 0.0f);
+		if (NumCellsInBounds > Cells.Num())
+		{
+			// Huge queries would look up mostly empty cells, so every occupied cell is tested instead.
+			for (const TPair<FIntVector, FCell>& Cell : Cells)
+				QueryCell(Cell.Value, QueryCenter, QueryRadius, EntryRecords, OutRecords);
+			return;
+		}
+
+		for (int32 Z = MinCell.Z; Z <= MaxCell.Z; Z++)
+		{
+			for (int32 Y = MinCell.Y; Y <= MaxCell.Y; Y++)
+			{
+				for (int32 X = MinCell.X; X <= MaxCell.X; X++)
+				{
+					if (const FCell* Cell = Cells.Find(FIntVector(X, Y, Z)))
+						QueryCell(*Cell, QueryCenter, QueryRadius, EntryRecords, OutRecords);
+				}
+			}
+		}
+	}
+
+	SIZE_T FSpatialHash::GetAllocatedSize() const
+	{
+		SIZE_T Size = Entries.GetAllocatedSize() + EntryRecords.GetAllocatedSize() + FreeEntries.GetAllocatedSize() +
+			Cells.GetAllocatedSize();
+		for (const TPair<FIntVector, FCell>& Cell : Cells)
+		{
+			Size += Cell.Value.X.GetAllocatedSize() + Cell.Value.Y.GetAllocatedSize() +
+				Cell.Value.Z.GetAllocatedSize() + Cell.Value.Radius.GetAllocatedSize() +
+				Cell.Value.Entries.GetAllocatedSize();
+		}
+		return Size;
+	}
+
+	FIntVector FSpatialHash::GetCell(const FVector& Position) const
+	{
+		return FIntVector(FMath::FloorToInt32(Position.X * InverseCellSize),
+		                  FMath::FloorToInt32(Position.Y * InverseCellSize),
+		                  FMath::FloorToInt32(Position.Z * InverseCellSize));
+	}
+
+	void FSpatialHash::Bin(const int32 Entry, const FIntVector& Cell, const FVector& Position, const float Radius)
+	{
+		const FVector3f Location(Position);
+		FCell& CellData = Cells.FindOrAdd(Cell);
+		Entries[Entry].Cell = Cell;
+		Entries[Entry].Slot = CellData.Entries.Add(Entry);
+		CellData.X.Add(Location.X);
+		CellData.Y.Add(Location.Y);
+		CellData.Z.Add(Location.Z);
+		CellData.Radius.Add(Radius);
+	}
+
+	void FSpatialHash::Unbin(const int32 Entry)
+	{
+		FEntry& EntryData = Entries[Entry];
+		FCell& Cell = Cells.FindChecked(EntryData.Cell);
+		const int32 Slot = EntryData.Slot;
+		Cell.X.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+		Cell.Y.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+		Cell.Z.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+		Cell.Radius.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+		Cell.Entries.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+		if (Cell.Entries.IsValidIndex(Slot))
+			Entries[Cell.Entries[Slot]].Slot = Slot;
+		if (Cell.Entries.IsEmpty())
+			Cells.Remove(EntryData.Cell);
+		EntryData.Slot = INDEX_NONE;
+	}
+
+	void FSpatialHash::QueryCell(const FCell& Cell, const FVector3f& Center, const float Radius,
+	                             const TConstArrayView<int32> EntryRecords, TArray<int32>& OutRecords)
+	{
+		// Narrow phase: an entry is within reach if its squared distance is at most the squared sum of the radii.
+		const int32 Num = Cell.Entries.Num();
+		const VectorRegister4Float CenterX = VectorSetFloat1(Center.X);
+		const VectorRegister4Float CenterY = VectorSetFloat1(Center.Y);
+		const VectorRegister4Float CenterZ = VectorSetFloat1(Center.Z);
+		const VectorRegister4Float QueryRadius = VectorSetFloat1(Radius);
+
+		int32 Slot = 0;
+		for (; Slot + 4 <= Num; Slot += 4)
+		{
+			const VectorRegister4Float DeltaX = VectorSubtract(VectorLoad(&Cell.X[Slot]), CenterX);
+			const VectorRegister4Float DeltaY = VectorSubtract(VectorLoad(&Cell.Y[Slot]), CenterY);
+			const VectorRegister4Float DeltaZ = VectorSubtract(VectorLoad(&Cell.Z[Slot]), CenterZ);
+			const VectorRegister4Float DistanceSquared = VectorMultiplyAdd(
+				DeltaX, DeltaX, VectorMultiplyAdd(DeltaY, DeltaY, VectorMultiply(DeltaZ, DeltaZ)));
+			const VectorRegister4Float Reach = VectorAdd(VectorLoad(&Cell.Radius[Slot]), QueryRadius);
+
+			uint32 Mask = VectorMaskBits(VectorCompareLE(DistanceSquared, VectorMultiply(Reach, Reach)));
+			while (Mask != 0)
+			{
+				OutRecords.Add(EntryRecords[Cell.Entries[Slot + FMath::CountTrailingZeros(Mask)]]);
+				Mask &= Mask - 1;
+			}
+		}
+
+		for (; Slot < Num; Slot++)
+		{
+			const float DistanceSquared = FVector3f::DistSquared(FVector3f(Cell.X[Slot], Cell.Y[Slot], Cell.Z[Slot]),
+			                                                     Center);
+			if (DistanceSquared <= FMath::Square(Cell.Radius[Slot] + Radius))
+				OutRecords.Add(EntryRecords[Cell.Entries[Slot]]);
+		}
+	}
+}
@@ -0,0 +1,184 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+
+#include "StreamOperators.h"
+
+#include "LightEventSystemModule.h"
+#include "UObject/UnrealType.h"
+
+bool FLES_StreamOperators::IsEmpty() const
+{
+	return !bDistinctUntilChanged &&
+		ThrottleRate <= 0.f &&
+		ReduceOperation == ELES_ReduceOperation::None &&
+		DebounceTime <= 0.f &&
+		!bSamplePerTick;
+}
+
+namespace LES
+{
+	/** Iterates over the properties of the event class, skipping the ones common to all events. */
+	template <typename TFunc>
+	void ForEachPayloadProperty(const UClass* EventClass, TFunc&& Func)
+	{
+		for (TFieldIterator<FProperty> It(EventClass); It; ++It)
+		{
+			if (It->GetOwnerClass() != ULES_Event::StaticClass())
+				Func(*It);
+		}
+	}
+
+	FStreamOperatorState::FStreamOperatorState(const FLES_StreamOperators& InOperators, const UClass* EventClass)
+		: Operators(InOperators)
+	{
+		// Events are counted whether or not their class has a Count property to deliver the count in.
+		if (Operators.ReduceOperation == ELES_ReduceOperation::Count)
+		{
+			ReducedProperty = CastField<FNumericProperty>(EventClass->FindPropertyByName("Count"));
+		}
+		else if (Operators.ReduceOperation != ELES_ReduceOperation::None)
+		{
+			ReducedProperty = CastField<FNumericProperty>(EventClass->FindPropertyByName("Value"));
+			if (!ReducedProperty)
+			{
+				UE_LOG(LogLightEventSystem, Warning,
+				       TEXT("Events of class %s have no numeric Value property to reduce."), *EventClass->GetName());
+				Operators.ReduceOperation = ELES_ReduceOperation::None;
+			}
+		}
+	}
+
+	bool FStreamOperatorState::Receive(ULES_Event* Event, const double Time)
+	{
+		if (Operators.bDistinctUntilChanged)
+		{
+			if (IsSameAsLastEvent(Event)) return false;
+			RememberLastEvent(Event);
+		}
+
+		if (Operators.ThrottleRate > 0.f)
+		{
+			if (Time < NextThrottleTime) return false;
+			NextThrottleTime = Time + 1.0 / Operators.ThrottleRate;
+		}
+
+		if (Operators.ReduceOperation != ELES_ReduceOperation::None)
+		{
+			Accumulate(Event, Time);
+			return false;
+		}
+
+		if (Operators.DebounceTime > 0.f)
+		{
+			PendingEvent = Event;
+			PendingTime = Time + Operators.DebounceTime;
+			return false;
+		}
+
+		if (Operators.bSamplePerTick)
+		{
+			PendingEvent = Event;
+			PendingTime = Time;
+			return false;
+		}
+		return true;
+	}
+
+	ULES_Event* FStreamOperatorState::Flush(const double Time)
+	{
+		if (WindowCount > 0 && Time >= WindowEnd)
+		{
+			if (ReducedProperty)
+			{
+				const bool bCount = Operators.ReduceOperation == ELES_ReduceOperation::Count;
+				const double Value = bCount ? WindowCount : Accumulator;
+				void* ValuePtr = ReducedProperty->ContainerPtrToValuePtr<void>(AggregateEvent.Get());
+				if (ReducedProperty->IsFloatingPoint())
+					ReducedProperty->SetFloatingPointPropertyValue(ValuePtr, Value);
+				else
+					ReducedProperty->SetIntPropertyValue(ValuePtr, static_cast<int64>(Value));
+			}
+
+			WindowCount = 0;
+			return AggregateEvent;
+		}
+
+		if (PendingEvent && Time >= PendingTime)
+		{
+			ULES_Event* Event = PendingEvent.Get();
+			PendingEvent = nullptr;
+			return IsValid(Event) ? Event : nullptr;
+		}
+		return nullptr;
+	}
+
+	void FStreamOperatorState::AddReferencedObjects(FReferenceCollector& Collector)
+	{
+		Collector.AddReferencedObject(PendingEvent);
+		Collector.AddReferencedObject(LastEvent);
+		Collector.AddReferencedObject(AggregateEvent);
+	}
+
+	bool FStreamOperatorState::IsSameAsLastEvent(const ULES_Event* Event) const
+	{
+		if (!LastEvent || LastEvent->GetClass() != Event->GetClass()) return false;
+
+		bool bIdentical = true;
+		ForEachPayloadProperty(Event->GetClass(), [&](const FProperty* Property)
+		{
+			for (int32 ArrayIndex = 0; bIdentical && ArrayIndex < Property->ArrayDim; ArrayIndex++)
+				bIdentical = Property->Identical_InContainer(LastEvent.Get(), Event, ArrayIndex);
+		});
+		return bIdentical;
+	}
+
+	void FStreamOperatorState::RememberLastEvent(const ULES_Event* Event)
+	{
+		// The values are copied, because senders are allowed to reuse event objects.
+		if (!LastEvent || LastEvent->GetClass() != Event->GetClass())
+			LastEvent = NewObject<ULES_Event>(GetTransientPackage(), Event->GetClass());
+
+		ForEachPayloadProperty(Event->GetClass(), [&](const FProperty* Property)
+		{
+			Property->CopyCompleteValue_InContainer(LastEvent.Get(), Event);
+		});
+	}
+
+	void FStreamOperatorState::Accumulate(ULES_Event* Event, const double Time)
+	{
+		// Counting reads no value, and the count is written only when the window closes.
+		double Value = 0.0;
+		if (Operators.ReduceOperation != ELES_ReduceOperation::Count)
+		{
+			const void* ValuePtr = ReducedProperty->ContainerPtrToValuePtr<void>(Event);
+			Value = ReducedProperty->IsFloatingPoint()
+				        ? ReducedProperty->GetFloatingPointPropertyValue(ValuePtr)
+				        : static_cast<double>(ReducedProperty->GetSignedIntPropertyValue(ValuePtr));
+		}
+
+		if (WindowCount == 0)
+		{
+			WindowEnd = Time + Operators.ReduceWindow;
+			Accumulator = Value;
+		}
+		else if (Operators.ReduceOperation == ELES_ReduceOperation::Sum)
+		{
+			Accumulator += Value;
+		}
+		else if (Operators.ReduceOperation == ELES_ReduceOperation::Min)
+		{
+			Accumulator = FMath::Min(Accumulator, Value);
+		}
+		else if (Operators.ReduceOperation == ELES_ReduceOperation::Max)
+		{
+			Accumulator = FMath::Max(Accumulator, Value);
+		}
+		WindowCount++;
+
+		// The aggregated event carries the channel, the sender and the rest of the payload of the last received event.
+		if (!AggregateEvent || AggregateEvent->GetClass() != Event->GetClass())
+			AggregateEvent = NewObject<ULES_Event>(GetTransientPackage(), Event->GetClass());
+		for (TFieldIterator<FProperty> It(Event->GetClass()); It; ++It)
+			It->CopyCompleteValue_InContainer(AggregateEvent.Get(), Event);
+	}
+}
@@ -0,0 +1,114 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#pragma once
+
+#include "Event.h"
+#include "ObserverCallback.h"
+#include "Tasks/Task.h"
+#include "AsyncObserver.generated.h"
+
+/** Queue depth and latency of an async observer. See \a ULES_EventSystem::AddAsyncObserver. */
+USTRUCT(BlueprintType)
+struct FLES_AsyncObserverStats
+{
+	GENERATED_BODY()
+
+	/** Amount of events waiting for a task, because the observer has the maximum amount of tasks in flight. */
+	UPROPERTY(BlueprintReadOnly, Category = "Async")
+	int32 NumQueuedEvents = 0;
+
+	/** Largest amount of events that have been waiting for a task at once. */
+	UPROPERTY(BlueprintReadOnly, Category = "Async")
+	int32 PeakQueuedEvents = 0;
+
+	/** Amount of tasks running, or finished and waiting for their completion on the game thread. */
+	UPROPERTY(BlueprintReadOnly, Category = "Async")
+	int32 NumTasksInFlight = 0;
+
+	/** Amount of events whose tasks have finished and have been completed on the game thread. */
+	UPROPERTY(BlueprintReadOnly, Category = "Async")
+	int64 NumCompletedEvents = 0;
+
+	/** Average time from sending an event to its completion on the game thread, in milliseconds. */
+	UPROPERTY(BlueprintReadOnly, Category = "Async")
+	double AverageLatency = 0.0;
+
+	/** Longest time from sending an event to its completion on the game thread, in milliseconds. */
+	UPROPERTY(BlueprintReadOnly, Category = "Async")
+	double MaxLatency = 0.0;
+};
+
+namespace LES
+{
+	/**
+	 * Observer handling its events in tasks, away from the sender's thread. Each event gets its own task calling the
+	 * work handler, up to the maximum amount of tasks in flight, and the rest wait in a queue. Finished tasks are
+	 * collected on the game thread, which calls the completion handler and launches the queued events. Each task gets
+	 * its own copy of the event, kept alive for the garbage collector until it's completed.
+	 */
+	class LIGHTEVENTSYSTEM_API FAsyncObserver
+	{
+	public:
+		FAsyncObserver(FObserverCallback&& InWork, FObserverCallback&& InCompletion, const int32 InMaxTasksInFlight);
+		FAsyncObserver(const FAsyncObserver&) = delete;
+		FAsyncObserver& operator=(const FAsyncObserver&) = delete;
+
+		/** Waits for the tasks still running, since they call the work handler. */
+		~FAsyncObserver();
+
+		/**
+		 * Launches a task for a copy of the \a Event, or queues the copy if the observer has the maximum amount of
+		 * tasks in flight.
+		 */
+		void Add(ULES_Event* Event);
+
+		/**
+		 * Completes the events whose tasks have finished, calling the completion handler and then \a OnCompleted with
+		 * each of them, and launches the tasks of the queued events. Game thread only.
+		 */
+		void Flush(TFunctionRef<void(ULES_Event*)> OnCompleted);
+
+		/** Drops the queued events and stops calling the completion handler. The running tasks still finish. */
+		void Retire();
+
+		/** Returns true if there are no tasks in flight. */
+		bool IsIdle() const { return InFlight.IsEmpty(); }
+
+		/** Waits until all tasks in flight finish, without completing them. */
+		void Wait() const;
+
+		FLES_AsyncObserverStats GetStats() const;
+
+		/** Reports the queued and in-flight events to the garbage collector. */
+		void AddReferencedObjects(FReferenceCollector& Collector);
+
+	private:
+		struct FQueuedEvent
+		{
+			ULES_Event* Event = nullptr;
+			uint64 SendCycles = 0;
+		};
+
+		struct FTaskInFlight
+		{
+			ULES_Event* Event = nullptr;
+			uint64 SendCycles = 0;
+			UE::Tasks::FTask Task;
+		};
+
+		FObserverCallback Work;
+		FObserverCallback Completion;
+		int32 MaxTasksInFlight = 1;
+		bool bRetired = false;
+
+		TArray<FQueuedEvent> Queue;
+		TArray<FTaskInFlight> InFlight;
+
+		int32 PeakQueuedEvents = 0;
+		int64 NumCompletedEvents = 0;
+		double TotalLatency = 0.0;
+		double MaxLatency = 0.0;
+
+		void Launch(ULES_Event* Event, const uint64 SendCycles);
+	};
+}
@@ -0,0 +1,305 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#pragma once
+
+// This header defines the binary layout of the shared memory event bridge. It doesn't depend on the engine, so the
+// standalone reader library in Extras/LESBridge uses it as well. Bump LES::Bridge::Version on any layout change.
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+namespace LES::Bridge
+{
+	/** "LESB" in little endian. */
+	constexpr uint32_t Magic = 0x4253454C;
+	constexpr uint32_t Version = 1;
+	constexpr uint32_t RecordAlignment = 8;
+
+	/** Index of the ring in \a FRegionHeader::Rings. */
+	enum ERing : uint32_t
+	{
+		/** Events mirrored by the game, read by the tools. */
+		GameToTools = 0,
+		/** Events injected by the tools, read by the game. */
+		ToolsToGame = 1,
+	};
+
+	enum class ERecordType : uint16_t
+	{
+		/** Fills the end of the ring when the next record doesn't fit before it. Skipped by readers. */
+		Padding = 0,
+		/** Describes the fields of an event class. Appended to the schema log, which is never consumed. */
+		Schema = 1,
+		/** Event of a class described by an earlier schema record. */
+		Event = 2,
+	};
+
+	enum class EFieldKind : uint8_t
+	{
+		/** Plain old data, written as \a Size bytes copied from the event. */
+		Raw = 1,
+		/** Written as a 32-bit byte length followed by UTF-8 text. */
+		Text = 2,
+	};
+
+	/**
+	 * Single-producer/single-consumer ring. Cursors are free-running byte counters, the offset in the data is the
+	 * cursor modulo \a Capacity. Each cursor lives on its own cache line, so both ends don't fight over it.
+	 */
+	struct alignas(64) FRingHeader
+	{
+		/** Size of the ring data in bytes. A power of two. */
+		uint32_t Capacity;
+		uint32_t Reserved;
+
+		/** Offset of the ring data from the start of the region. */
+		uint64_t DataOffset;
+
+		alignas(64) std::atomic<uint64_t> WriteCursor;
+		alignas(64) std::atomic<uint64_t> ReadCursor;
+
+		/** Records the producer gave up on because the ring was full. */
+		alignas(64) std::atomic<uint64_t> NumDropped;
+	};
+
+	/**
+	 * Start of the shared memory region. It's followed by the schema log and the data of both rings. The schema log is
+	 * append-only, so tools attaching at any time can decode the events.
+	 */
+	struct alignas(64) FRegionHeader
+	{
+		uint32_t Magic;
+		uint32_t Version;
+		uint32_t HeaderSize;
+		uint32_t Reserved;
+		uint64_t RegionSize;
+
+		/** Set by the creator of the region after everything else is initialized. */
+		std::atomic<uint32_t> bReady;
+
+		uint32_t SchemaCapacity;
+		uint64_t SchemaOffset;
+
+		/** Bytes of schema records published so far. Written only by the game. */
+		std::atomic<uint32_t> SchemaSize;
+
+		FRingHeader Rings[2];
+	};
+
+	/**
+	 * Every record starts with this header, and is padded to \a RecordAlignment. Records never wrap around the end of
+	 * the ring, so their bodies can be read in place.
+	 *
+	 * Schema body: uint32 ClassId, uint16 NumFields, uint16 ClassNameLength, class path, then for each field: uint16
+	 * NameLength, uint8 Kind, uint8 Reserved, uint32 Size, name.
+	 *
+	 * Event body: uint32 ClassId, uint16 ChannelLength, uint16 Reserved, channel, then the fields in the schema order.
+	 *
+	 * Strings are UTF-8 without a terminator. Multibyte values are little endian and may be unaligned.
+	 */
+	struct FRecordHeader
+	{
+		/** Size of the record including the header and padding. */
+		uint32_t Size;
+		ERecordType Type;
+		uint16_t Reserved;
+	};
+
+	static_assert(sizeof(FRecordHeader) == RecordAlignment);
+	static_assert(std::atomic<uint64_t>::is_always_lock_free);
+
+	constexpr uint64_t Align(const uint64_t Value)
+	{
+		return (Value + RecordAlignment - 1) & ~static_cast<uint64_t>(RecordAlignment - 1);
+	}
+
+	/** Size of the region holding the schema log and both rings. */
+	constexpr uint64_t GetRegionSize(const uint32_t Capacity, const uint32_t SchemaCapacity)
+	{
+		return sizeof(FRegionHeader) + Align(SchemaCapacity) + 2 * static_cast<uint64_t>(Capacity);
+	}
+
+	/** Initializes the region header. \a Capacity must be a power of two, at least 64 bytes. */
+	inline void InitializeRegion(void* Region, const uint32_t Capacity, const uint32_t SchemaCapacity)
+	{
+		FRegionHeader* Header = new(Region) FRegionHeader();
+		Header->Magic = Magic;
+		Header->Version = Version;
+		Header->HeaderSize = sizeof(FRegionHeader);
+		Header->RegionSize = GetRegionSize(Capacity, SchemaCapacity);
+		Header->SchemaCapacity = static_cast<uint32_t>(Align(SchemaCapacity));
+		Header->SchemaOffset = sizeof(FRegionHeader);
+		for (uint32_t Index = 0; Index < 2; Index++)
+		{
+			Header->Rings[Index].Capacity = Capacity;
+			Header->Rings[Index].DataOffset =
+				Header->SchemaOffset + Header->SchemaCapacity + Index * static_cast<uint64_t>(Capacity);
+		}
+		Header->bReady.store(1, std::memory_order_release);
+	}
+
+	/** Appends a schema record with the \a Body to the schema log. Returns false if the log is full. */
+	inline bool AppendSchema(FRegionHeader* Header, const uint8_t* Body, const uint32_t BodySize)
+	{
+		const uint32_t Size = Header->SchemaSize.load(std::memory_order_relaxed);
+		const uint64_t RecordSize = Align(sizeof(FRecordHeader) + static_cast<uint64_t>(BodySize));
+		if (Size + RecordSize > Header->SchemaCapacity) return false;
+
+		uint8_t* Record = reinterpret_cast<uint8_t*>(Header) + Header->SchemaOffset + Size;
+		const FRecordHeader RecordHeader{static_cast<uint32_t>(RecordSize), ERecordType::Schema, 0};
+		std::memcpy(Record, &RecordHeader, sizeof(RecordHeader));
+		std::memcpy(Record + sizeof(RecordHeader), Body, BodySize);
+		Header->SchemaSize.store(static_cast<uint32_t>(Size + RecordSize), std::memory_order_release);
+		return true;
+	}
+
+	/** Calls \a Func with the body and body size of each schema record published so far. */
+	template <typename TFunc>
+	void ForEachSchema(const FRegionHeader* Header, TFunc&& Func)
+	{
+		const uint32_t Size = Header->SchemaSize.load(std::memory_order_acquire);
+		const uint8_t* Log = reinterpret_cast<const uint8_t*>(Header) + Header->SchemaOffset;
+		for (uint32_t Offset = 0; Offset + sizeof(FRecordHeader) <= Size;)
+		{
+			FRecordHeader RecordHeader;
+			std::memcpy(&RecordHeader, Log + Offset, sizeof(RecordHeader));
+			if (RecordHeader.Size < sizeof(FRecordHeader) || Offset + RecordHeader.Size > Size) return;
+			Func(Log + Offset + sizeof(FRecordHeader), RecordHeader.Size - static_cast<uint32_t>(sizeof(FRecordHeader)));
+			Offset += RecordHeader.Size;
+		}
+	}
+
+	/** Returns the region header if the region is initialized and has a compatible layout, or nullptr otherwise. */
+	inline FRegionHeader* GetRegionHeader(void* Region, const uint64_t MappedSize)
+	{
+		FRegionHeader* Header = static_cast<FRegionHeader*>(Region);
+		if (!Header || MappedSize < sizeof(FRegionHeader) || !Header->bReady.load(std::memory_order_acquire))
+			return nullptr;
+		if (Header->Magic != Magic || Header->Version != Version || Header->HeaderSize != sizeof(FRegionHeader) ||
+			Header->RegionSize > MappedSize)
+			return nullptr;
+		return Header;
+	}
+
+	/** Producer end of a ring. Writing a record takes a \a BeginWrite, filling the body, and an \a EndWrite. */
+	class FRingWriter
+	{
+	public:
+		FRingWriter() = default;
+
+		FRingWriter(FRegionHeader* Region, const ERing Ring)
+			: Header(&Region->Rings[Ring]),
+			  Data(reinterpret_cast<uint8_t*>(Region) + Region->Rings[Ring].DataOffset)
+		{
+		}
+
+		/**
+		 * Reserves a record with a body of \a BodySize bytes. Returns the body to fill, or nullptr if the ring is full,
+		 * in which case the record is counted as dropped.
+		 */
+		uint8_t* BeginWrite(const ERecordType Type, const uint32_t BodySize)
+		{
+			const uint64_t Capacity = Header->Capacity;
+			const uint64_t RecordSize = Align(sizeof(FRecordHeader) + static_cast<uint64_t>(BodySize));
+			uint64_t Cursor = Header->WriteCursor.load(std::memory_order_relaxed);
+			const uint64_t ReadCursor = Header->ReadCursor.load(std::memory_order_acquire);
+			uint64_t Offset = Cursor & (Capacity - 1);
+			const uint64_t PaddingSize = Offset + RecordSize > Capacity ? Capacity - Offset : 0;
+
+			if (RecordSize > Capacity / 2 || Cursor + PaddingSize + RecordSize - ReadCursor > Capacity)
+			{
+				Header->NumDropped.fetch_add(1, std::memory_order_relaxed);
+				return nullptr;
+			}
+
+			if (PaddingSize > 0)
+			{
+				WriteHeader(Offset, ERecordType::Padding, PaddingSize);
+				Cursor += PaddingSize;
+				Offset = 0;
+			}
+			WriteHeader(Offset, Type, RecordSize);
+			PendingCursor = Cursor + RecordSize;
+			return Data + Offset + sizeof(FRecordHeader);
+		}
+
+		/** Publishes the record reserved by the last \a BeginWrite. */
+		void EndWrite()
+		{
+			Header->WriteCursor.store(PendingCursor, std::memory_order_release);
+		}
+
+		bool IsValid() const { return Header != nullptr; }
+
+	private:
+		FRingHeader* Header = nullptr;
+		uint8_t* Data = nullptr;
+		uint64_t PendingCursor = 0;
+
+		void WriteHeader(const uint64_t Offset, const ERecordType Type, const uint64_t Size) const
+		{
+			const FRecordHeader RecordHeader{static_cast<uint32_t>(Size), Type, 0};
+			std::memcpy(Data + Offset, &RecordHeader, sizeof(RecordHeader));
+		}
+	};
+
+	/** Consumer end of a ring. Reading a record takes a \a Peek, reading the body, and a \a Pop. */
+	class FRingReader
+	{
+	public:
+		FRingReader() = default;
+
+		FRingReader(FRegionHeader* Region, const ERing Ring)
+			: Header(&Region->Rings[Ring]),
+			  Data(reinterpret_cast<const uint8_t*>(Region) + Region->Rings[Ring].DataOffset)
+		{
+		}
+
+		/**
+		 * Returns the header of the next record and sets \a OutBody to its body, or returns false if the ring is empty
+		 * or corrupted. Padding records are skipped.
+		 */
+		bool Peek(FRecordHeader& OutHeader, const uint8_t*& OutBody, uint32_t& OutBodySize)
+		{
+			const uint64_t Capacity = Header->Capacity;
+			uint64_t Cursor = Header->ReadCursor.load(std::memory_order_relaxed);
+			const uint64_t WriteCursor = Header->WriteCursor.load(std::memory_order_acquire);
+			while (Cursor != WriteCursor)
+			{
+				const uint64_t Offset = Cursor & (Capacity - 1);
+				std::memcpy(&OutHeader, Data + Offset, sizeof(OutHeader));
+				if (OutHeader.Size < sizeof(FRecordHeader) || OutHeader.Size % RecordAlignment != 0 ||
+					Offset + OutHeader.Size > Capacity || Cursor + OutHeader.Size > WriteCursor)
+					return false;
+
+				if (OutHeader.Type == ERecordType::Padding)
+				{
+					Cursor += OutHeader.Size;
+					Header->ReadCursor.store(Cursor, std::memory_order_release);
+					continue;
+				}
+
+				PendingCursor = Cursor + OutHeader.Size;
+				OutBody = Data + Offset + sizeof(FRecordHeader);
+				OutBodySize = OutHeader.Size - static_cast<uint32_t>(sizeof(FRecordHeader));
+				return true;
+			}
+			return false;
+		}
+
+		/** Releases the record returned by the last \a Peek, so the producer can reuse its memory. */
+		void Pop()
+		{
+			Header->ReadCursor.store(PendingCursor, std::memory_order_release);
+		}
+
+		bool IsValid() const { return Header != nullptr; }
+
+	private:
+		FRingHeader* Header = nullptr;
+		const uint8_t* Data = nullptr;
+		uint64_t PendingCursor = 0;
+	};
+}
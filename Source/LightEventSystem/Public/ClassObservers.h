@@ -0,0 +1,106 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#pragma once
+
+#include "UObject/UObjectArray.h"
+#include "UObject/WeakObjectPtr.h"
+
+namespace LES
+{
+	/**
+	 * Live instances of an observer class subscribed to events, including the instances of its subclasses, kept in a
+	 * dense array so that the dispatch calls them in one loop. Maintained by \a FClassInstances. Objects are reported
+	 * before their constructor runs, so they wait in a pending list until they're fully constructed and loaded.
+	 */
+	class LIGHTEVENTSYSTEM_API FInstanceList
+	{
+	public:
+		explicit FInstanceList(FCriticalSection& InCriticalSection) : CriticalSection(InCriticalSection)
+		{
+		}
+
+		/**
+		 * Calls the \a Function for every instance that isn't marked as garbage. Instances created by the \a Function
+		 * are skipped. Call it only on the game thread. The instances are copied under the lock of the instance lists,
+		 * and the \a Function is called after releasing it, so the objects created on other threads in the meantime
+		 * don't wait for the loop. The copies are weak, since the \a Function may destroy the other instances.
+		 */
+		template <typename TFunction>
+		void ForEach(TFunction Function) const
+		{
+			// Nested loops append their copies after the outer ones.
+			const int32 FirstInstance = Snapshot.Num();
+			TakeSnapshot();
+			const int32 LastInstance = Snapshot.Num();
+			for (int32 Index = FirstInstance; Index < LastInstance; Index++)
+			{
+				if (UObject* Instance = Snapshot[Index].Get())
+					Function(Instance);
+			}
+			Snapshot.SetNum(FirstInstance, EAllowShrinking::No);
+		}
+
+		/** Returns the amount of tracked instances, including the ones marked as garbage or still being constructed. */
+		int32 Num() const;
+
+	private:
+		friend class FClassInstances;
+
+		FCriticalSection& CriticalSection;
+		mutable TArray<UObject*> Instances;
+
+		/**
+		 * Position of each instance in \a Instances, or of each pending object in \a PendingInstances encoded by
+		 * \a EncodePending, so that the destroyed ones are swapped out in constant time.
+		 */
+		mutable TMap<const UObjectBase*, int32> Indices;
+
+		/** Reported objects that may still be under construction or waiting to be loaded. */
+		mutable TArray<UObject*> PendingInstances;
+
+		/** Copies of the instances of the running loops. Used only on the game thread. */
+		mutable TArray<FWeakObjectPtr> Snapshot;
+
+		/** Encodes the position of a pending object in \a Indices, and decodes it back. */
+		static constexpr int32 EncodePending(int32 Index) { return -1 - Index; }
+
+		void Add(UObject* Instance);
+		void Remove(const UObjectBase* Instance);
+
+		/** Moves the pending objects that are ready into \a Instances, and appends the instances to \a Snapshot. */
+		void TakeSnapshot() const;
+	};
+
+	/**
+	 * Tracks the live instances of the observer classes with class-level subscriptions. Listens for the creation and
+	 * destruction of all objects while any class is tracked. Class default objects and archetypes aren't tracked.
+	 */
+	class LIGHTEVENTSYSTEM_API FClassInstances : public FUObjectArray::FUObjectCreateListener,
+	                                             public FUObjectArray::FUObjectDeleteListener
+	{
+	public:
+		FClassInstances() = default;
+		FClassInstances(const FClassInstances&) = delete;
+		FClassInstances& operator=(const FClassInstances&) = delete;
+		virtual ~FClassInstances() override;
+
+		/**
+		 * Returns the list of the instances of the \a Class, starting to track it if it's not tracked yet. The list is
+		 * filled with the existing instances, and has a stable address until the class is destroyed.
+		 */
+		FInstanceList& FindOrAdd(UClass* Class);
+
+		virtual void NotifyUObjectCreated(const UObjectBase* Object, int32 Index) override;
+		virtual void NotifyUObjectDeleted(const UObjectBase* Object, int32 Index) override;
+		virtual void OnUObjectArrayShutdown() override;
+
+	private:
+		/** Objects may be created and destroyed on any thread, so the lists are only accessed under this lock. */
+		mutable FCriticalSection CriticalSection;
+
+		TArray<TPair<const UClass*, TUniquePtr<FInstanceList>>> Lists;
+		bool bListening = false;
+
+		void StopListening();
+	};
+}
@@ -0,0 +1,151 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#pragma once
+
+#include "ObserverCallback.h"
+#include "Async/Mutex.h"
+#include "UObject/ObjectKey.h"
+#include <atomic>
+
+namespace LES
+{
+	/**
+	 * Epoch-based reclamation of the objects shared with lock-free readers. Readers announce the epoch they started in,
+	 * and the writers free a retired object only once every reader that could still see it has finished. Readers never
+	 * block, unless more than \a MaxReaders of them read at once, in which case they spin until a slot is free.
+	 */
+	class LIGHTEVENTSYSTEM_API FEpochReclaimer
+	{
+	public:
+		static constexpr int32 MaxReaders = 64;
+
+		FEpochReclaimer() = default;
+		FEpochReclaimer(const FEpochReclaimer&) = delete;
+		FEpochReclaimer& operator=(const FEpochReclaimer&) = delete;
+
+		/** Frees all retired objects. There may be no readers left. */
+		~FEpochReclaimer();
+
+		/** Marks the calling thread as reading. Returns the slot to pass to \a ExitRead. Reentrant. */
+		int32 EnterRead();
+		void ExitRead(const int32 Slot);
+
+		/**
+		 * Frees the \a Object once no reader may see it anymore. The object has to be unreachable for the new readers
+		 * already. Writers only.
+		 */
+		template <typename T>
+		void Retire(const T* Object)
+		{
+			Retire(const_cast<T*>(Object), [](void* Pointer) { delete static_cast<T*>(Pointer); });
+		}
+
+		/** Frees the retired objects no reader may see anymore. Writers only. Returns the amount of objects freed. */
+		int32 Reclaim();
+
+		/** Returns the amount of retired objects waiting to be freed. Writers only. */
+		int32 GetNumRetired() const { return Retired.Num(); }
+
+	private:
+		struct alignas(64) FReaderSlot
+		{
+			/** Epoch the reader started in, or 0 if the slot is free. */
+			std::atomic<uint64> Epoch = 0;
+		};
+
+		struct FRetiredObject
+		{
+			uint64 Epoch = 0;
+			void* Object = nullptr;
+			void (*Deleter)(void*) = nullptr;
+		};
+
+		FReaderSlot ReaderSlots[MaxReaders];
+		alignas(64) std::atomic<uint64> GlobalEpoch = 1;
+		TArray<FRetiredObject> Retired;
+
+		void Retire(void* Object, void (*Deleter)(void*));
+	};
+
+	/** Keeps the calling thread marked as reading while in scope. */
+	class FEpochReadScope
+	{
+	public:
+		explicit FEpochReadScope(FEpochReclaimer& InReclaimer) : Reclaimer(InReclaimer), Slot(InReclaimer.EnterRead())
+		{
+		}
+
+		~FEpochReadScope() { Reclaimer.ExitRead(Slot); }
+
+	private:
+		FEpochReclaimer& Reclaimer;
+		int32 Slot;
+	};
+
+	/**
+	 * Observers receiving the events sent from any thread. Each event class and channel has an immutable list of
+	 * observers, replaced as a whole with an atomic pointer swap when an observer is added or removed, in the manner of
+	 * read-copy-update. The dispatch never takes a lock. Writers are serialized by a lightweight mutex, and the
+	 * replaced lists and removed observers are freed by the \a FEpochReclaimer once no dispatch may see them.
+	 */
+	class LIGHTEVENTSYSTEM_API FConcurrentDispatcher
+	{
+	public:
+		FConcurrentDispatcher() = default;
+		FConcurrentDispatcher(const FConcurrentDispatcher&) = delete;
+		FConcurrentDispatcher& operator=(const FConcurrentDispatcher&) = delete;
+		~FConcurrentDispatcher();
+
+		/** Adds the observer with the \a Callback, identified by the \a Id, e.g. the index of its observer record. */
+		void Add(const int32 Id, const UClass* EventClass, const FName Channel, FObserverCallback&& Callback);
+
+		/**
+		 * Removes the observer with the \a Id. Dispatches running on other threads may still call it until they
+		 * finish. Returns false if there's no such observer.
+		 */
+		bool Remove(const int32 Id);
+
+		/** Calls the observers listening for the \a Event's exact class on its channel. Safe on any thread. */
+		void Dispatch(ULES_Event* Event) const;
+
+		/** Frees the lists and observers no dispatch may see anymore. */
+		void Reclaim();
+
+		/** Returns the amount of observers. */
+		int32 Num() const;
+
+	private:
+		using FKey = TPair<FObjectKey, FName>;
+
+		struct FObserver
+		{
+			FObserverCallback Callback;
+		};
+
+		struct FObserverList
+		{
+			TArray<const FObserver*> Observers;
+		};
+
+		struct FBucket
+		{
+			std::atomic<const FObserverList*> List = nullptr;
+		};
+
+		/** Buckets by their key. Replaced as a whole when a bucket is added, which is rare. */
+		using FDirectory = TMap<FKey, FBucket*>;
+
+		std::atomic<const FDirectory*> Directory = nullptr;
+		mutable FEpochReclaimer Reclaimer;
+
+		/** State of the writers, guarded by the \a WriterLock. */
+		mutable UE::FMutex WriterLock;
+		TArray<TUniquePtr<FBucket>> Buckets;
+		TMap<int32, TPair<FBucket*, const FObserver*>> ObserversById;
+
+		/** Publishes a copy of the \a Bucket's list changed by the \a Edit, and retires the previous list. */
+		void ReplaceList(FBucket& Bucket, TFunctionRef<void(TArray<const FObserver*>& Observers)> Edit);
+
+		FBucket& FindOrAddBucket(const FKey& Key);
+	};
+}
@@ -0,0 +1,60 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#pragma once
+
+#include "Event.h"
+#include "UObject/ObjectKey.h"
+#include "ConflatedEvents.generated.h"
+
+/** Determines when the Event System dispatches the conflated events. */
+UENUM(BlueprintType)
+enum class ELES_ConflationFlushPoint : uint8
+{
+	/** Conflated events are dispatched at the beginning of the Event System's tick. */
+	Tick,
+	/** Conflated events are dispatched at the end of the engine frame. */
+	EndOfFrame,
+	/** Conflated events are dispatched only when \a FlushConflatedEvents is called. */
+	Manual,
+};
+
+/** Counters describing how effective the conflation of events is. */
+USTRUCT(BlueprintType)
+struct FLES_ConflationStats
+{
+	GENERATED_BODY()
+
+	/** Amount of calls to \a SendEventConflated. */
+	UPROPERTY(BlueprintReadOnly, Category = "Conflation")
+	int64 NumSends = 0;
+
+	/** Amount of sends that replaced an event still waiting to be dispatched. */
+	UPROPERTY(BlueprintReadOnly, Category = "Conflation")
+	int64 NumMerged = 0;
+
+	/** Amount of conflated events that were actually dispatched. */
+	UPROPERTY(BlueprintReadOnly, Category = "Conflation")
+	int64 NumDispatched = 0;
+};
+
+namespace LES
+{
+	/** Identifies the events that replace each other when conflated: same class, channel and sender. */
+	struct FConflationKey
+	{
+		const UClass* EventClass = nullptr;
+		FName Channel = NAME_None;
+		FObjectKey Sender;
+
+		bool operator==(const FConflationKey& Other) const
+		{
+			return EventClass == Other.EventClass && Channel == Other.Channel && Sender == Other.Sender;
+		}
+
+		friend uint32 GetTypeHash(const FConflationKey& Key)
+		{
+			return HashCombineFast(HashCombineFast(GetTypeHash(Key.EventClass), GetTypeHash(Key.Channel)),
+			                       GetTypeHash(Key.Sender));
+		}
+	};
+}
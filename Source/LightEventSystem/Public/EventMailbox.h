@@ -0,0 +1,56 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#pragma once
+
+#include "Event.h"
+
+namespace LES
+{
+	/** Handler of a batch of events, all of the class the observer listens for. */
+	using FBatchCallback = TFunction<void(TArrayView<ULES_Event* const>)>;
+
+	/**
+	 * Events collected for an observer record receiving them in batches. The events wait in the mailbox until it's
+	 * flushed, either when the Event System is ticked or when it fills up, and the handler is called once with all of
+	 * them. The mailbox is double-buffered, so the handler may send events to its own observer while it runs, and the
+	 * buffers are reused between the flushes.
+	 */
+	class LIGHTEVENTSYSTEM_API FEventMailbox
+	{
+	public:
+		FEventMailbox(FBatchCallback&& InCallback, const int32 InMaxBatchSize);
+
+		/** Adds the \a Event. Returns true if the mailbox became full and should be flushed right away. */
+		bool Add(ULES_Event* Event);
+
+		/** Returns true if there are events waiting, and the mailbox isn't being flushed already. */
+		bool CanFlush() const { return !Events.IsEmpty() && FlushedEvents.IsEmpty(); }
+
+		/**
+		 * Moves the waiting events out of the mailbox and returns the valid ones. The events added until \a EndFlush
+		 * wait for the next flush.
+		 */
+		TArrayView<ULES_Event* const> BeginFlush();
+
+		/** Clears the events returned by \a BeginFlush, keeping the memory. */
+		void EndFlush();
+
+		/** Calls the handler with the \a Batch. */
+		void Invoke(const TArrayView<ULES_Event* const> Batch) const { Callback(Batch); }
+
+		/** Returns the amount of events waiting in the mailbox. */
+		int32 Num() const { return Events.Num(); }
+
+		/** Reports the collected events to the garbage collector. */
+		void AddReferencedObjects(FReferenceCollector& Collector);
+
+	private:
+		FBatchCallback Callback;
+
+		/** Amount of events flushing the mailbox as soon as they're collected. 0 if it's flushed only on ticks. */
+		int32 MaxBatchSize = 0;
+
+		TArray<ULES_Event*> Events;
+		TArray<ULES_Event*> FlushedEvents;
+	};
+}
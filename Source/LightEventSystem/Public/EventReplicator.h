@@ -0,0 +1,84 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#pragma once
+
+#include "EventSystem.h"
+#include "ReplicationCodec.h"
+#include "Serialization/BitWriter.h"
+#include "EventReplicator.generated.h"
+
+/**
+ * Replicates events between Event Systems. On the sending end, events sent on the replicated classes and channels are
+ * encoded into a single bitstream, which is handed to \a OnPacketReady once per frame, or when \a Flush is called. On
+ * the receiving end, \a ReceivePacket decodes the events and sends them on the Event System.
+ *
+ * The transport is up to the user, for example a single reliable RPC with the packet bytes. Both ends must share the
+ * same \a LES::FReplicationTable contents. Use \a ConnectLoopback to connect two replicators in the same process.
+ */
+UCLASS()
+class LIGHTEVENTSYSTEM_API ULES_EventReplicator : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	DECLARE_DELEGATE_TwoParams(FOnPacketReady, const TArray<uint8>& /* Data */, int64 /* NumBits */);
+
+	/** Sets the Event System the events are replicated from and to, and the table shared with the other end. */
+	void Initialize(ULES_EventSystem* InEventSystem, const TSharedRef<const LES::FReplicationTable>& InTable);
+
+	/**
+	 * Starts replicating the events of the \a EventClass sent on the \a Channel. Both need to be in the table. Returns
+	 * false if they aren't, or the replicator isn't initialized.
+	 */
+	bool StartReplicating(const TSubclassOf<ULES_Event>& EventClass, const FName Channel = NAME_None);
+
+	/**
+	 * Encodes the \a Event into the packet of the current frame. Returns false if it couldn't be encoded, or if it was
+	 * received from the other end.
+	 */
+	bool QueueEvent(ULES_Event* Event);
+
+	/** Hands the packet with the queued events to \a OnPacketReady. Does nothing if no events are queued. */
+	void Flush();
+
+	/** Decodes the events from the packet and sends them on the Event System. Returns false if the packet is corrupted. */
+	bool ReceivePacket(const TArray<uint8>& Data, const int64 NumBits);
+
+	/** Makes the packets of this replicator be received by the \a Receiver right away, without a network. */
+	void ConnectLoopback(ULES_EventReplicator* Receiver);
+
+	/** Called with each packet to be sent to the other end. */
+	FOnPacketReady OnPacketReady;
+
+	/** If true, queued events are flushed at the end of each engine frame. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Replication")
+	bool bFlushAtEndOfFrame = true;
+
+	/** Amount of events encoded so far. */
+	UPROPERTY(BlueprintReadOnly, Category = "Replication")
+	int64 NumEventsSent = 0;
+
+	/** Amount of packets handed to \a OnPacketReady so far. */
+	UPROPERTY(BlueprintReadOnly, Category = "Replication")
+	int64 NumPacketsSent = 0;
+
+	/** Total size of the packets handed to \a OnPacketReady so far, in bits. */
+	UPROPERTY(BlueprintReadOnly, Category = "Replication")
+	int64 NumBitsSent = 0;
+
+	/** Amount of events decoded so far. */
+	UPROPERTY(BlueprintReadOnly, Category = "Replication")
+	int64 NumEventsReceived = 0;
+
+	virtual void BeginDestroy() override;
+
+private:
+	UPROPERTY(Transient)
+	TObjectPtr<ULES_EventSystem> EventSystem;
+
+	TSharedPtr<const LES::FReplicationTable> Table;
+	TUniquePtr<LES::FEventPacketCodec> OutgoingCodec;
+	TUniquePtr<LES::FEventPacketCodec> IncomingCodec;
+	FBitWriter PacketWriter{0, true};
+	FDelegateHandle EndOfFrameHandle;
+};
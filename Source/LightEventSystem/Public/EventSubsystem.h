@@ -3,12 +3,13 @@
 #pragma once
 
 #include "Subsystems/GameInstanceSubsystem.h"
+#include "Tickable.h"
 #include "EventSubsystem.generated.h"
 
 class ULES_EventSystem;
 
 UCLASS()
-class LIGHTEVENTSYSTEM_API ULES_EventSubsystem : public UGameInstanceSubsystem
+class LIGHTEVENTSYSTEM_API ULES_EventSubsystem : public UGameInstanceSubsystem, public FTickableGameObject
 {
 	GENERATED_BODY()
 
@@ -16,11 +17,19 @@ public:
 	UPROPERTY(BlueprintReadWrite, Transient, Category = "Event Subsystem")
 	TObjectPtr<ULES_EventSystem> EventSystem;
 	
+	/** Creates the global Event System with the capacity configured in \a ULES_EventSystemSettings. */
 	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
 
 	UFUNCTION(
 		BlueprintPure,
 		Meta = (WorldContext = "WorldContextObject", CompactNodeTitle = "Global Event System"),
 		Category = "Event Subsystem")
 	static ULES_EventSystem* GetGlobalEventSystem(const UObject* WorldContextObject);
+
+	/** FTickableGameObject implementation. Ticks the global Event System, so that scheduled events are sent. */
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
 };
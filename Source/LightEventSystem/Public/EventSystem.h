@@ -2,9 +2,20 @@
 
 #pragma once
 
-#include "ObserverHandle.h"
+#include "ClassObservers.h"
+#include "ConcurrentDispatch.h"
+#include "ConflatedEvents.h"
+#include "MemoryReport.h"
+#include "NativeChannel.h"
+#include "ObserverPool.h"
+#include "QueryResult.h"
+#include "ScheduledEvents.h"
+#include "SendReport.h"
+#include "SendToken.h"
+#include "SpatialEvents.h"
+#include "WatchdogStats.h"
 #include "Templates/SubclassOf.h"
-#include "UObject/StrongObjectPtr.h"
+#include "UObject/ObjectKey.h"
 #include "EventSystem.generated.h"
 
 DECLARE_DYNAMIC_DELEGATE_OneParam(FLES_EventHandler, ULES_Event*, Event);
@@ -24,6 +35,21 @@ namespace LES
 	{
 		Callback(Event);
 	};
+
+	/** Constrains the \a Callback to be a method of the \a Observer taking a view of \a TEvent pointers. */
+	template <typename TObserver, typename TCallback, typename TEvent>
+	concept IsMethodBatchHandler = requires(TObserver Observer, TCallback Callback,
+	                                        TArrayView<const TEvent* const> Batch)
+	{
+		(Observer.*Callback)(Batch);
+	};
+
+	/** Constrains the \a Callback to be a callable taking a view of \a TEvent pointers. */
+	template <typename TCallback, typename TEvent>
+	concept IsFunctorBatchHandler = requires(TCallback Callback, TArrayView<const TEvent* const> Batch)
+	{
+		Callback(Batch);
+	};
 }
 
 /**
@@ -60,6 +86,9 @@ public:
 	 * @param Callback The event handler that will be called when the event is received.
 	 * @param Channel Determines the channel the event will be sent on. Observers are notified only about the events
 	 * sent on the channel they're listening on.
+	 * @param Operators Stream operators, like debounce or throttle, evaluated before the \a Callback is called.
+	 * @param Group Observer group the record belongs to. Whole groups may be suspended and resumed at once, see
+	 * \a SuspendGroup.
 	 * @return A handle to the newly created observer record in the Event System. You may use this handle later to
 	 * remove this particular observer record from the Event System.
 	 */
@@ -68,7 +97,8 @@ public:
 		TIsDerivedFrom<TEvent, ULES_Event>::Value &&
 		!TIsSame<TEvent, ULES_Event>::Value &&
 		LES::IsMethodEventHandler<TObserver, TCallback, TEvent>
-	FLES_ObserverHandle AddObserver(TObserver* Observer, TCallback Callback, const FName Channel = NAME_None);
+	FLES_ObserverHandle AddObserver(TObserver* Observer, TCallback Callback, const FName Channel = NAME_None,
+	                                const FLES_StreamOperators& Operators = {}, const FName Group = NAME_None);
 
 	/**
 	 * Adds the \a Observer to the Event System and marks it as listening for events of \a TEvent type, that are sent on
@@ -90,6 +120,9 @@ public:
 	 * @param Callback The event handler that will be called when the event is received.
 	 * @param Channel Determines the channel the event will be sent on. Observers are notified only about the events
 	 * sent on the channel they're listening on.
+	 * @param Operators Stream operators, like debounce or throttle, evaluated before the \a Callback is called.
+	 * @param Group Observer group the record belongs to. Whole groups may be suspended and resumed at once, see
+	 * \a SuspendGroup.
 	 * @return A handle to the newly created observer record in the Event System. You may use this handle later to
 	 * remove this particular observer record from the Event System.
 	 */
@@ -98,7 +131,241 @@ public:
 		TIsDerivedFrom<TEvent, ULES_Event>::Value &&
 		!TIsSame<TEvent, ULES_Event>::Value &&
 		LES::IsFunctorEventHandler<TCallback, TEvent>
-	FLES_ObserverHandle AddObserver(TObserver* Observer, TCallback Callback, const FName Channel = NAME_None);
+	FLES_ObserverHandle AddObserver(TObserver* Observer, TCallback Callback, const FName Channel = NAME_None,
+	                                const FLES_StreamOperators& Operators = {}, const FName Group = NAME_None);
+
+	/**
+	 * Adds the \a Observer to the Event System and marks it as listening for events of \a TEvent type, that are sent on
+	 * the specified \a Channel, received in batches. The events are collected in the observer's mailbox, and the
+	 * \a Callback is called once with all of them when the Event System is ticked, or as soon as \a MaxBatchSize events
+	 * have been collected. Use it for observers that do their work best over many events at once. Example usage:
+	 *
+	 * EventSystem->AddBatchObserver<UMyEvent>(Minimap, &UMinimap::OnMyEvents, "Some channel", 64);\n
+	 *
+	 * UMinimap should have a handler method defined like follows:\n
+	 * void UMinimap::OnMyEvents(TArrayView<const UMyEvent* const> Events)\n
+	 * {\n
+	 *		// Your code handling the events, in the order they were sent.\n
+	 * }
+	 *
+	 * The \a BeforeReceive hook is called when an event is collected, and the \a AfterReceive hook after the batch has
+	 * been handled. Events sent by the \a Callback to its own observer wait for the next batch. Collected events are
+	 * kept alive until they're handled, and are dropped if the observer record is removed first.
+	 *
+	 * @tparam TEvent The type of the events you want the \a Observer to listen for. You should explicitly specify this
+	 * type, like in the example above.
+	 * @tparam TObserver The type of the \a Observer object.
+	 * @tparam TCallback The type of the \a Callback method.
+	 * @param Observer The object that will be notified when events of \a TEvent type are sent on the \a Channel.
+	 * @param Callback The batch handler that will be called with the collected events.
+	 * @param Channel Determines the channel the events will be sent on.
+	 * @param MaxBatchSize If positive, the batch is handled as soon as this many events have been collected. Otherwise
+	 * the batches are handled only when the Event System is ticked.
+	 * @param Group Observer group the record belongs to. The mailboxes of suspended groups are flushed after they're
+	 * resumed. See \a SuspendGroup.
+	 * @return A handle to the newly created observer record in the Event System.
+	 */
+	template <typename TEvent, typename TObserver, typename TCallback>
+		requires TIsDerivedFrom<TObserver, UObject>::Value &&
+		TIsDerivedFrom<TEvent, ULES_Event>::Value &&
+		!TIsSame<TEvent, ULES_Event>::Value &&
+		LES::IsMethodBatchHandler<TObserver, TCallback, TEvent>
+	FLES_ObserverHandle AddBatchObserver(TObserver* Observer, TCallback Callback, const FName Channel = NAME_None,
+	                                     const int32 MaxBatchSize = 0, const FName Group = NAME_None);
+
+	/**
+	 * Version of \a AddBatchObserver taking a callable \a Callback, like a lambda with a
+	 * TArrayView<const UMyEvent* const> parameter.
+	 */
+	template <typename TEvent, typename TObserver, typename TCallback>
+		requires TIsDerivedFrom<TObserver, UObject>::Value &&
+		TIsDerivedFrom<TEvent, ULES_Event>::Value &&
+		!TIsSame<TEvent, ULES_Event>::Value &&
+		LES::IsFunctorBatchHandler<TCallback, TEvent>
+	FLES_ObserverHandle AddBatchObserver(TObserver* Observer, TCallback Callback, const FName Channel = NAME_None,
+	                                     const int32 MaxBatchSize = 0, const FName Group = NAME_None);
+
+	/**
+	 * Adds the \a Observer with a thread-safe \a Callback, receiving the events of \a TEvent type sent on the
+	 * \a Channel both with \a SendEvent and with \a SendEventConcurrent, from any thread. The \a Callback has to be
+	 * safe to call on several threads at once. After the record is removed, the sends running on other threads may
+	 * still call it until they finish. The sends don't block the garbage collection, so the \a Callback mustn't
+	 * dereference the \a Observer or other objects it may destroy, only the event and data it owns or shares safely.
+	 *
+	 * Concurrent observers can't have stream operators, spatial filters or a group, and the receive hooks run only
+	 * for the events sent with \a SendEvent.
+	 *
+	 * @return A handle to the newly created observer record in the Event System.
+	 */
+	template <typename TEvent, typename TObserver, typename TCallback>
+		requires TIsDerivedFrom<TObserver, UObject>::Value &&
+		TIsDerivedFrom<TEvent, ULES_Event>::Value &&
+		!TIsSame<TEvent, ULES_Event>::Value &&
+		LES::IsFunctorEventHandler<TCallback, TEvent>
+	FLES_ObserverHandle AddConcurrentObserver(TObserver* Observer, TCallback Callback, const FName Channel = NAME_None);
+
+	/**
+	 * Sends the \a Event to the observers added with \a AddConcurrentObserver. Safe to call from any thread, also from
+	 * several threads at once, and never takes a lock: each event class and channel has an immutable list of
+	 * concurrent observers, replaced atomically by the writers. Observers added with \a AddObserver don't receive the
+	 * event, and the send and receive hooks aren't called, since they're not thread-safe.
+	 *
+	 * @param Event Event object that will be sent. It shouldn't be modified until all threads sending it are done.
+	 */
+	void SendEventConcurrent(ULES_Event* Event) const;
+
+	/**
+	 * Subscribes every live instance of the \a TObserver class, including the instances of its subclasses, to the
+	 * events of \a TEvent type sent on the \a Channel. Use it instead of adding each instance with \a AddObserver when
+	 * all of them listen the same way. Example usage:
+	 *
+	 * EventSystem->AddClassObserver<UAlertRaised, AEnemy>(&AEnemy::OnAlertRaised, "Alerts");\n
+	 *
+	 * The subscription is a single observer record, so spawning and destroying the instances costs nothing in the
+	 * buckets. The Event System tracks the instances as they're created and destroyed, and the dispatch calls the
+	 * \a Callback of each one in a single loop, in no particular order. Instances created by the handlers receive the
+	 * next events. Class default objects, archetypes and the instances marked as garbage don't receive events.
+	 *
+	 * The observer of the record is the \a TObserver class. The receive hooks run once per event for the whole class,
+	 * with the class as the observer, and \a RemoveByObserver removes the subscription when given the class.
+	 *
+	 * @tparam TEvent The type of the events you want the instances to listen for.
+	 * @tparam TObserver The observer class whose instances will be notified. Both types should be specified explicitly,
+	 * like in the example above.
+	 * @tparam TCallback The type of the \a Callback method.
+	 * @param Callback The event handler method that will be called on every instance.
+	 * @param Channel Determines the channel the event will be sent on.
+	 * @param Group Observer group the record belongs to. See \a SuspendGroup.
+	 * @return A handle to the record of the subscription. Removing it ends the subscription of all instances.
+	 */
+	template <typename TEvent, typename TObserver, typename TCallback>
+		requires TIsDerivedFrom<TObserver, UObject>::Value &&
+		TIsDerivedFrom<TEvent, ULES_Event>::Value &&
+		!TIsSame<TEvent, ULES_Event>::Value &&
+		LES::IsMethodEventHandler<TObserver, TCallback, TEvent>
+	FLES_ObserverHandle AddClassObserver(TCallback Callback, const FName Channel = NAME_None,
+	                                     const FName Group = NAME_None);
+
+	/**
+	 * Adds the \a Observer to the Event System as answering the queries of \a TEvent type sent on the \a Channel with
+	 * \a Query. The \a Callback writes its answer into the query's result, which reduces it in place. Example usage:
+	 *
+	 * EventSystem->AddQueryObserver<UCanInteractQuery, bool>(Door, &UDoor::CanInteract, "Interaction");\n
+	 *
+	 * UDoor should have a handler method defined like follows:\n
+	 * void UDoor::CanInteract(UCanInteractQuery* Query, LES::TQueryResult<bool>& Result)\n
+	 * {\n
+	 *		Result.Add(!bLocked);\n
+	 * }
+	 *
+	 * The handler isn't called for the events sent with \a SendEvent, and all query handlers of an event class and
+	 * channel should use the same \a TResult type. Handlers asked by a query with another result type don't answer,
+	 * and raise an ensure. Handlers whose delivery has been deferred don't answer.
+	 *
+	 * @tparam TEvent The type of the query events. Both types should be specified explicitly, like in the example
+	 * above.
+	 * @tparam TResult The type of the answers.
+	 * @param Observer The object that will answer the queries of \a TEvent type sent on the \a Channel.
+	 * @param Callback A method of the \a Observer or a callable taking the query event and the query's result.
+	 * @param Channel Determines the channel the queries will be sent on.
+	 * @param Group Observer group the record belongs to. See \a SuspendGroup.
+	 * @return A handle to the newly created observer record in the Event System.
+	 */
+	template <typename TEvent, typename TResult, typename TObserver, typename TCallback>
+		requires TIsDerivedFrom<TObserver, UObject>::Value &&
+		TIsDerivedFrom<TEvent, ULES_Event>::Value &&
+		!TIsSame<TEvent, ULES_Event>::Value &&
+		(LES::IsMethodQueryHandler<TObserver, TCallback, TEvent, TResult> ||
+			LES::IsFunctorQueryHandler<TCallback, TEvent, TResult>)
+	FLES_ObserverHandle AddQueryObserver(TObserver* Observer, TCallback Callback, const FName Channel = NAME_None,
+	                                     const FName Group = NAME_None);
+
+	/**
+	 * Sends the \a Event as a query to the observers added with \a AddQueryObserver, and returns their answers
+	 * reduced with the \a Reducer. The result is accumulated in place while the event is dispatched, so no reply
+	 * events are created, and the remaining observers aren't asked once the result is decided, like after the first
+	 * false answer to an AND query. Other observers of the event receive it as if it was sent with \a SendEvent, and
+	 * the send hooks run as usual. Example usage:
+	 *
+	 * const bool bCanInteract = EventSystem->Query<bool>(Query, ELES_QueryReducer::And).Get(true);\n
+	 *
+	 * @tparam TResult The type of the answers of the query handlers.
+	 * @param Event The query event. Its class and channel determine the observers that are asked.
+	 * @param Reducer Determines how the answers are combined.
+	 * @return The reduced answers, or the collected ones for \a ELES_QueryReducer::Collect.
+	 */
+	template <typename TResult>
+	LES::TQueryResult<TResult> Query(ULES_Event* Event, const ELES_QueryReducer Reducer);
+
+	/**
+	 * Calls the handlers of the observers receiving events in batches with the events collected so far. Called on every
+	 * tick. See \a AddBatchObserver.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Event System | Batching")
+	void FlushMailboxes();
+
+	/**
+	 * Adds the \a Observer to the Event System and marks it as listening for events of \a TEvent type, that are sent on
+	 * the specified \a Channel, handled away from the sender's thread. Each event is handed to a UE::Tasks task calling
+	 * the \a Work handler, so sending doesn't wait for it. Use it for handlers doing pure computation, like pathfinding
+	 * requests or analytics aggregation. Example usage:
+	 *
+	 * EventSystem->AddAsyncObserver<UPathRequestEvent>(Navigator, [](UPathRequestEvent* Event)\n
+	 * {\n
+	 *		Event->Path = FindPath(Event->Start, Event->End);\n
+	 * }, &UNavigator::OnPathFound);\n
+	 *
+	 * The \a Work handler runs on a worker thread, so it may only touch the event and thread-safe data, and shouldn't
+	 * modify the event's UPROPERTY references. The task gets its own copy of the sent event, made by \a SendEvent, so
+	 * the sender may reuse the event and the other observers may modify it, at the cost of an object per event. The
+	 * copies are kept alive until they're completed. Once a task finishes, the \a Completion handler is called with
+	 * its copy on the game thread, when the Event System is ticked, followed by the \a AfterReceive hook. If the record
+	 * is removed, the queued events are dropped and the completion isn't called for the tasks still running.
+	 *
+	 * @tparam TEvent The type of the events you want the \a Observer to listen for. You should explicitly specify this
+	 * type, like in the example above.
+	 * @param Observer The object that will be notified when events of \a TEvent type are sent on the \a Channel.
+	 * @param Work The thread-safe callable handling an event in a task.
+	 * @param Completion A method of the \a Observer or a callable, called on the game thread with the event whose task
+	 * has finished.
+	 * @param Channel Determines the channel the events will be sent on.
+	 * @param MaxTasksInFlight Amount of the observer's tasks that may run at once. The events sent while they run wait
+	 * in a queue, and with the default of 1, the events are handled one by one in the order they were sent.
+	 * @param Group Observer group the record belongs to. See \a SuspendGroup.
+	 * @return A handle to the newly created observer record in the Event System.
+	 */
+	template <typename TEvent, typename TObserver, typename TWork, typename TCompletion>
+		requires TIsDerivedFrom<TObserver, UObject>::Value &&
+		TIsDerivedFrom<TEvent, ULES_Event>::Value &&
+		!TIsSame<TEvent, ULES_Event>::Value &&
+		LES::IsFunctorEventHandler<TWork, TEvent> &&
+		(LES::IsMethodEventHandler<TObserver, TCompletion, TEvent> || LES::IsFunctorEventHandler<TCompletion, TEvent>)
+	FLES_ObserverHandle AddAsyncObserver(TObserver* Observer, TWork Work, TCompletion Completion,
+	                                     const FName Channel = NAME_None, const int32 MaxTasksInFlight = 1,
+	                                     const FName Group = NAME_None);
+
+	/** Version of \a AddAsyncObserver without a completion handler. */
+	template <typename TEvent, typename TObserver, typename TWork>
+		requires TIsDerivedFrom<TObserver, UObject>::Value &&
+		TIsDerivedFrom<TEvent, ULES_Event>::Value &&
+		!TIsSame<TEvent, ULES_Event>::Value &&
+		LES::IsFunctorEventHandler<TWork, TEvent>
+	FLES_ObserverHandle AddAsyncObserver(TObserver* Observer, TWork Work, const FName Channel = NAME_None,
+	                                     const int32 MaxTasksInFlight = 1, const FName Group = NAME_None);
+
+	/**
+	 * Completes the events whose async observer tasks have finished and launches the tasks of the queued events.
+	 * Called on every tick. See \a AddAsyncObserver.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Event System | Async")
+	void FlushAsyncObservers();
+
+	/**
+	 * Returns the queue depth and latency of the async observer referenced by the \a ObserverHandle, or empty stats if
+	 * it's not an async observer.
+	 */
+	UFUNCTION(BlueprintPure, Category = "Event System | Async")
+	FLES_AsyncObserverStats GetAsyncObserverStats(const FLES_ObserverHandle& ObserverHandle) const;
 
 	/**
 	 * Adds the \a Observer to the Event System and marks it as listening for events of \a EventClass type, that are
@@ -110,6 +377,7 @@ public:
 	 * @param Callback The event handler that will be called when the event is received.
 	 * @param Channel Determines the channel the event will be sent on. Observers are notified only about the events
 	 * sent on the channel they're listening on.
+	 * @param Group Observer group the record belongs to. See \a SuspendGroup.
 	 * @return A handle to the newly created observer record in the Event System. You may use this handle later to
 	 * remove this particular observer record from the Event System.
 	 */
@@ -119,7 +387,7 @@ public:
 		Category = "Event System")
 	FLES_ObserverHandle BP_AddObserver_Event(
 		UPARAM(Meta = (AllowAbstract = "false")) const TSubclassOf<ULES_Event>& EventClass, UObject* Observer,
-		FLES_EventHandler Callback, const FName Channel = NAME_None);
+		FLES_EventHandler Callback, const FName Channel = NAME_None, const FName Group = NAME_None);
 
 	/**
 	 * Adds the \a Observer to the Event System and marks it as listening for events of \a EventClass type, that are
@@ -132,6 +400,7 @@ public:
 	 * function should take 1 parameter of the type of your event and return no values.
 	 * @param Channel Determines the channel the event will be sent on. Observers are notified only about the events
 	 * sent on the channel they're listening on.
+	 * @param Group Observer group the record belongs to. See \a SuspendGroup.
 	 * @return A handle to the newly created observer record in the Event System. You may use this handle later to
 	 * remove this particular observer record from the Event System. If \a FunctionName is not the name of a
 	 * blueprint-callable member function of the \a Observer, an invalid handle is returned.
@@ -142,16 +411,316 @@ public:
 		Category = "Event System")
 	FLES_ObserverHandle BP_AddObserver_Function(
 		UPARAM(Meta = (AllowAbstract = "false")) const TSubclassOf<ULES_Event>& EventClass, UObject* Observer,
-		const FName FunctionName, const FName Channel = NAME_None);
+		const FName FunctionName, const FName Channel = NAME_None, const FName Group = NAME_None);
+
+	/**
+	 * Version of \a BP_AddObserver_Function called by the Add Observer blueprint node, which checks the handler's
+	 * signature when the blueprint is compiled. Looks the function up by name, and only checks that its single
+	 * parameter accepts the \a EventClass, since the observer passed at runtime may be of another class. Returns an
+	 * invalid handle otherwise.
+	 */
+	UFUNCTION(BlueprintCallable, Meta = (BlueprintInternalUseOnly = "true"), Category = "Event System")
+	FLES_ObserverHandle BP_AddObserver_Resolved(const TSubclassOf<ULES_Event>& EventClass, UObject* Observer,
+	                                            const FName FunctionName, const FName Channel, const FName Group);
+
+	/**
+	 * Replaces the stream operators of the observer record referenced by the \a ObserverHandle. Pass empty operators
+	 * to remove them. Any events deferred by the previous operators are discarded.
+	 *
+	 * @param ObserverHandle Handle to the observer record.
+	 * @param Operators Stream operators, like debounce or throttle, evaluated before the event handler is called.
+	 * @return True if the handle is valid and the operators were set.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Event System")
+	bool SetStreamOperators(const FLES_ObserverHandle& ObserverHandle, const FLES_StreamOperators& Operators);
 
 	/**
 	 * Sends the \a Event to all observers listening for this type of event on the channel.
+	 *
+	 * Once warmed up, sending to the existing observers doesn't allocate heap memory for the native handlers small
+	 * enough to be stored inside their records. This holds for the sends with a token, the conflated and scheduled
+	 * sends flushed by \a Tick, the deferred deliveries and the spatial observers, and for \a RemoveByHandle. The
+	 * first sends of a kind may grow the Event System's scratch arrays, and the blueprint handlers and hooks allocate
+	 * in the blueprint VM. The guarantee is covered by the "Light Event System.Zero allocation" tests.
 	 * 
 	 * @param Event Event object that will be sent.
 	 */
 	UFUNCTION(BlueprintCallable, Category = "Event System")
 	void SendEvent(ULES_Event* Event);
 
+	/**
+	 * Creates and sends an event only if anyone listens for events of the \a TEvent type on the \a Channel. Use it when
+	 * building the event is expensive. Example usage:
+	 *
+	 * EventSystem->SendEventLazy<UMyEvent>("Some channel", [this]\n
+	 * {\n
+	 *		UMyEvent* Event = NewObject<UMyEvent>();\n
+	 *		Event->Path = ComputeExpensivePath();\n
+	 *		return Event;\n
+	 * });
+	 *
+	 * Note that the send hooks aren't called for the events that are never created.
+	 *
+	 * @tparam TEvent The type of the event. You should explicitly specify this type, like in the example above.
+	 * @param Channel The channel the event will be sent on. Overrides the channel set by the \a Factory.
+	 * @param Factory Callable returning the event to send. Called only if there are observers.
+	 * @return True if the event was created and sent.
+	 */
+	template <typename TEvent, typename TFactory>
+		requires TIsDerivedFrom<TEvent, ULES_Event>::Value &&
+		std::is_convertible_v<std::invoke_result_t<TFactory>, TEvent*>
+	bool SendEventLazy(const FName Channel, TFactory&& Factory);
+
+	/**
+	 * Returns true if any observer record listens for events of exactly the \a EventClass on the \a Channel, including
+	 * the suspended ones. Most queries without observers are answered by a filter, without looking up the bucket.
+	 */
+	UFUNCTION(BlueprintPure, Meta = (AutoCreateRefTerm = "EventClass"), Category = "Event System")
+	bool HasObservers(const TSubclassOf<ULES_Event>& EventClass, const FName Channel = NAME_None) const;
+
+	/**
+	 * Returns the events sent at least \a MinNumSends times without observers, grouped by their class, channel and
+	 * call site, most frequent first. Use it to find the senders doing wasted work. Tracked only in the debug and
+	 * development builds, see \a LES_WITH_SEND_REPORT.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Event System | Diagnostics")
+	TArray<FLES_UnobservedSend> GetUnobservedSends(const int64 MinNumSends = 1) const;
+
+	/** Writes the report returned by \a GetUnobservedSends to the log. */
+	UFUNCTION(BlueprintCallable, Category = "Event System | Diagnostics")
+	void LogUnobservedSends(const int64 MinNumSends = 1) const;
+
+	/** Clears the report returned by \a GetUnobservedSends. */
+	UFUNCTION(BlueprintCallable, Category = "Event System | Diagnostics")
+	void ResetUnobservedSends();
+
+	/**
+	 * Sends the \a Event using a pre-resolved \a Token, skipping the lookup of the observers listening for the event's
+	 * class and channel. If the token is invalid, or doesn't match the event's class and channel, the event is sent
+	 * the regular way.
+	 *
+	 * @param Token Token returned by \a ResolveSendToken for the event's class and channel.
+	 * @param Event Event object that will be sent.
+	 */
+	void SendEvent(const FLES_SendToken& Token, ULES_Event* Event);
+
+	/** Blueprint version of \a SendEvent taking a pre-resolved \a Token. */
+	UFUNCTION(BlueprintCallable, Meta = (DisplayName = "Send Event (Token)"), Category = "Event System")
+	void BP_SendEvent_Token(const FLES_SendToken& Token, ULES_Event* Event);
+
+	/**
+	 * Resolves a token for sending events of the \a EventClass on the \a Channel. Resolve it once, store it, and use
+	 * it with \a SendEvent for senders that send the same kind of event many times. The token stays valid when
+	 * observers are added or removed.
+	 *
+	 * @param EventClass The class of the events that will be sent with the token.
+	 * @param Channel The channel the events will be sent on.
+	 * @return The resolved token, or an invalid token if the \a EventClass is invalid.
+	 */
+	UFUNCTION(
+		BlueprintCallable,
+		Meta = (AutoCreateRefTerm = "EventClass"),
+		Category = "Event System | Send Token")
+	FLES_SendToken ResolveSendToken(
+		UPARAM(Meta = (AllowAbstract = "false")) const TSubclassOf<ULES_Event>& EventClass,
+		const FName Channel = NAME_None);
+
+	/** Returns true if the \a Token has been resolved by this Event System and may be used for sending events. */
+	UFUNCTION(BlueprintPure, Category = "Event System | Send Token")
+	bool IsSendTokenValid(const FLES_SendToken& Token) const;
+
+	/**
+	 * Queues the \a Event to be sent later in the frame, replacing an event of the same class, channel and sender that
+	 * is still waiting in the queue. Use it for events whose observers only care about the latest value, like score or
+	 * health updates. Replaced events keep their position in the queue. See \a ConflationFlushPoint.
+	 *
+	 * @param Event Event object that will be sent.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Event System | Conflation")
+	void SendEventConflated(ULES_Event* Event);
+
+	/**
+	 * Sends all conflated events waiting in the queue, in the order their keys were first queued. Does nothing when
+	 * called by a handler of the events being flushed, since the events conflated by the handlers wait for the next
+	 * flush.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Event System | Conflation")
+	void FlushConflatedEvents();
+
+	/** Returns the counters describing how many conflated sends were merged. */
+	UFUNCTION(BlueprintPure, Category = "Event System | Conflation")
+	FLES_ConflationStats GetConflationStats() const;
+
+	/** Resets the counters returned by \a GetConflationStats. */
+	UFUNCTION(BlueprintCallable, Category = "Event System | Conflation")
+	void ResetConflationStats();
+
+	/** Determines when the events sent with \a SendEventConflated are dispatched. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Event System | Conflation")
+	ELES_ConflationFlushPoint ConflationFlushPoint = ELES_ConflationFlushPoint::Tick;
+
+	/**
+	 * Schedules the \a Event to be sent after \a Delay seconds of the Event System's time have passed. Scheduled events
+	 * are kept alive until they are sent or cancelled, and are sent in batches when the Event System is ticked.
+	 *
+	 * @param Event Event object that will be sent.
+	 * @param Delay Time in seconds after which the event will be sent. Events with a non-positive delay are sent on the
+	 * next tick.
+	 * @return A handle to the scheduled event. You may use this handle to cancel the event before it's sent.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Event System | Scheduling")
+	FLES_ScheduledEventHandle SendEventDelayed(ULES_Event* Event, const double Delay);
+
+	/**
+	 * Schedules the \a Event to be sent once the Event System's time reaches \a Time. Scheduled events are kept alive
+	 * until they are sent or cancelled, and are sent in batches when the Event System is ticked.
+	 *
+	 * @param Event Event object that will be sent.
+	 * @param Time The Event System's time at which the event will be sent. See \a GetTime. Events scheduled in the
+	 * past are sent on the next tick.
+	 * @return A handle to the scheduled event. You may use this handle to cancel the event before it's sent.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Event System | Scheduling")
+	FLES_ScheduledEventHandle SendEventAt(ULES_Event* Event, const double Time);
+
+	/**
+	 * Cancels the scheduled event referenced by the \a ScheduledEventHandle.
+	 *
+	 * @return True if the event was waiting to be sent and has been cancelled.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Event System | Scheduling")
+	bool CancelScheduledEvent(const FLES_ScheduledEventHandle& ScheduledEventHandle);
+
+	/** Returns true if the \a ScheduledEventHandle references an event that is still waiting to be sent. */
+	UFUNCTION(BlueprintPure, Category = "Event System | Scheduling")
+	bool IsEventScheduled(const FLES_ScheduledEventHandle& ScheduledEventHandle) const;
+
+	/** Returns the amount of scheduled events that are waiting to be sent. */
+	UFUNCTION(BlueprintPure, Category = "Event System | Scheduling")
+	int GetNumScheduledEvents() const;
+
+	/**
+	 * Returns the Event System's time in seconds. The time starts at 0 and moves forward only when the Event System is
+	 * ticked.
+	 */
+	UFUNCTION(BlueprintPure, Category = "Event System | Scheduling")
+	double GetTime() const;
+
+	/**
+	 * Advances the Event System's time by \a DeltaTime and sends the scheduled events that became due. The global Event
+	 * System is ticked by the Event Subsystem. If you create your own Event System objects, it's up to you to tick them.
+	 *
+	 * @param DeltaTime Time in seconds that has passed since the last tick.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Event System")
+	void Tick(const float DeltaTime);
+
+	/**
+	 * Restricts the observer record referenced by the \a ObserverHandle to the spatial events within its reach. The
+	 * observer receives an event only if its distance to the event's location is at most the sum of the event's radius
+	 * and the observer's \a Radius, which saves the handlers from rejecting the distant events themselves. Call it
+	 * again to change the source or the radius.
+	 *
+	 * @param ObserverHandle Handle to an observer record listening for a subclass of \a ULES_SpatialEvent.
+	 * @param PositionSource Component whose location is the observer's position. The positions are read in a batch
+	 * when the Event System is ticked. Pass nullptr to set the position with \a SetSpatialObserverLocation instead.
+	 * @param Radius Reach of the observer, like its hearing range.
+	 * @return True if the handle is valid and listens for spatial events.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Event System | Spatial")
+	bool SetSpatialFilter(const FLES_ObserverHandle& ObserverHandle, const USceneComponent* PositionSource,
+	                      const float Radius);
+
+	/**
+	 * Moves the observer with a spatial filter to the \a Location right away. Use it for the observers without a
+	 * position source, or to correct the position between the ticks.
+	 *
+	 * @return True if the handle is valid and the observer has a spatial filter.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Event System | Spatial")
+	bool SetSpatialObserverLocation(const FLES_ObserverHandle& ObserverHandle, const FVector& Location);
+
+	/** Reads the positions of the observers with a spatial filter from their sources. Called on every tick. */
+	UFUNCTION(BlueprintCallable, Category = "Event System | Spatial")
+	void UpdateSpatialObservers();
+
+	/**
+	 * Edge length of the spatial grid cells. Should be close to the typical reach of the spatial events. Applies to the
+	 * grids created after the change.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Event System | Spatial")
+	float SpatialCellSize = 2000.0f;
+
+	/**
+	 * Suspends all observer records of the \a Group, in constant time. Suspended observers stay registered, but don't
+	 * receive the events sent until the group is resumed, and their stream operators don't deliver deferred events.
+	 * Use it instead of removing and re-adding the observers, e.g. while the game is paused. Records added to a
+	 * suspended group start suspended. The records without a group can't be suspended.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Event System | Groups")
+	void SuspendGroup(const FName Group);
+
+	/** Resumes the observer records of the \a Group suspended with \a SuspendGroup, in constant time. */
+	UFUNCTION(BlueprintCallable, Category = "Event System | Groups")
+	void ResumeGroup(const FName Group);
+
+	/** Returns true if the \a Group is suspended. */
+	UFUNCTION(BlueprintPure, Category = "Event System | Groups")
+	bool IsGroupSuspended(const FName Group) const;
+
+	/** Returns the group of the observer record referenced by the \a ObserverHandle. */
+	UFUNCTION(BlueprintPure, Category = "Event System | Groups")
+	FName GetGroup(const FLES_ObserverHandle& ObserverHandle) const;
+
+	/**
+	 * Time budget of a single handler call in milliseconds, for the channels without an entry in
+	 * \a ChannelHandlerBudgets. Handler calls are timed only on the channels with a positive budget. Handlers that go
+	 * over the budget are logged once per handler, event class and channel, and counted in \a GetWatchdogStats.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Event System | Watchdog")
+	float DefaultHandlerBudget = 0.0f;
+
+	/** Handler budgets of the individual channels in milliseconds, overriding the \a DefaultHandlerBudget. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Event System | Watchdog")
+	TMap<FName, float> ChannelHandlerBudgets;
+
+	/**
+	 * If set, the observer records whose handlers go over the budget are demoted to the deferred delivery, so that a
+	 * slow handler doesn't stall the senders. See \a SetDeliveryDeferred.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Event System | Watchdog")
+	bool bDeferSlowHandlers = false;
+
+	/**
+	 * Makes the observer record referenced by the \a ObserverHandle receive its events when the Event System is ticked,
+	 * instead of while they're sent. The events are filtered by the stream operators and the spatial filter when sent,
+	 * and the receive hooks run when they're delivered.
+	 *
+	 * @return True if the handle is valid.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Event System | Watchdog")
+	bool SetDeliveryDeferred(const FLES_ObserverHandle& ObserverHandle, const bool bDeferred);
+
+	/** Returns true if the observer record referenced by the \a ObserverHandle receives its events deferred. */
+	UFUNCTION(BlueprintPure, Category = "Event System | Watchdog")
+	bool IsDeliveryDeferred(const FLES_ObserverHandle& ObserverHandle) const;
+
+	/** Returns the counters of the slow-handler watchdog. */
+	UFUNCTION(BlueprintPure, Category = "Event System | Watchdog")
+	FLES_WatchdogStats GetWatchdogStats() const;
+
+	/** Resets the counters returned by \a GetWatchdogStats and forgets the slow handlers logged so far. */
+	UFUNCTION(BlueprintCallable, Category = "Event System | Watchdog")
+	void ResetWatchdogStats();
+
+	/**
+	 * Writes the watchdog's counters and the handlers that went over the budget to the log, with the call sites of the
+	 * unnamed handlers symbolicated. Also available as the LES.Watchdog console command, for all Event Systems on the
+	 * game thread.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Event System | Watchdog")
+	void LogWatchdogStats() const;
+
 	/**
 	 * Removes all observer records that are associated with garbage-collected Observers.
 	 * 
@@ -160,6 +729,14 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Event System")
 	int Clean();
 
+	/**
+	 * If set, \a Clean is called automatically after each garbage collection, so that the records of the destroyed
+	 * observers don't pile up in long sessions where nothing else cleans them. Clear it to clean the records only
+	 * when \a Clean is called explicitly.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Event System")
+	bool bCleanAfterGarbageCollection = true;
+
 	/**
 	 * Removes the observer record referenced by the \a ObserverHandle.
 	 * 
@@ -182,6 +759,26 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Event System")
 	void RemoveAll();
 
+	/**
+	 * Removes all observer records listening on the \a Channel, dropping its buckets at once instead of visiting
+	 * every bucket.
+	 *
+	 * @param Channel Channel whose observers should be removed.
+	 * @return Amount of observer records removed.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Event System")
+	int RemoveByChannel(const FName Channel);
+
+	/**
+	 * Removes all observer records listening for exactly the \a EventClass, on any channel. The observers of its
+	 * subclasses and base classes are kept.
+	 *
+	 * @param EventClass Event class whose observers should be removed.
+	 * @return Amount of observer records removed.
+	 */
+	UFUNCTION(BlueprintCallable, Meta = (AutoCreateRefTerm = "EventClass"), Category = "Event System")
+	int RemoveByEventClass(const TSubclassOf<ULES_Event>& EventClass);
+
 	/** Returns the total amount of observer records in the Event System. */
 	UFUNCTION(BlueprintPure, Category = "Event System")
 	int Num() const;
@@ -195,6 +792,57 @@ public:
 	UFUNCTION(BlueprintPure, Category = "Event System")
 	int GetChannels(TArray<FName>& OutChannels) const;
 
+	/** Returns the amount of observer records listening for exactly the \a EventClass on the \a Channel. */
+	UFUNCTION(BlueprintPure, Meta = (AutoCreateRefTerm = "EventClass"), Category = "Event System")
+	int GetObserverCount(const TSubclassOf<ULES_Event>& EventClass, const FName Channel = NAME_None) const;
+
+	/** Returns the amount of observer records listening on the \a Channel, for any event class. */
+	UFUNCTION(BlueprintPure, Category = "Event System")
+	int GetChannelObserverCount(const FName Channel) const;
+
+	/**
+	 * Removes the dispatch buckets of the event classes that have been unloaded, together with their observer records.
+	 * Called automatically after each garbage collection, since the Event System doesn't keep the event classes
+	 * alive.
+	 *
+	 * @return Amount of buckets removed.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Event System")
+	int PurgeUnloadedEventClasses();
+
+	/** Returns the memory used by the Event System and the memory reclaimed by purging the unloaded event classes. */
+	UFUNCTION(BlueprintPure, Category = "Event System")
+	FLES_MemoryReport GetMemoryReport() const;
+
+	/**
+	 * Reserves room for \a NumObservers observer records and \a NumBuckets pairs of event classes and channels up
+	 * front, so that adding them later doesn't grow the tables, e.g. when a level starts. The Event Subsystem reserves
+	 * the capacity configured in the project settings, see \a ULES_EventSystemSettings.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Event System | Capacity")
+	void Reserve(const int32 NumObservers, const int32 NumBuckets);
+
+	/**
+	 * Creates the bucket of the \a EventClass and the \a Channel ahead of the first observer, with room for
+	 * \a NumObservers records without a group. The bucket's peak use is listed in \a GetUsageReport.
+	 */
+	UFUNCTION(BlueprintCallable, Meta = (AutoCreateRefTerm = "EventClass"), Category = "Event System | Capacity")
+	void ReserveObservers(const TSubclassOf<ULES_Event>& EventClass, const FName Channel, const int32 NumObservers);
+
+	/** Compares the capacity reserved with \a Reserve and \a ReserveObservers with the peak use. */
+	UFUNCTION(BlueprintPure, Category = "Event System | Capacity")
+	FLES_UsageReport GetUsageReport() const;
+
+	/**
+	 * Logs the \a GetUsageReport, warning about the reservations that were exceeded. Also available as the LES.Usage
+	 * console command, for all Event Systems on the game thread.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Event System | Capacity")
+	void LogUsageReport() const;
+
+	/** Returns true if the Event System belongs to a shard of a sharded event bus, and runs on its thread. */
+	bool IsOwnedByShard() const { return bOwnedByShard; }
+
 	/** Returns true if \a Observer has been added to the Event System. */
 	UFUNCTION(BlueprintPure, Category = "Event System")
 	bool ContainsObserver(const UObject* Observer) const;
@@ -266,17 +914,341 @@ public:
 	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Event System | Hooks")
 	void AfterSend(ULES_Event* Event);
 
+	static void AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector);
+	virtual void PostInitProperties() override;
+	virtual void BeginDestroy() override;
+
 private:
-	using FKey = TPair<TStrongObjectPtr<UClass>, FName>;
-	using FRecord = TSharedPtr<LES::FObserverRecord>;
+	/** Observe the replicated and bridged events with native callbacks, without knowing their classes at compile time. */
+	friend class ULES_EventReplicator;
+	friend class ULES_SharedMemoryBridge;
+	friend class ULES_ShardedEventBus;
+
+	/** Event class and channel. The class is referenced weakly, so that the Event System doesn't keep it alive. */
+	using FKey = TPair<FObjectKey, FName>;
+
+	/** Records of one observer group in a bucket. */
+	struct FRecordList
+	{
+		int32 Group = 0;
+		TArray<int32> Records;
+	};
+
+	/** Observer records listening for one event class on one channel. */
+	struct FBucket
+	{
+		FKey Key;
+
+		/** Used only for comparison. Buckets are purged after the class is garbage-collected, before it's freed. */
+		const UClass* EventClass = nullptr;
+
+		/**
+		 * Indices of the records in \a ObserverRecords, partitioned by their group, so that the dispatch skips whole
+		 * lists of the suspended groups. INDEX_NONE for the records removed during a dispatch. Lists are kept in the
+		 * order their groups first appeared in the bucket.
+		 */
+		TArray<FRecordList, TInlineAllocator<1>> RecordLists;
+
+		/** Records with a spatial filter. They're kept out of \a Records, so that the distant ones aren't visited. */
+		TUniquePtr<LES::FSpatialHash> SpatialObservers;
+
+		/** Amount of records in the bucket, including the spatial ones. */
+		int32 NumRecords = 0;
+		uint32 Serial = 0;
+
+		/** Set when records have been removed during a dispatch, and the bucket needs to be compacted. */
+		bool bHasRemovedRecords = false;
+
+		/** Amount of records reserved with \a ReserveObservers, and the largest amount the bucket has had. */
+		int32 ReservedRecords = 0;
+		int32 PeakNumRecords = 0;
+	};
+
+	/**
+	 * Dispatch buckets, indexed by the send tokens. Buckets are created on the first registration or token resolution
+	 * for their key, and are kept when they become empty, so that the tokens stay valid. Buckets of unloaded event
+	 * classes are purged and their indices reused.
+	 */
+	TArray<FBucket> Buckets;
+	TArray<int32> FreeBuckets;
+	TMap<FKey, int32> BucketIndices;
+
+	/** Buckets of one channel, and the amount of records in them. */
+	struct FChannelEntry
+	{
+		TArray<int32, TInlineAllocator<4>> Buckets;
+		int32 NumRecords = 0;
+	};
+
+	/**
+	 * Buckets by their channel and by their event class. Entries are added with the buckets and removed when their
+	 * last bucket is purged, so that the channels are listed and whole channels or classes are removed without
+	 * visiting every bucket.
+	 */
+	TMap<FName, FChannelEntry> ChannelIndex;
+	TMap<FObjectKey, TArray<int32, TInlineAllocator<4>>> EventClassIndex;
+	LES::FObserverPool ObserverRecords;
+	int32 NumRecords = 0;
+
+	/** Capacity reserved with \a Reserve, and the peak use compared with it in \a GetUsageReport. */
+	int32 ReservedRecords = 0;
+	int32 ReservedBuckets = 0;
+	int32 PeakNumRecords = 0;
+	int32 PeakNumBuckets = 0;
+
+	struct FGroup
+	{
+		FName Name = NAME_None;
+		bool bSuspended = false;
+	};
+
+	/** Observer groups, referenced by the records by index. The first group is for the records without a group. */
+	TArray<FGroup> Groups = {FGroup()};
+	TMap<FName, int32> GroupIndices;
+
+	/**
+	 * Bloom filter of the event classes and channels with observers, answering most \a HasObservers queries without
+	 * a bucket lookup. Bits can't be cleared one by one, so the filter is rebuilt once enough buckets became empty.
+	 */
+	static constexpr int32 ObservedFilterSize = 4096;
+	TStaticBitArray<ObservedFilterSize> ObservedFilter;
+	int32 NumStaleObservedKeys = 0;
+
+#if LES_WITH_SEND_REPORT
+	/** Events sent without observers, by their class, channel and the return address of the call. */
+	struct FUnobservedSendStats
+	{
+		int64 NumSends = 0;
+		FName SenderClass = NAME_None;
+	};
+
+	TMap<TTuple<FObjectKey, FName, uint64>, FUnobservedSendStats> UnobservedSends;
+#endif
+
+	/** Handler calls over the budget, by the handler's call site and name, the event class and the channel. */
+	struct FSlowHandlerStats
+	{
+		int64 NumOverBudgetCalls = 0;
+		double SlowestCallTime = 0.0;
+
+		/** Set when the handler first goes over the budget. The call site is symbolicated only for the log. */
+		FString ObserverName;
+	};
+
+	TMap<TTuple<uint64, FName, FObjectKey, FName>, FSlowHandlerStats> SlowHandlers;
+	FLES_WatchdogStats WatchdogStats;
+
+	/** Event waiting for the tick to be delivered to an observer record with the deferred delivery. */
+	struct FDeferredDelivery
+	{
+		int32 RecordIndex = INDEX_NONE;
+		uint32 RecordSerial = 0;
+		ULES_Event* Event = nullptr;
+	};
 
-	TMultiMap<FKey, FRecord> ObserverRecords;
+	/** Events for the records with the deferred delivery, and the ones being delivered by the current tick. */
+	TArray<FDeferredDelivery> DeferredDeliveries;
+	TArray<FDeferredDelivery> DueDeliveries;
+
+	/**
+	 * Depth of the nested dispatches. While positive, the buckets are iterated in place, so removed records are only
+	 * cleared in their buckets, and released from \a DeferredReleases. The buckets are compacted when the outermost
+	 * dispatch finishes.
+	 */
+	int32 DispatchDepth = 0;
+	TArray<int32> BucketsToCompact;
+	TArray<int32> DeferredReleases;
+
+	/**
+	 * Amount of records in each list of the buckets being dispatched, taken when the dispatch starts. Nested dispatches
+	 * append their counts after the ones of the outer dispatches, and remove them when they finish, so the dispatch
+	 * doesn't allocate once the array has grown.
+	 */
+	TArray<int32> NumRecordsToNotify;
+
+	/**
+	 * Records of the spatial observers within reach of the events being dispatched. Nested dispatches append their
+	 * candidates after the ones of the outer dispatches, and remove them when they finish.
+	 */
+	TArray<int32> SpatialCandidates;
+
+	FLES_MemoryReport PurgeStats;
+	FDelegateHandle PostGarbageCollectHandle;
+
+	/** Set by the sharded event bus, so that the console commands leave the Event System to the thread of its shard. */
+	bool bOwnedByShard = false;
+
+	double CurrentTime = 0.0;
+	LES::FTimingWheel ScheduledEvents;
+	TArray<ULES_Event*> DueEvents;
+
+	/**
+	 * Indices and serials of the observer records with stream operators, which may have deferred events to deliver
+	 * when ticked.
+	 */
+	TArray<TPair<int32, uint32>> OperatorRecords;
+
+	/** Indices and serials of the observer records receiving events in batches, flushed when ticked. */
+	TArray<TPair<int32, uint32>> MailboxRecords;
+
+	/** Indices and serials of the observer records handling their events in tasks, flushed when ticked. */
+	TArray<TPair<int32, uint32>> AsyncRecords;
+
+	/** Async observers of the removed records, kept until their running tasks finish. */
+	TArray<TUniquePtr<LES::FAsyncObserver>> RetiredAsyncObservers;
+
+	/** Observers receiving the events sent from any thread, by the index of their records. */
+	LES::FConcurrentDispatcher ConcurrentObservers;
+
+	/** Result of the query being dispatched, answered by the query handlers. Nested queries replace it meanwhile. */
+	LES::FQueryState* ActiveQuery = nullptr;
+
+	/** Live instances of the classes with class-level subscriptions. Created by the first subscription. */
+	TUniquePtr<LES::FClassInstances> ClassInstances;
+
+	/** Conflated events waiting to be sent, in the order their keys were first queued. */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<ULES_Event>> ConflatedEvents;
+
+	/** Conflated events being sent right now. Handlers may queue new conflated events in the meantime. */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<ULES_Event>> FlushedConflatedEvents;
+
+	/** Index of each key's event in the \a ConflatedEvents queue. */
+	TMap<LES::FConflationKey, int32> ConflatedEventIndices;
+	FLES_ConflationStats ConflationStats;
+	FDelegateHandle EndOfFrameHandle;
 
 	/** Looks for blueprint-callable method called \a FunctionName in the \a Object. Returns nullptr if not found. */
 	static UFunction* FindCallbackFunction(const UObject* Object, const FName FunctionName);
 
-	FLES_ObserverHandle AddObserver_Private(const TSubclassOf<ULES_Event>& EventClass, UObject* Observer,
-	                                        TFunction<void(ULES_Event*)>&& Callback, const FName Channel);
+	/** Adds the observer record calling the blueprint function \a Callback of the \a Observer. */
+	FLES_ObserverHandle AddObserver_Function(const TSubclassOf<ULES_Event>& EventClass, UObject* Observer,
+	                                         UFunction* Callback, const FName Channel, const FName Group);
+
+	/** Never inlined, so that its return address points into the function adding the native handler. */
+	FORCENOINLINE FLES_ObserverHandle AddObserver_Private(const TSubclassOf<ULES_Event>& EventClass, UObject* Observer,
+	                                                      LES::FObserverCallback&& Callback, const FName Channel,
+	                                                      const FLES_StreamOperators& Operators = {},
+	                                                      const FName Group = NAME_None);
+
+	/** Adds the observer record handing its events to the tasks calling the \a Work handler. */
+	FORCENOINLINE FLES_ObserverHandle AddAsyncObserver_Private(const TSubclassOf<ULES_Event>& EventClass,
+	                                                           UObject* Observer, LES::FObserverCallback&& Work,
+	                                                           LES::FObserverCallback&& Completion, const FName Channel,
+	                                                           const int32 MaxTasksInFlight, const FName Group);
+
+	/** Adds the observer record collecting its events in a mailbox, flushed by calling the batch \a Callback. */
+	FORCENOINLINE FLES_ObserverHandle AddBatchObserver_Private(const TSubclassOf<ULES_Event>& EventClass,
+	                                                           UObject* Observer, LES::FBatchCallback&& Callback,
+	                                                           const FName Channel, const int32 MaxBatchSize,
+	                                                           const FName Group);
+
+	/** Adds the observer record with the \a ConcurrentCallback also added to \a ConcurrentObservers. */
+	FORCENOINLINE FLES_ObserverHandle AddConcurrentObserver_Private(const TSubclassOf<ULES_Event>& EventClass,
+	                                                                UObject* Observer,
+	                                                                LES::FObserverCallback&& Callback,
+	                                                                LES::FObserverCallback&& ConcurrentCallback,
+	                                                                const FName Channel);
+
+	/** Returns the list of the live instances of the \a ObserverClass, starting to track them if needed. */
+	LES::FInstanceList& FindOrAddClassInstances(UClass* ObserverClass);
+
+	/** Returns the positions of the \a ObservedFilter bits of the \a EventClass and \a Channel. */
+	static TPair<int32, int32> GetObservedFilterBits(const UClass* EventClass, const FName Channel);
+
+	/** Clears the \a ObservedFilter and sets the bits of the buckets with records. */
+	void RebuildObservedFilter();
+
+	/**
+	 * Returns the index of the bucket with observers for the \a EventClass and \a Channel. If there's none, counts the
+	 * skipped event in the send report and returns INDEX_NONE. Never inlined, so that its return address points into
+	 * the function calling \a SendEventLazy.
+	 */
+	FORCENOINLINE int32 FindObservedBucketForLazySend(const UClass* EventClass, const FName Channel);
+
+	/** Sends the \a Event to the observers in the bucket at the \a BucketIndex, running the send hooks. */
+	void SendEventToBucket(const int32 BucketIndex, ULES_Event* Event);
+
+	/** Counts the event sent at the \a CallSite without observers in the send report. */
+	void TrackUnobservedSend(const UClass* EventClass, const FName Channel, const UObject* Sender,
+	                         const void* CallSite);
+
+	/** Returns the index of the \a Group in \a Groups, adding it if it's not there yet. */
+	int32 FindOrAddGroup(const FName Group);
+
+	/** Returns the bucket's list of the records in the \a Group, adding it if it's not there yet. */
+	static FRecordList& FindOrAddRecordList(FBucket& Bucket, const int32 Group);
+
+	/** Returns the index of the bucket for the \a EventClass and \a Channel, or INDEX_NONE if there's none. */
+	int32 FindBucket(const UClass* EventClass, const FName Channel) const;
+	int32 FindOrAddBucket(const UClass* EventClass, const FName Channel);
+
+	/** Removes the bucket at the \a BucketIndex from the channel and event class indices, before it's purged. */
+	void RemoveFromIndices(const FKey& Key, const int32 BucketIndex, const int32 NumBucketRecords);
+
+	/** Returns the index of the bucket for the \a EventClass and \a Channel if it has records, or INDEX_NONE. */
+	int32 FindObservedBucket(const UClass* EventClass, const FName Channel) const;
+
+	/** Returns the estimated amount of bytes used by the \a Bucket and its observer records. */
+	SIZE_T GetAllocatedSize(const FBucket& Bucket) const;
+
+	/**
+	 * Delivers the \a Event to all observers in the bucket. Doesn't run the send hooks. If the \a StopFlag is given,
+	 * the remaining observers are skipped once it's set.
+	 */
+	void DispatchEvent(const int32 BucketIndex, ULES_Event* Event, const bool* StopFlag = nullptr);
+
+	/** Dispatches the \a Event with the \a QueryState as the active query, running the send hooks. */
+	void SendQuery(ULES_Event* Event, LES::FQueryState& QueryState);
+
+	/** Calls the \a Function with the index of every record in the \a Bucket, including the spatial observers. */
+	template <typename TFunction>
+	void ForEachRecord(const FBucket& Bucket, TFunction Function) const;
+
+	/** Removes the records of the bucket that satisfy the \a Predicate. Returns the amount of records removed. */
+	template <typename TPredicate>
+	int32 RemoveRecords(const int32 BucketIndex, TPredicate Predicate);
+
+	/** Removes all records of the bucket. Returns the amount of records removed. */
+	int32 RemoveBucketRecords(const int32 BucketIndex);
+
+	/** Invalidates the removed record, and releases it right away or, during a dispatch, after the dispatch. */
+	void ReleaseRecord(const int32 RecordIndex);
+
+	/** Schedules the bucket for compaction after the dispatch, since its cleared slots can't be removed during it. */
+	void CompactAfterDispatch(const int32 BucketIndex);
+
+	/** Compacts the buckets and releases the records removed during the dispatch that just finished. */
+	void ApplyDeferredRemovals();
+
+	/** Returns true if buckets are waiting to be compacted, or records to be released, after the dispatch. */
+	bool HasDeferredRemovals() const { return !BucketsToCompact.IsEmpty() || !DeferredReleases.IsEmpty(); }
+
+	/** Returns the handler budget of the \a Channel in milliseconds. Zero or less if the handlers aren't timed. */
+	float GetHandlerBudget(const FName Channel) const;
+
+	/** Delivers the \a Event to the observer of the record, or queues it if the record's delivery is deferred. */
+	void NotifyObserver(const int32 RecordIndex, ULES_Event* Event, const float Budget);
+
+	/** Delivers the \a Event to the observer of the record right away, running the receive hooks and the watchdog. */
+	void InvokeObserver(const int32 RecordIndex, ULES_Event* Event, const float Budget);
+
+	/** Counts and logs the handler call that went over the \a Budget, and demotes the record if it's enabled. */
+	void ReportSlowHandler(const int32 RecordIndex, const uint32 RecordSerial, const ULES_Event* Event,
+	                       const double CallTime, const float Budget);
+
+	/** Delivers the events queued for the records with the deferred delivery. */
+	void DeliverDeferredEvents();
+
+	/** Calls the batch handler of the record with the events in its mailbox, unless it's being flushed already. */
+	void FlushMailbox(const int32 RecordIndex);
+
+	/** Completes the finished tasks of the record's async observer and launches its queued events. */
+	void FlushAsyncObserver(const int32 RecordIndex);
+
+	/** Stops the async observer of the removed \a Record, keeping it until its running tasks finish. */
+	void RetireAsyncObserver(LES::FObserverRecord& Record);
 };
 
 template <typename TEvent, typename TObserver, typename TCallback>
@@ -284,7 +1256,8 @@ template <typename TEvent, typename TObserver, typename TCallback>
 	TIsDerivedFrom<TEvent, ULES_Event>::Value &&
 	!TIsSame<TEvent, ULES_Event>::Value &&
 	LES::IsMethodEventHandler<TObserver, TCallback, TEvent>
-FLES_ObserverHandle ULES_EventSystem::AddObserver(TObserver* Observer, TCallback Callback, const FName Channel)
+FLES_ObserverHandle ULES_EventSystem::AddObserver(TObserver* Observer, TCallback Callback, const FName Channel,
+                                                  const FLES_StreamOperators& Operators, const FName Group)
 {
 	if (!IsValid(Observer)) return {};
 
@@ -293,7 +1266,7 @@ FLES_ObserverHandle ULES_EventSystem::AddObserver(TObserver* Observer, TCallback
 		if (Observer.IsValid())
 			(Observer.Get()->*Callback)(static_cast<TEvent*>(Event));
 	};
-	return AddObserver_Private(TEvent::StaticClass(), Observer, CallbackLambda, Channel);
+	return AddObserver_Private(TEvent::StaticClass(), Observer, MoveTemp(CallbackLambda), Channel, Operators, Group);
 }
 
 template <typename TEvent, typename TObserver, typename TCallback>
@@ -301,7 +1274,8 @@ template <typename TEvent, typename TObserver, typename TCallback>
 	TIsDerivedFrom<TEvent, ULES_Event>::Value &&
 	!TIsSame<TEvent, ULES_Event>::Value &&
 	LES::IsFunctorEventHandler<TCallback, TEvent>
-FLES_ObserverHandle ULES_EventSystem::AddObserver(TObserver* Observer, TCallback Callback, const FName Channel)
+FLES_ObserverHandle ULES_EventSystem::AddObserver(TObserver* Observer, TCallback Callback, const FName Channel,
+                                                  const FLES_StreamOperators& Operators, const FName Group)
 {
 	if (!IsValid(Observer)) return {};
 
@@ -310,5 +1284,201 @@ FLES_ObserverHandle ULES_EventSystem::AddObserver(TObserver* Observer, TCallback
 		if (Observer.IsValid())
 			Callback(static_cast<TEvent*>(Event));
 	};
-	return AddObserver_Private(TEvent::StaticClass(), Observer, CallbackLambda, Channel);
+	return AddObserver_Private(TEvent::StaticClass(), Observer, MoveTemp(CallbackLambda), Channel, Operators, Group);
+}
+
+template <typename TEvent, typename TObserver, typename TCallback>
+	requires TIsDerivedFrom<TObserver, UObject>::Value &&
+	TIsDerivedFrom<TEvent, ULES_Event>::Value &&
+	!TIsSame<TEvent, ULES_Event>::Value &&
+	LES::IsMethodBatchHandler<TObserver, TCallback, TEvent>
+FLES_ObserverHandle ULES_EventSystem::AddBatchObserver(TObserver* Observer, TCallback Callback, const FName Channel,
+                                                       const int32 MaxBatchSize, const FName Group)
+{
+	if (!IsValid(Observer)) return {};
+
+	// The bucket holds exactly the events of the TEvent class, so the view of the events is reinterpreted in place.
+	auto CallbackLambda = [Observer = TWeakObjectPtr<TObserver>(Observer), Callback](
+		const TArrayView<ULES_Event* const> Batch)
+	{
+		if (Observer.IsValid())
+			(Observer.Get()->*Callback)(MakeArrayView(reinterpret_cast<const TEvent* const*>(Batch.GetData()),
+			                                          Batch.Num()));
+	};
+	return AddBatchObserver_Private(TEvent::StaticClass(), Observer, MoveTemp(CallbackLambda), Channel, MaxBatchSize,
+	                                Group);
+}
+
+template <typename TEvent, typename TObserver, typename TCallback>
+	requires TIsDerivedFrom<TObserver, UObject>::Value &&
+	TIsDerivedFrom<TEvent, ULES_Event>::Value &&
+	!TIsSame<TEvent, ULES_Event>::Value &&
+	LES::IsFunctorBatchHandler<TCallback, TEvent>
+FLES_ObserverHandle ULES_EventSystem::AddBatchObserver(TObserver* Observer, TCallback Callback, const FName Channel,
+                                                       const int32 MaxBatchSize, const FName Group)
+{
+	if (!IsValid(Observer)) return {};
+
+	auto CallbackLambda = [Observer = TWeakObjectPtr<TObserver>(Observer), Callback](
+		const TArrayView<ULES_Event* const> Batch)
+	{
+		if (Observer.IsValid())
+			Callback(MakeArrayView(reinterpret_cast<const TEvent* const*>(Batch.GetData()), Batch.Num()));
+	};
+	return AddBatchObserver_Private(TEvent::StaticClass(), Observer, MoveTemp(CallbackLambda), Channel, MaxBatchSize,
+	                                Group);
+}
+
+template <typename TEvent, typename TObserver, typename TCallback>
+	requires TIsDerivedFrom<TObserver, UObject>::Value &&
+	TIsDerivedFrom<TEvent, ULES_Event>::Value &&
+	!TIsSame<TEvent, ULES_Event>::Value &&
+	LES::IsFunctorEventHandler<TCallback, TEvent>
+FLES_ObserverHandle ULES_EventSystem::AddConcurrentObserver(TObserver* Observer, TCallback Callback,
+                                                            const FName Channel)
+{
+	if (!IsValid(Observer)) return {};
+
+	// The record and the concurrent dispatch get their own copies, since the concurrent one outlives the record until
+	// the other threads are done with it. Off the game thread, the observer is only checked for being destroyed. The
+	// callback never gets it, so it may be destroyed during the call. The callback's captures live until no send can
+	// reach them anymore.
+	auto CallbackLambda = [Observer = TWeakObjectPtr<TObserver>(Observer), Callback](ULES_Event* Event)
+	{
+		if (Observer.IsValid(false, true))
+			Callback(static_cast<TEvent*>(Event));
+	};
+	return AddConcurrentObserver_Private(TEvent::StaticClass(), Observer, CallbackLambda, CallbackLambda, Channel);
+}
+
+template <typename TEvent, typename TObserver, typename TCallback>
+	requires TIsDerivedFrom<TObserver, UObject>::Value &&
+	TIsDerivedFrom<TEvent, ULES_Event>::Value &&
+	!TIsSame<TEvent, ULES_Event>::Value &&
+	LES::IsMethodEventHandler<TObserver, TCallback, TEvent>
+FLES_ObserverHandle ULES_EventSystem::AddClassObserver(TCallback Callback, const FName Channel, const FName Group)
+{
+	// Lists have stable addresses, and outlive the records using them: a list is dropped only when its class is
+	// destroyed, and the records of a destroyed class aren't notified anymore.
+	auto CallbackLambda = [Instances = &FindOrAddClassInstances(TObserver::StaticClass()), Callback](ULES_Event* Event)
+	{
+		Instances->ForEach([Event, Callback](UObject* Instance)
+		{
+			(static_cast<TObserver*>(Instance)->*Callback)(static_cast<TEvent*>(Event));
+		});
+	};
+	return AddObserver_Private(TEvent::StaticClass(), TObserver::StaticClass(), MoveTemp(CallbackLambda), Channel, {},
+	                           Group);
+}
+
+template <typename TEvent, typename TResult, typename TObserver, typename TCallback>
+	requires TIsDerivedFrom<TObserver, UObject>::Value &&
+	TIsDerivedFrom<TEvent, ULES_Event>::Value &&
+	!TIsSame<TEvent, ULES_Event>::Value &&
+	(LES::IsMethodQueryHandler<TObserver, TCallback, TEvent, TResult> ||
+		LES::IsFunctorQueryHandler<TCallback, TEvent, TResult>)
+FLES_ObserverHandle ULES_EventSystem::AddQueryObserver(TObserver* Observer, TCallback Callback, const FName Channel,
+                                                       const FName Group)
+{
+	if (!IsValid(Observer)) return {};
+
+	// The active query is matched by its event, so that the events sent normally, and the deferred deliveries of
+	// earlier queries, aren't answered. Queries sent with another result type are skipped, since the result couldn't
+	// be cast to the handler's type.
+	auto CallbackLambda = [this, Observer = TWeakObjectPtr<TObserver>(Observer), Callback](ULES_Event* Event)
+	{
+		if (!ActiveQuery || ActiveQuery->Event != Event || !Observer.IsValid()) return;
+		if (!ensureMsgf(ActiveQuery->ResultTypeId == LES::TQueryResult<TResult>::TypeId,
+		                TEXT("Query of %s was sent with a different result type than its handlers answer with."),
+		                *GetNameSafe(Event->GetClass())))
+		{
+			return;
+		}
+
+		LES::TQueryResult<TResult>& Result = static_cast<LES::TQueryResult<TResult>&>(*ActiveQuery);
+		if constexpr (LES::IsMethodQueryHandler<TObserver, TCallback, TEvent, TResult>)
+			(Observer.Get()->*Callback)(static_cast<TEvent*>(Event), Result);
+		else
+			Callback(static_cast<TEvent*>(Event), Result);
+	};
+	return AddObserver_Private(TEvent::StaticClass(), Observer, MoveTemp(CallbackLambda), Channel, {}, Group);
+}
+
+template <typename TResult>
+LES::TQueryResult<TResult> ULES_EventSystem::Query(ULES_Event* Event, const ELES_QueryReducer Reducer)
+{
+	LES::TQueryResult<TResult> Result;
+	Result.Event = Event;
+	Result.Reducer = Reducer;
+	SendQuery(Event, Result);
+	return Result;
+}
+
+template <typename TEvent, typename TObserver, typename TWork, typename TCompletion>
+	requires TIsDerivedFrom<TObserver, UObject>::Value &&
+	TIsDerivedFrom<TEvent, ULES_Event>::Value &&
+	!TIsSame<TEvent, ULES_Event>::Value &&
+	LES::IsFunctorEventHandler<TWork, TEvent> &&
+	(LES::IsMethodEventHandler<TObserver, TCompletion, TEvent> || LES::IsFunctorEventHandler<TCompletion, TEvent>)
+FLES_ObserverHandle ULES_EventSystem::AddAsyncObserver(TObserver* Observer, TWork Work, TCompletion Completion,
+                                                       const FName Channel, const int32 MaxTasksInFlight,
+                                                       const FName Group)
+{
+	if (!IsValid(Observer)) return {};
+
+	// The work runs on worker threads, where the observer is only checked for being destroyed.
+	auto WorkLambda = [Observer = TWeakObjectPtr<TObserver>(Observer), Work](ULES_Event* Event)
+	{
+		if (Observer.IsValid(false, true))
+			Work(static_cast<TEvent*>(Event));
+	};
+	auto CompletionLambda = [Observer = TWeakObjectPtr<TObserver>(Observer), Completion](ULES_Event* Event)
+	{
+		if (!Observer.IsValid()) return;
+		if constexpr (LES::IsMethodEventHandler<TObserver, TCompletion, TEvent>)
+			(Observer.Get()->*Completion)(static_cast<TEvent*>(Event));
+		else
+			Completion(static_cast<TEvent*>(Event));
+	};
+	return AddAsyncObserver_Private(TEvent::StaticClass(), Observer, MoveTemp(WorkLambda), MoveTemp(CompletionLambda),
+	                                Channel, MaxTasksInFlight, Group);
+}
+
+template <typename TEvent, typename TObserver, typename TWork>
+	requires TIsDerivedFrom<TObserver, UObject>::Value &&
+	TIsDerivedFrom<TEvent, ULES_Event>::Value &&
+	!TIsSame<TEvent, ULES_Event>::Value &&
+	LES::IsFunctorEventHandler<TWork, TEvent>
+FLES_ObserverHandle ULES_EventSystem::AddAsyncObserver(TObserver* Observer, TWork Work, const FName Channel,
+                                                       const int32 MaxTasksInFlight, const FName Group)
+{
+	if (!IsValid(Observer)) return {};
+
+	auto WorkLambda = [Observer = TWeakObjectPtr<TObserver>(Observer), Work](ULES_Event* Event)
+	{
+		if (Observer.IsValid(false, true))
+			Work(static_cast<TEvent*>(Event));
+	};
+	return AddAsyncObserver_Private(TEvent::StaticClass(), Observer, MoveTemp(WorkLambda), {}, Channel,
+	                                MaxTasksInFlight, Group);
+}
+
+template <typename TEvent, typename TFactory>
+	requires TIsDerivedFrom<TEvent, ULES_Event>::Value &&
+	std::is_convertible_v<std::invoke_result_t<TFactory>, TEvent*>
+bool ULES_EventSystem::SendEventLazy(const FName Channel, TFactory&& Factory)
+{
+	const int32 BucketIndex = FindObservedBucketForLazySend(TEvent::StaticClass(), Channel);
+	if (BucketIndex == INDEX_NONE) return false;
+
+	TEvent* Event = Invoke(Forward<TFactory>(Factory));
+	if (!IsValid(Event)) return false;
+
+	// The bucket found up front is reused, unless the factory returned an event of a subclass.
+	Event->Channel = Channel;
+	if (Event->GetClass() == TEvent::StaticClass())
+		SendEventToBucket(BucketIndex, Event);
+	else
+		SendEvent(Event);
+	return true;
 }
@@ -0,0 +1,66 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#pragma once
+
+#include "Event.h"
+#include "Engine/DeveloperSettings.h"
+#include "EventSystemSettings.generated.h"
+
+class ULES_EventSystem;
+
+/** Observers expected to listen for an event class on a channel. */
+USTRUCT()
+struct FLES_ExpectedObservers
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, Category = "Capacity")
+	TSoftClassPtr<ULES_Event> EventClass;
+
+	UPROPERTY(EditAnywhere, Category = "Capacity")
+	FName Channel = NAME_None;
+
+	/** Amount of observers expected at once. */
+	UPROPERTY(EditAnywhere, Category = "Capacity", Meta = (ClampMin = 0))
+	int32 NumObservers = 0;
+};
+
+/**
+ * Capacity of the global Event System, reserved by the Event Subsystem when it's initialized. Sizing the tables up
+ * front keeps the first few thousand observers added when a level starts from growing them, which would show up as a
+ * hitch. Compare the configured values with the actual peak use with the LES.Usage console command.
+ */
+UCLASS(Config = Game, DefaultConfig, Meta = (DisplayName = "Light Event System"))
+class LIGHTEVENTSYSTEM_API ULES_EventSystemSettings : public UDeveloperSettings
+{
+	GENERATED_BODY()
+
+public:
+	/** Amount of observer records expected at once. At least the sum of the \a ExpectedObservers is reserved. */
+	UPROPERTY(Config, EditAnywhere, Category = "Capacity", Meta = (ClampMin = 0))
+	int32 ExpectedNumObservers = 0;
+
+	/** Amount of pairs of event classes and channels expected. At least the \a ExpectedObservers are reserved. */
+	UPROPERTY(Config, EditAnywhere, Category = "Capacity", Meta = (ClampMin = 0))
+	int32 ExpectedNumBuckets = 0;
+
+	/** Event classes and channels whose buckets are created up front, with room for their observers. */
+	UPROPERTY(Config, EditAnywhere, Category = "Capacity")
+	TArray<FLES_ExpectedObservers> ExpectedObservers;
+
+	/**
+	 * If true, the expected event classes are loaded and an event of each is created and discarded, so that the first
+	 * sends at the level start don't pay for the first construction of their classes.
+	 */
+	UPROPERTY(Config, EditAnywhere, Category = "Capacity")
+	bool bWarmUpEventClasses = false;
+
+	/** If true, the usage report of the global Event System is logged when the game instance shuts down. */
+	UPROPERTY(Config, EditAnywhere, Category = "Capacity")
+	bool bLogUsageReport = false;
+
+	/** Reserves the configured capacity in the \a EventSystem. */
+	void ApplyTo(ULES_EventSystem* EventSystem) const;
+
+	virtual FName GetCategoryName() const override { return TEXT("Plugins"); }
+};
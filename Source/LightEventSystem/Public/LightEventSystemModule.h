@@ -5,6 +5,8 @@
 #include "CoreMinimal.h"
 #include "Modules/ModuleManager.h"
 
+LIGHTEVENTSYSTEM_API DECLARE_LOG_CATEGORY_EXTERN(LogLightEventSystem, Log, All);
+
 class FLightEventSystemModule : public IModuleInterface
 {
 public:
@@ -0,0 +1,106 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#pragma once
+
+#include "Event.h"
+#include "Templates/SubclassOf.h"
+#include "MemoryReport.generated.h"
+
+/** Describes the memory used by an Event System and the memory it has reclaimed so far. */
+USTRUCT(BlueprintType)
+struct FLES_MemoryReport
+{
+	GENERATED_BODY()
+
+	/** Amount of dispatch buckets, one per listened-to or sent-with-token pair of an event class and a channel. */
+	UPROPERTY(BlueprintReadOnly, Category = "Memory Report")
+	int32 NumBuckets = 0;
+
+	/** Amount of observer records. */
+	UPROPERTY(BlueprintReadOnly, Category = "Memory Report")
+	int32 NumRecords = 0;
+
+	/** Estimated amount of bytes allocated for the buckets and the observer records. */
+	UPROPERTY(BlueprintReadOnly, Category = "Memory Report")
+	int64 AllocatedBytes = 0;
+
+	/** Amount of observer record slots in the arena, used or waiting for reuse. */
+	UPROPERTY(BlueprintReadOnly, Category = "Memory Report")
+	int32 RecordCapacity = 0;
+
+	/** Amount of bytes allocated for the observer record arena, included in \a AllocatedBytes. */
+	UPROPERTY(BlueprintReadOnly, Category = "Memory Report")
+	int64 RecordArenaBytes = 0;
+
+	/** Amount of bucket slots cleared during a dispatch and still waiting for the bucket to be compacted. */
+	UPROPERTY(BlueprintReadOnly, Category = "Memory Report")
+	int32 NumClearedSlots = 0;
+
+	/** Amount of observer callbacks too large to be stored inside their records, allocated on the heap instead. */
+	UPROPERTY(BlueprintReadOnly, Category = "Memory Report")
+	int32 NumHeapCallbacks = 0;
+
+	/** Amount of buckets purged because their event class has been unloaded. */
+	UPROPERTY(BlueprintReadOnly, Category = "Memory Report")
+	int32 NumPurgedBuckets = 0;
+
+	/** Amount of observer records purged together with their buckets. */
+	UPROPERTY(BlueprintReadOnly, Category = "Memory Report")
+	int32 NumPurgedRecords = 0;
+
+	/** Estimated amount of bytes reclaimed by purging the buckets. */
+	UPROPERTY(BlueprintReadOnly, Category = "Memory Report")
+	int64 ReclaimedBytes = 0;
+};
+
+/** Capacity reserved for the observers of an event class on a channel, compared with its actual use. */
+USTRUCT(BlueprintType)
+struct FLES_BucketUsage
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Usage Report")
+	TSubclassOf<ULES_Event> EventClass;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Usage Report")
+	FName Channel = NAME_None;
+
+	/** Amount of observer records the bucket has been reserved for. */
+	UPROPERTY(BlueprintReadOnly, Category = "Usage Report")
+	int32 ReservedRecords = 0;
+
+	/** Largest amount of observer records the bucket has had at once. */
+	UPROPERTY(BlueprintReadOnly, Category = "Usage Report")
+	int32 PeakRecords = 0;
+
+	/** Amount of observer records in the bucket now. */
+	UPROPERTY(BlueprintReadOnly, Category = "Usage Report")
+	int32 NumRecords = 0;
+};
+
+/** Compares the capacity reserved in an Event System with its peak use. See \a ULES_EventSystem::Reserve. */
+USTRUCT(BlueprintType)
+struct FLES_UsageReport
+{
+	GENERATED_BODY()
+
+	/** Amount of observer records reserved up front. */
+	UPROPERTY(BlueprintReadOnly, Category = "Usage Report")
+	int32 ReservedRecords = 0;
+
+	/** Largest amount of observer records the Event System has had at once. */
+	UPROPERTY(BlueprintReadOnly, Category = "Usage Report")
+	int32 PeakRecords = 0;
+
+	/** Amount of dispatch buckets reserved up front. */
+	UPROPERTY(BlueprintReadOnly, Category = "Usage Report")
+	int32 ReservedBuckets = 0;
+
+	/** Largest amount of dispatch buckets the Event System has had at once. */
+	UPROPERTY(BlueprintReadOnly, Category = "Usage Report")
+	int32 PeakBuckets = 0;
+
+	/** Usage of the buckets reserved with \a ULES_EventSystem::ReserveObservers. */
+	UPROPERTY(BlueprintReadOnly, Category = "Usage Report")
+	TArray<FLES_BucketUsage> Buckets;
+};
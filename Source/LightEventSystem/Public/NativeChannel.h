@@ -0,0 +1,70 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace LES
+{
+	/**
+	 * Channel identifier declared in native code. Use the \a LES_DECLARE_CHANNEL and \a LES_DEFINE_CHANNEL macros
+	 * instead of constructing it directly. Native channels are registered during static initialization, and their names
+	 * are created when the Light Event System module starts up, or right away for modules loaded later on. Example
+	 * usage:
+	 *
+	 * // MyChannels.h\n
+	 * MYMODULE_API LES_DECLARE_CHANNEL(Channel_AlertRaised);\n
+	 *
+	 * // MyChannels.cpp\n
+	 * LES_DEFINE_CHANNEL(Channel_AlertRaised, "AlertRaised");\n
+	 *
+	 * EventSystem->AddObserver<UMyEvent>(Observer, &UObserver::OnMyEvent, Channel_AlertRaised);
+	 */
+	class LIGHTEVENTSYSTEM_API FNativeChannel
+	{
+	public:
+		explicit FNativeChannel(const TCHAR* InChannelName);
+		~FNativeChannel();
+
+		FNativeChannel(const FNativeChannel&) = delete;
+		FNativeChannel& operator=(const FNativeChannel&) = delete;
+
+		/** Returns the name of the channel. */
+		FName GetName() const
+		{
+			if (!bResolved) Resolve();
+			return Name;
+		}
+
+		operator FName() const { return GetName(); }
+
+		/** Creates the names of all channels registered so far. Called by the module on startup. */
+		static void ResolveRegisteredChannels();
+
+		/** Appends the names of all native channels to \a OutChannels. */
+		static void GetRegisteredChannels(TArray<FName>& OutChannels);
+
+	private:
+		const TCHAR* ChannelName;
+		mutable FName Name = NAME_None;
+		mutable bool bResolved = false;
+
+		FNativeChannel* Next = nullptr;
+
+		void Resolve() const;
+
+		/** Head of the intrusive list of registered channels. Doesn't allocate, so it's safe during static init. */
+		static FNativeChannel*& GetHead();
+		static bool bModuleStarted;
+	};
+}
+
+/** Declares a native channel defined elsewhere with \a LES_DEFINE_CHANNEL. Prefix it with your module's API macro. */
+#define LES_DECLARE_CHANNEL(ChannelVariable) extern LES::FNativeChannel ChannelVariable
+
+/** Defines a native channel named \a ChannelString, accessible through the \a ChannelVariable. */
+#define LES_DEFINE_CHANNEL(ChannelVariable, ChannelString) LES::FNativeChannel ChannelVariable(TEXT(ChannelString))
+
+/** Defines a native channel visible only in the current translation unit. */
+#define LES_DEFINE_CHANNEL_STATIC(ChannelVariable, ChannelString) \
+	static LES::FNativeChannel ChannelVariable(TEXT(ChannelString))
@@ -0,0 +1,142 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#pragma once
+
+#include "Event.h"
+#include <type_traits>
+
+namespace LES
+{
+	/**
+	 * Type-erased event handler. Unlike TFunction, handlers up to \a InlineSize bytes are stored inside the callback, so
+	 * the usual handlers (a weak observer pointer with a method pointer, a delegate or a few references) don't allocate.
+	 * Larger handlers are moved to the heap.
+	 */
+	class FObserverCallback
+	{
+	public:
+		static constexpr SIZE_T InlineSize = 40;
+		static constexpr SIZE_T InlineAlignment = 16;
+
+		FObserverCallback() = default;
+
+		template <typename TFunctor>
+			requires (!TIsSame<std::decay_t<TFunctor>, FObserverCallback>::Value) &&
+			std::is_invocable_v<std::decay_t<TFunctor>&, ULES_Event*>
+		FObserverCallback(TFunctor&& Functor)
+		{
+			using T = std::decay_t<TFunctor>;
+			if constexpr (IsStoredInline<T>())
+			{
+				new(Storage) T(Forward<TFunctor>(Functor));
+				Ops = &TInlineOps<T>::Ops;
+			}
+			else
+			{
+				*reinterpret_cast<T**>(Storage) = new T(Forward<TFunctor>(Functor));
+				Ops = &THeapOps<T>::Ops;
+			}
+		}
+
+		FObserverCallback(FObserverCallback&& Other)
+		{
+			MoveFrom(Other);
+		}
+
+		FObserverCallback& operator=(FObserverCallback&& Other)
+		{
+			if (this != &Other)
+			{
+				Reset();
+				MoveFrom(Other);
+			}
+			return *this;
+		}
+
+		FObserverCallback(const FObserverCallback&) = delete;
+		FObserverCallback& operator=(const FObserverCallback&) = delete;
+
+		~FObserverCallback()
+		{
+			Reset();
+		}
+
+		void operator()(ULES_Event* Event) const
+		{
+			Ops->Invoke(const_cast<uint8*>(Storage), Event);
+		}
+
+		explicit operator bool() const { return Ops != nullptr; }
+
+		void Reset()
+		{
+			if (Ops)
+			{
+				Ops->Destroy(Storage);
+				Ops = nullptr;
+			}
+		}
+
+		/** Returns the amount of bytes allocated on the heap for the handler. Zero if it's stored inline. */
+		SIZE_T GetAllocatedSize() const { return Ops && !Ops->bInline ? Ops->Size : 0; }
+
+	private:
+		struct FOps
+		{
+			void (*Invoke)(void* Storage, ULES_Event* Event);
+			void (*Move)(void* Destination, void* Source);
+			void (*Destroy)(void* Storage);
+			SIZE_T Size;
+			bool bInline;
+		};
+
+		template <typename T>
+		static constexpr bool IsStoredInline()
+		{
+			return sizeof(T) <= InlineSize && alignof(T) <= InlineAlignment && std::is_nothrow_move_constructible_v<T>;
+		}
+
+		template <typename T>
+		struct TInlineOps
+		{
+			static void Invoke(void* Storage, ULES_Event* Event) { (*static_cast<T*>(Storage))(Event); }
+
+			static void Move(void* Destination, void* Source)
+			{
+				new(Destination) T(MoveTemp(*static_cast<T*>(Source)));
+				static_cast<T*>(Source)->~T();
+			}
+
+			static void Destroy(void* Storage) { static_cast<T*>(Storage)->~T(); }
+
+			static constexpr FOps Ops{&Invoke, &Move, &Destroy, sizeof(T), true};
+		};
+
+		template <typename T>
+		struct THeapOps
+		{
+			static T*& Get(void* Storage) { return *static_cast<T**>(Storage); }
+
+			static void Invoke(void* Storage, ULES_Event* Event) { (*Get(Storage))(Event); }
+
+			static void Move(void* Destination, void* Source) { *static_cast<T**>(Destination) = Get(Source); }
+
+			static void Destroy(void* Storage) { delete Get(Storage); }
+
+			static constexpr FOps Ops{&Invoke, &Move, &Destroy, sizeof(T), false};
+		};
+
+		alignas(InlineAlignment) uint8 Storage[InlineSize];
+		const FOps* Ops = nullptr;
+
+		void MoveFrom(FObserverCallback& Other)
+		{
+			if (Other.Ops)
+			{
+				Other.Ops->Move(Storage, Other.Storage);
+				Ops = Other.Ops;
+				Other.Ops = nullptr;
+			}
+		}
+	};
+}
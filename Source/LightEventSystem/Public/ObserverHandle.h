@@ -2,16 +2,50 @@
 
 #pragma once
 
+#include "AsyncObserver.h"
 #include "Event.h"
+#include "EventMailbox.h"
+#include "ObserverCallback.h"
+#include "StreamOperators.h"
 #include "ObserverHandle.generated.h"
 
+class ULES_EventSystem;
+
 namespace LES
 {
+	/** Observer listening in a bucket. The event class and the channel are known from the bucket. */
 	struct FObserverRecord
 	{
-		FName Channel = NAME_None;
 		TWeakObjectPtr<> Observer = nullptr;
-		TFunction<void(ULES_Event*)> Callback = nullptr;
+		FObserverCallback Callback;
+		TUniquePtr<FStreamOperatorState> Operators = nullptr;
+
+		/** Set if the observer receives its events in batches. The \a Callback isn't used then. */
+		TUniquePtr<FEventMailbox> Mailbox = nullptr;
+
+		/** Set if the observer handles its events in tasks. The \a Callback isn't used then. */
+		TUniquePtr<FAsyncObserver> AsyncObserver = nullptr;
+
+		/** Entry in the bucket's spatial hash if the observer has a spatial filter, or INDEX_NONE. */
+		int32 SpatialEntry = INDEX_NONE;
+
+		/** Index of the observer group in the Event System. */
+		int32 Group = 0;
+
+		/** Return address of the registration, naming the native handler in the watchdog's log. */
+		const void* CallSite = nullptr;
+
+		/** Name of the blueprint handler, used by the watchdog's log instead of the \a CallSite. */
+		FName CallbackName = NAME_None;
+
+		/** Set if the events are queued and delivered when the Event System is ticked, instead of right away. */
+		bool bDeferred = false;
+
+		/** Set if the observer also receives the events sent from other threads, see \a FConcurrentDispatcher. */
+		bool bConcurrent = false;
+
+		/** Bumped when the record is removed, so the handles of the removed record become invalid. */
+		uint32 Serial = 0;
 	};
 }
 
@@ -28,5 +62,10 @@ struct FLES_ObserverHandle
 	/** Listened-to event class and the channel */
 	TPair<TWeakObjectPtr<UClass>, FName> ObserverKey = {nullptr, NAME_None};
 
-	TWeakPtr<LES::FObserverRecord> ObserverRecord = nullptr;
+	/** Event System owning the record. Weak, so that the handles can be validated without it. */
+	TWeakObjectPtr<const ULES_EventSystem> EventSystem = nullptr;
+
+	/** Index of the record in the Event System's arena, and the serial of the slot when the record was added. */
+	int32 RecordIndex = INDEX_NONE;
+	uint32 RecordSerial = 0;
 };
@@ -0,0 +1,55 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#pragma once
+
+#include "ObserverHandle.h"
+
+namespace LES
+{
+	/**
+	 * Arena of observer records, allocated in fixed-size chunks, so the records have stable addresses and lie close to
+	 * each other in memory. Records are referred to by their index. Each slot has a serial, bumped when its record is
+	 * removed, which lets the handles detect removed records without reference counting.
+	 */
+	class LIGHTEVENTSYSTEM_API FObserverPool
+	{
+	public:
+		static constexpr int32 RecordsPerChunk = 256;
+
+		/** Returns the index of an empty record, reusing the released slots first. */
+		int32 Allocate();
+
+		/** Allocates the chunks for at least \a NumRecords records up front, so that allocating them doesn't grow. */
+		void Reserve(const int32 NumRecords);
+
+		/** Marks the record as removed, invalidating its handles. The record stays allocated until it's released. */
+		void Invalidate(const int32 Index);
+
+		/** Clears the record and makes its slot available for reuse. */
+		void Release(const int32 Index);
+
+		/** Returns true if the record at the \a Index is allocated and hasn't been removed since the \a Serial. */
+		bool IsValid(const int32 Index, const uint32 Serial) const;
+
+		FObserverRecord& operator[](const int32 Index)
+		{
+			return Chunks[Index / RecordsPerChunk][Index % RecordsPerChunk];
+		}
+
+		const FObserverRecord& operator[](const int32 Index) const
+		{
+			return Chunks[Index / RecordsPerChunk][Index % RecordsPerChunk];
+		}
+
+		/** Amount of record slots allocated, used or free. */
+		int32 GetCapacity() const { return NumSlots; }
+
+		/** Returns the amount of bytes allocated for the chunks and the bookkeeping. */
+		SIZE_T GetAllocatedSize() const;
+
+	private:
+		TArray<TUniquePtr<FObserverRecord[]>> Chunks;
+		TArray<int32> FreeSlots;
+		int32 NumSlots = 0;
+	};
+}
@@ -0,0 +1,184 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#pragma once
+
+#include "Event.h"
+#include <type_traits>
+#include "QueryResult.generated.h"
+
+/** Determines how the answers of the query handlers are combined into the result of a query. */
+UENUM(BlueprintType)
+enum class ELES_QueryReducer : uint8
+{
+	/** The result is true if all answers are true. The query stops at the first false answer. */
+	And,
+	/** The result is true if any answer is true. The query stops at the first true answer. */
+	Or,
+	/** The result is the sum of the answers. */
+	Sum,
+	/** The result is the smallest of the answers. */
+	Min,
+	/** The result is the largest of the answers. */
+	Max,
+	/** The answers are collected in the order they were given. */
+	Collect,
+};
+
+namespace LES
+{
+	/**
+	 * Returns the id of the \a T type, hashed from its name. The address of a static variable wouldn't do, since the
+	 * statics of templates differ between modules, and a query may be sent from another module than its handlers.
+	 */
+	template <typename T>
+	constexpr uint64 GetQueryResultTypeId()
+	{
+#if defined(_MSC_VER) && !defined(__clang__)
+		const char* Signature = __FUNCSIG__;
+#else
+		const char* Signature = __PRETTY_FUNCTION__;
+#endif
+		uint64 Hash = 0xcbf29ce484222325ull;
+		for (const char* Character = Signature; *Character; Character++)
+			Hash = (Hash ^ static_cast<uint8>(*Character)) * 0x100000001b3ull;
+		return Hash;
+	}
+
+	/** Part of the query result that doesn't depend on the type of the answers. */
+	struct FQueryState
+	{
+		/** The event the query was sent with. Handlers answer only while it's being dispatched. */
+		const ULES_Event* Event = nullptr;
+
+		/** Type of the answers, checked by the handlers before they answer. See \a GetQueryResultTypeId. */
+		uint64 ResultTypeId = 0;
+
+		ELES_QueryReducer Reducer = ELES_QueryReducer::Collect;
+		int32 NumAnswers = 0;
+
+		/** Once set, the remaining observers aren't asked. */
+		bool bDone = false;
+	};
+
+	/**
+	 * Accumulator of the answers to a query, reduced in place as the handlers answer. See
+	 * \a ULES_EventSystem::Query.
+	 */
+	template <typename TResult>
+	class TQueryResult : public FQueryState
+	{
+	public:
+		/** Id of the \a TResult type, computed at compile time. */
+		static constexpr uint64 TypeId = GetQueryResultTypeId<TResult>();
+
+		TQueryResult() { ResultTypeId = TypeId; }
+
+		/**
+		 * Reduces the \a Answer into the result. Ignored once the query is done, and if the answers can't be reduced
+		 * with the query's reducer, like the answers that aren't convertible to bool for an AND query.
+		 */
+		void Add(const TResult& Answer)
+		{
+			if (bDone) return;
+			if (!ensureMsgf(SupportsReducer(Reducer), TEXT("The answers of the query can't be reduced with %s."),
+			                *UEnum::GetValueAsString(Reducer)))
+			{
+				return;
+			}
+
+			const bool bFirst = NumAnswers == 0;
+			switch (Reducer)
+			{
+			case ELES_QueryReducer::And:
+			case ELES_QueryReducer::Or:
+				if constexpr (bSupportsLogic)
+				{
+					// The first answer that decides the result ends the query.
+					const bool bAnd = Reducer == ELES_QueryReducer::And;
+					if (bFirst || static_cast<bool>(Value) == bAnd)
+						Value = Answer;
+					bDone = static_cast<bool>(Value) != bAnd;
+				}
+				break;
+			case ELES_QueryReducer::Sum:
+				if constexpr (bSupportsSum)
+				{
+					if (bFirst)
+						Value = Answer;
+					else
+						Value += Answer;
+				}
+				break;
+			case ELES_QueryReducer::Min:
+			case ELES_QueryReducer::Max:
+				if constexpr (bSupportsComparison)
+				{
+					const bool bMin = Reducer == ELES_QueryReducer::Min;
+					if (bFirst || (bMin ? Answer < Value : Value < Answer))
+						Value = Answer;
+				}
+				break;
+			case ELES_QueryReducer::Collect:
+				Values.Add(Answer);
+				break;
+			}
+			NumAnswers++;
+		}
+
+		/** Stops the query, so that the remaining observers aren't asked. */
+		void Stop() { bDone = true; }
+
+		/** Returns true if any handler has answered. */
+		bool HasValue() const { return NumAnswers > 0; }
+
+		/**
+		 * Returns the reduced result, or the \a Default if no handler has answered. Unused for the collecting
+		 * queries, see \a GetValues.
+		 */
+		TResult Get(const TResult& Default = TResult()) const { return NumAnswers > 0 ? Value : Default; }
+
+		/** Returns the answers of the collecting query, in the order they were given. */
+		const TArray<TResult>& GetValues() const { return Values; }
+
+		/** Returns true if the answers can be reduced with the \a InReducer. */
+		static constexpr bool SupportsReducer(const ELES_QueryReducer InReducer)
+		{
+			switch (InReducer)
+			{
+			case ELES_QueryReducer::And:
+			case ELES_QueryReducer::Or:
+				return bSupportsLogic;
+			case ELES_QueryReducer::Sum:
+				return bSupportsSum;
+			case ELES_QueryReducer::Min:
+			case ELES_QueryReducer::Max:
+				return bSupportsComparison;
+			default:
+				return true;
+			}
+		}
+
+	private:
+		static constexpr bool bSupportsLogic = std::is_convertible_v<TResult, bool>;
+		static constexpr bool bSupportsSum = requires(TResult A) { A += A; };
+		static constexpr bool bSupportsComparison = requires(TResult A) { A < A; };
+
+		TResult Value = TResult();
+		TArray<TResult> Values;
+	};
+
+	/** Constrains the \a Callback to be a method of the \a Observer answering a query of the \a TEvent type. */
+	template <typename TObserver, typename TCallback, typename TEvent, typename TResult>
+	concept IsMethodQueryHandler = requires(TObserver Observer, TCallback Callback, TEvent* Event,
+	                                        TQueryResult<TResult>& Result)
+	{
+		(Observer.*Callback)(Event, Result);
+	};
+
+	/** Constrains the \a Callback to be a callable answering a query of the \a TEvent type. */
+	template <typename TCallback, typename TEvent, typename TResult>
+	concept IsFunctorQueryHandler = requires(TCallback Callback, TEvent* Event, TQueryResult<TResult>& Result)
+	{
+		Callback(Event, Result);
+	};
+}
@@ -0,0 +1,90 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#pragma once
+
+#include "Event.h"
+
+namespace LES
+{
+	/**
+	 * Table mapping the replicated event classes and channels to compact indices. Both ends of a connection must build
+	 * the table identically, by adding the same classes and channels in the same order.
+	 */
+	class LIGHTEVENTSYSTEM_API FReplicationTable
+	{
+	public:
+		/** Adds the \a EventClass to the table, if not added yet. Returns the class index. */
+		int32 AddEventClass(UClass* EventClass);
+
+		/** Adds the \a Channel to the table, if not added yet. Returns the channel index. */
+		int32 AddChannel(const FName Channel);
+
+		/** Returns the index of the \a EventClass, or INDEX_NONE if it's not in the table. */
+		int32 FindEventClass(const UClass* EventClass) const;
+
+		/** Returns the index of the \a Channel, or INDEX_NONE if it's not in the table. */
+		int32 FindChannel(const FName Channel) const;
+
+		/** Returns the event class at the \a Index, or nullptr if the index is invalid or the class was unloaded. */
+		UClass* GetEventClass(const int32 Index) const;
+
+		/** Returns true if the \a Index is a valid channel index. */
+		bool IsValidChannel(const int32 Index) const { return Channels.IsValidIndex(Index); }
+
+		/** Returns the channel at the \a Index. The index must be valid. */
+		FName GetChannel(const int32 Index) const { return Channels[Index]; }
+
+	private:
+		TArray<TWeakObjectPtr<UClass>> EventClasses;
+		TMap<const UClass*, int32> EventClassIndices;
+		TArray<FName> Channels;
+		TMap<FName, int32> ChannelIndices;
+	};
+
+	/**
+	 * Encodes events into a bitstream and decodes them back. Class and channel are written as indices from the shared
+	 * \a FReplicationTable. The values of the basic events are delta-compressed against the last value written on the
+	 * same class and channel, and vectors, rotators and transforms are quantized. Other events are written property by
+	 * property, with names and object references written as strings.
+	 *
+	 * The sender and the receiver must use a separate codec for each direction of each connection, and the packets must
+	 * be delivered reliably and in order, since the delta state of both ends has to stay in sync. Senders aren't
+	 * replicated.
+	 */
+	class LIGHTEVENTSYSTEM_API FEventPacketCodec
+	{
+	public:
+		/** Vectors are quantized to 1 / VectorPrecision units. */
+		static constexpr double VectorPrecision = 100.0;
+
+		explicit FEventPacketCodec(const TSharedRef<const FReplicationTable>& InTable);
+
+		/** Writes the \a Event to the \a Ar. Returns false if the event's class or channel isn't in the table. */
+		bool Write(FArchive& Ar, ULES_Event* Event);
+
+		/** Reads an event from the \a Ar, creating it in the \a Outer. Returns nullptr if the stream is corrupted. */
+		ULES_Event* Read(FArchive& Ar, UObject* Outer);
+
+		/** Clears the delta state, for example after the connection is re-established. */
+		void Reset();
+
+	private:
+		/** Last values written on a class and channel. */
+		struct FDeltaState
+		{
+			uint8 Byte = 0;
+			int64 Integer = 0;
+			float Float = 0.f;
+			double Double = 0.0;
+			FString String;
+			int64 Vector[3] = {};
+			uint16 Rotator[3] = {};
+			int64 Scale[3] = {};
+		};
+
+		TSharedRef<const FReplicationTable> Table;
+		TMap<uint64, FDeltaState> DeltaStates;
+
+		void SerializePayload(FArchive& Ar, ULES_Event* Event, FDeltaState& State);
+	};
+}
@@ -0,0 +1,99 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#pragma once
+
+#include "Event.h"
+#include "ScheduledEvents.generated.h"
+
+class ULES_EventSystem;
+
+/**
+ * Tracks an event scheduled for a delayed delivery in the Event System. You may use the handle to cancel the event
+ * before it's sent. The handle becomes invalid once the event is sent or cancelled, and only works with the Event
+ * System that scheduled the event.
+ */
+USTRUCT(BlueprintType)
+struct FLES_ScheduledEventHandle
+{
+	GENERATED_BODY()
+
+	/** The Event System that scheduled the event. Used only to compare identity, never dereferenced. */
+	const ULES_EventSystem* EventSystem = nullptr;
+
+	/** Index of the scheduled entry in the timing wheel. */
+	int32 Index = INDEX_NONE;
+
+	/** Distinguishes between the entries that reuse the same index. */
+	uint32 Serial = 0;
+};
+
+namespace LES
+{
+	/**
+	 * Hashed timing wheel holding the events scheduled for a later delivery. Time is split into ticks of a fixed length
+	 * and every tick maps onto one of the wheel's slots. Pending entries are kept in a single pooled array and linked
+	 * into the list of their slot, so scheduling and cancelling are O(1), and advancing the wheel visits only the slots
+	 * of the ticks that have passed.
+	 */
+	class LIGHTEVENTSYSTEM_API FTimingWheel
+	{
+	public:
+		/**
+		 * @param InTickLength Length of a single tick in seconds. Events are never sent early, but may be sent up to one
+		 * tick late.
+		 * @param InNumSlots Amount of slots in the wheel. Rounded up to the nearest power of two.
+		 */
+		explicit FTimingWheel(const double InTickLength = 1.0 / 60.0, const int32 InNumSlots = 512);
+
+		/** Schedules the \a Event to be returned by \a Advance once the wheel's time reaches the \a FireTime. */
+		FLES_ScheduledEventHandle Schedule(ULES_Event* Event, const double FireTime);
+
+		/** Removes the scheduled event referenced by the \a Handle. Returns false if the handle is invalid. */
+		bool Cancel(const FLES_ScheduledEventHandle& Handle);
+
+		/** Returns true if the \a Handle references an event that is still waiting to be sent. */
+		bool IsScheduled(const FLES_ScheduledEventHandle& Handle) const;
+
+		/**
+		 * Moves the wheel forward to the \a NewTime and appends all events that became due to \a OutDueEvents, ordered
+		 * by their fire time. Events with the same fire time keep the order they were scheduled in.
+		 */
+		void Advance(const double NewTime, TArray<ULES_Event*>& OutDueEvents);
+
+		/** Removes all scheduled events. */
+		void Empty();
+
+		/** Returns the amount of events waiting to be sent. */
+		int32 Num() const { return NumScheduled; }
+
+		/** Reports the scheduled events to the garbage collector, so that they are kept alive until sent. */
+		void AddReferencedObjects(FReferenceCollector& Collector);
+
+	private:
+		struct FEntry
+		{
+			TObjectPtr<ULES_Event> Event = nullptr;
+			int64 FireTick = 0;
+			uint64 Sequence = 0;
+			int32 Prev = INDEX_NONE;
+			int32 Next = INDEX_NONE;
+			uint32 Serial = 0;
+		};
+
+		double TickLength;
+		int32 SlotMask;
+		int64 ProcessedTick = 0;
+		uint64 NextSequence = 0;
+		int32 NumScheduled = 0;
+
+		TArray<FEntry> Entries;
+		TArray<int32> FreeEntries;
+		TArray<int32> SlotHeads;
+		TArray<int32> DueEntries;
+
+		int64 TimeToTick(const double Time) const;
+		void Link(const int32 Index);
+		void Unlink(const int32 Index);
+		void Release(const int32 Index);
+	};
+}
@@ -0,0 +1,37 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SendReport.generated.h"
+
+/** Whether the Event System tracks the events sent without observers. Enabled in the debug and development builds. */
+#ifndef LES_WITH_SEND_REPORT
+#define LES_WITH_SEND_REPORT (UE_BUILD_DEBUG || UE_BUILD_DEVELOPMENT)
+#endif
+
+/** Events of one class, sent on one channel from one call site, that had no observers. */
+USTRUCT(BlueprintType)
+struct FLES_UnobservedSend
+{
+	GENERATED_BODY()
+
+	/** Class of the sent events. Null if the class has been unloaded since. */
+	UPROPERTY(BlueprintReadOnly, Category = "Send Report")
+	TObjectPtr<UClass> EventClass = nullptr;
+
+	/** Channel the events were sent on. */
+	UPROPERTY(BlueprintReadOnly, Category = "Send Report")
+	FName Channel = NAME_None;
+
+	/**
+	 * Function that called the Event System, with the file and line if the symbols are available. Events sent from
+	 * Blueprints report the script thunk instead, followed by the class of the sender.
+	 */
+	UPROPERTY(BlueprintReadOnly, Category = "Send Report")
+	FString CallSite;
+
+	/** Amount of the events sent, or skipped by \a SendEventLazy, without observers. */
+	UPROPERTY(BlueprintReadOnly, Category = "Send Report")
+	int64 NumSends = 0;
+};
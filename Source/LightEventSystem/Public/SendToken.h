@@ -0,0 +1,28 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#pragma once
+
+#include "Event.h"
+#include "SendToken.generated.h"
+
+class ULES_EventSystem;
+
+/**
+ * Pre-resolved pair of an event class and a channel, pointing directly at the Event System's dispatch bucket of that
+ * pair. Sending events with a token skips hashing the class and the channel on every send. A token stays valid when
+ * observers are added or removed, but only works with the Event System it was resolved by.
+ */
+USTRUCT(BlueprintType)
+struct FLES_SendToken
+{
+	GENERATED_BODY()
+
+	/** The Event System that resolved the token. Used only to compare identity, never dereferenced. */
+	const ULES_EventSystem* EventSystem = nullptr;
+
+	/** Index of the dispatch bucket in the Event System. */
+	int32 BucketIndex = INDEX_NONE;
+
+	/** Distinguishes between the buckets that reuse the same index. */
+	uint32 BucketSerial = 0;
+};
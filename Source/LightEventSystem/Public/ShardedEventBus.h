@@ -0,0 +1,218 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#pragma once
+
+#include "EventSystem.h"
+#include "Async/Mutex.h"
+#include "HAL/Runnable.h"
+#include "ShardedEventBus.generated.h"
+
+class FRunnableThread;
+
+/**
+ * Actor-style event bus for server builds. Channels are hashed to shards, and each shard has its own Event System,
+ * owned by a dedicated thread draining the shard's inbox. Sends to different shards scale across cores, since the
+ * shards share no locks, and the events of a shard are handled in the order they were sent. Each shard's Event System
+ * is also ticked on its thread, so the scheduled and deferred events work as usual.
+ *
+ * Observers are added to the shard of their channel, and their handlers run on the shard's thread, where the garbage
+ * collector can't run. An observer listening on channels of different shards may be called on several threads at
+ * once, unless it's pinned to one shard with \a PinObserver. The deliveries to a pinned observer are forwarded to its
+ * shard, so all of its handlers run on one thread.
+ *
+ * Adding and removing observers waits until the shard's thread has done it. Shard threads may do it only on their own
+ * shard, since waiting for another shard could deadlock.
+ */
+UCLASS()
+class LIGHTEVENTSYSTEM_API ULES_ShardedEventBus : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * Creates \a NumShards shards and starts their threads.
+	 * @param TickInterval Time in seconds between the ticks of the shards' Event Systems.
+	 */
+	void Start(const int32 NumShards, const float TickInterval = 1.0f / 60.0f);
+
+	/** Handles the events waiting in the inboxes, then stops the shards' threads and removes their observers. */
+	void Stop();
+
+	bool IsRunning() const { return !Shards.IsEmpty(); }
+
+	int32 GetNumShards() const { return Shards.Num(); }
+
+	/** Returns the index of the shard handling the events sent on the \a Channel. */
+	int32 GetShard(const FName Channel) const;
+
+	/** Returns the Event System of the shard at the \a ShardIndex. Use it only on the shard's thread. */
+	ULES_EventSystem* GetShardEventSystem(const int32 ShardIndex) const;
+
+	/** Returns true if called on the thread of the shard at the \a ShardIndex. */
+	bool IsInShardThread(const int32 ShardIndex) const;
+
+	/**
+	 * Makes the handlers of the \a Observer added from now on run on the shard at the \a ShardIndex, whatever their
+	 * channel, so they're never called concurrently. Pass INDEX_NONE to unpin it.
+	 */
+	void PinObserver(const UObject* Observer, const int32 ShardIndex);
+
+	/** Returns the shard the \a Observer is pinned to, or INDEX_NONE. */
+	int32 GetPinnedShard(const UObject* Observer) const;
+
+	/** Adds the \a Observer on the shard of the \a Channel. See \a ULES_EventSystem::AddObserver. */
+	template <typename TEvent, typename TObserver, typename TCallback>
+		requires TIsDerivedFrom<TObserver, UObject>::Value &&
+		TIsDerivedFrom<TEvent, ULES_Event>::Value &&
+		!TIsSame<TEvent, ULES_Event>::Value &&
+		(LES::IsMethodEventHandler<TObserver, TCallback, TEvent> || LES::IsFunctorEventHandler<TCallback, TEvent>)
+	FLES_ObserverHandle AddObserver(TObserver* Observer, TCallback Callback, const FName Channel = NAME_None);
+
+	/** Removes the observer record referenced by the \a ObserverHandle. Returns false if there's no such record. */
+	bool RemoveByHandle(const FLES_ObserverHandle& ObserverHandle);
+
+	/** Returns the amount of observer records on all shards. */
+	int32 Num() const;
+
+	/**
+	 * Queues the \a Event in the inbox of its channel's shard. Safe to call from any thread. The event is kept alive
+	 * until it's handled, and shouldn't be modified after it's sent.
+	 */
+	void SendEvent(ULES_Event* Event);
+
+	/** Waits until the events sent so far, and the ones they caused, have been handled. Returns false on timeout. */
+	bool Flush(const double Timeout = 10.0) const;
+
+	/** Returns the amount of messages waiting in the inboxes or being handled. */
+	int32 GetNumPendingMessages() const;
+
+	static void AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector);
+	virtual void BeginDestroy() override;
+	virtual void FinishDestroy() override;
+
+private:
+	/** Delivery to an observer pinned to another shard than its channel's. Released with the observer record. */
+	struct FForwardedHandler
+	{
+		LES::FObserverCallback Callback;
+		int32 ShardIndex = INDEX_NONE;
+	};
+
+	struct FMessage
+	{
+		ULES_Event* Event = nullptr;
+
+		/** If set, the \a Event is delivered to this pinned observer instead of being sent on the Event System. */
+		TWeakPtr<FForwardedHandler, ESPMode::ThreadSafe> ForwardedHandler;
+
+		/** If set, runs on the shard's thread instead of handling an event. */
+		TFunction<void()> Command;
+	};
+
+	class FShard final : public FRunnable
+	{
+	public:
+		FShard(ULES_EventSystem* InEventSystem, const float InTickInterval);
+		virtual ~FShard() override;
+
+		/** Queues the \a Message and wakes the thread. */
+		void Post(FMessage&& Message);
+
+		/** Runs the \a Command on the shard's thread and waits for it, or runs it right away on the shard's thread. */
+		void Execute(TFunctionRef<void()> Command);
+
+		bool IsInThread() const;
+
+		/** Returns the amount of messages waiting in the inbox or being handled. */
+		int32 GetNumPendingMessages() const { return Counters.NumPending; }
+
+		/** Returns the amount of messages posted since the shard started. */
+		uint64 GetNumPostedMessages() const { return Counters.NumPosted; }
+
+		/** Stops the thread after the messages queued so far are handled. */
+		void StopThread();
+
+		/** Makes the thread drop the queued messages and stop, without waiting for it. */
+		void Discard();
+
+		/** Makes the shard clean its Event System after the garbage collection, on its thread. */
+		void NotifyGarbageCollected() { bGarbageCollected = true; }
+
+		void AddReferencedObjects(FReferenceCollector& Collector);
+
+		ULES_EventSystem* EventSystem = nullptr;
+
+		//~ FRunnable
+		virtual uint32 Run() override;
+		virtual void Stop() override;
+
+	private:
+		float TickInterval = 0.0f;
+		double LastTickTime = 0.0;
+
+		UE::FMutex InboxLock;
+		TArray<FMessage> Inbox;
+		TArray<FMessage> Processing;
+
+		/**
+		 * Message counts of the shard, changed by every send to it. They have a cache line of their own, so that the
+		 * sends to different shards don't contend for it.
+		 */
+		struct alignas(64) FCounters
+		{
+			std::atomic<int32> NumPending = 0;
+			std::atomic<uint64> NumPosted = 0;
+		};
+
+		FCounters Counters;
+		FEvent* WakeUp = nullptr;
+		FRunnableThread* Thread = nullptr;
+
+		/** Set by the thread itself once it runs, since it may handle messages before its creation returns. */
+		std::atomic<uint32> ThreadId = 0;
+		std::atomic<bool> bStopping = false;
+		std::atomic<bool> bGarbageCollected = false;
+		std::atomic<bool> bDiscarded = false;
+
+		/** Handles the queued messages and ticks the Event System. */
+		void Drain();
+	};
+
+	TArray<TUniquePtr<FShard>> Shards;
+
+	/** Shard Event Systems, owned by the bus. */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<ULES_EventSystem>> ShardEventSystems;
+
+	/** Observers pinned to a shard, guarded by the \a PinLock. */
+	TMap<FObjectKey, int32> PinnedObservers;
+	mutable UE::FMutex PinLock;
+
+	FDelegateHandle PostGarbageCollectHandle;
+
+	/** Adds the observer record with the \a Callback on the shard of the \a Channel, forwarding to a pinned shard. */
+	FLES_ObserverHandle AddObserver_Private(const TSubclassOf<ULES_Event>& EventClass, UObject* Observer,
+	                                        LES::FObserverCallback&& Callback, const FName Channel);
+};
+
+template <typename TEvent, typename TObserver, typename TCallback>
+	requires TIsDerivedFrom<TObserver, UObject>::Value &&
+	TIsDerivedFrom<TEvent, ULES_Event>::Value &&
+	!TIsSame<TEvent, ULES_Event>::Value &&
+	(LES::IsMethodEventHandler<TObserver, TCallback, TEvent> || LES::IsFunctorEventHandler<TCallback, TEvent>)
+FLES_ObserverHandle ULES_ShardedEventBus::AddObserver(TObserver* Observer, TCallback Callback, const FName Channel)
+{
+	if (!IsValid(Observer)) return {};
+
+	// Handlers run while the shard's thread blocks the garbage collection, so the observer can't be destroyed while
+	// the handler runs.
+	auto CallbackLambda = [Observer = TWeakObjectPtr<TObserver>(Observer), Callback](ULES_Event* Event)
+	{
+		if (!Observer.IsValid(false, true)) return;
+		if constexpr (LES::IsMethodEventHandler<TObserver, TCallback, TEvent>)
+			(Observer.Get()->*Callback)(static_cast<TEvent*>(Event));
+		else
+			Callback(static_cast<TEvent*>(Event));
+	};
+	return AddObserver_Private(TEvent::StaticClass(), Observer, MoveTemp(CallbackLambda), Channel);
+}
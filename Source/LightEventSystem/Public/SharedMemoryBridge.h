@@ -0,0 +1,112 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#pragma once
+
+#include "BridgeLayout.h"
+#include "EventSystem.h"
+#include "HAL/PlatformMemory.h"
+#include "SharedMemoryBridge.generated.h"
+
+/**
+ * Bridges an Event System to external processes through a named shared memory region, laid out as described in
+ * BridgeLayout.h. Events of the mirrored classes and channels are copied into a ring read by the tools, and events
+ * injected by the tools are read from another ring and sent on the Event System. Tools use the standalone library in
+ * Extras/LESBridge.
+ *
+ * Mirroring an event copies the plain old data properties straight into the ring. Other properties, like strings,
+ * names and object references, are written as UTF-8 text, also when the engine counts them as plain old data, since
+ * their bits mean nothing outside the game. Injected object references are resolved by their path. Nothing is
+ * allocated or locked for events with plain old data only. If the ring is full, the event is dropped and counted in
+ * the ring header.
+ */
+UCLASS()
+class LIGHTEVENTSYSTEM_API ULES_SharedMemoryBridge : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * Creates the shared memory region named \a Name, for the \a InEventSystem. Returns false if the region couldn't be
+	 * created.
+	 * @param Capacity Size of each ring in bytes, rounded up to a power of two.
+	 * @param SchemaCapacity Size of the log describing the bridged event classes, in bytes.
+	 */
+	bool Open(ULES_EventSystem* InEventSystem, const FString& Name, const int32 Capacity = 1 << 20,
+	          const int32 SchemaCapacity = 64 * 1024);
+
+	/** Unmaps the shared memory region. Mirrored and injected events stay registered until the bridge is destroyed. */
+	void Close();
+
+	bool IsOpen() const { return Region != nullptr; }
+
+	/** Starts mirroring the events of the \a EventClass sent on the \a Channel to the tools. */
+	bool Mirror(const TSubclassOf<ULES_Event>& EventClass, const FName Channel = NAME_None);
+
+	/** Lets the tools inject events of the \a EventClass, on any channel. */
+	bool AllowInjection(const TSubclassOf<ULES_Event>& EventClass);
+
+	/** Sends the events injected by the tools on the Event System. Returns the amount of events sent. */
+	int32 ReceiveInjectedEvents();
+
+	/** Amount of mirrored events dropped because the tools didn't keep up. */
+	int64 GetNumDropped() const;
+
+	/** If true, injected events are received at the beginning of each engine frame. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Bridge")
+	bool bReceiveAtBeginningOfFrame = true;
+
+	/** Amount of events copied to the tools so far. */
+	UPROPERTY(BlueprintReadOnly, Category = "Bridge")
+	int64 NumMirrored = 0;
+
+	/** Amount of events injected by the tools so far. */
+	UPROPERTY(BlueprintReadOnly, Category = "Bridge")
+	int64 NumInjected = 0;
+
+	virtual void BeginDestroy() override;
+
+private:
+	struct FField
+	{
+		FProperty* Property = nullptr;
+
+		/** Element of the static array written as text. Raw fields contain the whole array. */
+		int32 ArrayIndex = 0;
+
+		bool bRaw = false;
+	};
+
+	/** Fields of a bridged event class, as published in the schema log. */
+	struct FClassSchema
+	{
+		uint32 ClassId = 0;
+		TArray<FField> Fields;
+		int32 RawSize = 0;
+		bool bHasTextFields = false;
+		bool bInjectable = false;
+	};
+
+	UPROPERTY(Transient)
+	TObjectPtr<ULES_EventSystem> EventSystem;
+
+	FPlatformMemory::FSharedMemoryRegion* Region = nullptr;
+	LES::Bridge::FRegionHeader* Header = nullptr;
+	LES::Bridge::FRingWriter Writer;
+	LES::Bridge::FRingReader Reader;
+	FDelegateHandle BeginFrameHandle;
+
+	TMap<FObjectKey, FClassSchema> Schemas;
+	TArray<TWeakObjectPtr<UClass>> ClassesById;
+
+	/** Reused between mirrored events, so the text fields don't allocate once warmed up. */
+	TArray<uint8> TextScratch;
+	TArray<int32> TextLengths;
+	FString TextValue;
+
+	FClassSchema* FindOrAddSchema(UClass* EventClass);
+	void PublishSchema(const UClass* EventClass, const FClassSchema& Schema) const;
+	void MirrorEvent(ULES_Event* Event, const TArray<uint8>& Channel);
+	ULES_Event* DecodeEvent(const uint8* Body, const uint32 BodySize);
+	void ExportField(const FField& Field, const ULES_Event* Event);
+	void ImportField(const FField& Field, ULES_Event* Event) const;
+};
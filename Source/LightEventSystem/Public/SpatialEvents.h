@@ -0,0 +1,113 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#pragma once
+
+#include "Event.h"
+#include "SpatialEvents.generated.h"
+
+class USceneComponent;
+
+/**
+ * Base class for the events happening at a location, like noises or explosions. Observers with a spatial filter receive
+ * them only if they're within reach: the distance between the observer and the \a Location is at most the sum of the
+ * event's \a Radius and the observer's radius. See \a ULES_EventSystem::SetSpatialFilter.
+ */
+UCLASS(Abstract, Blueprintable)
+class LIGHTEVENTSYSTEM_API ULES_SpatialEvent : public ULES_Event
+{
+	GENERATED_BODY()
+
+public:
+	/** Where the event happened. */
+	UPROPERTY(BlueprintReadWrite, Meta = (ExposeOnSpawn), Category = Event)
+	FVector Location = FVector::ZeroVector;
+
+	/** How far the event reaches, like the loudness of a noise. */
+	UPROPERTY(BlueprintReadWrite, Meta = (ExposeOnSpawn), Category = Event)
+	float Radius = 0.0f;
+};
+
+namespace LES
+{
+	/**
+	 * Spatial hash grid of the observers with a spatial filter. Each observer is binned into the cell containing its
+	 * position, and every cell keeps the positions and radii of its observers in separate arrays, so that the distance
+	 * tests of a query run 4 observers at a time with SIMD instructions. Positions are stored in single precision.
+	 */
+	class LIGHTEVENTSYSTEM_API FSpatialHash
+	{
+	public:
+		/** @param InCellSize Edge length of the grid's cells. Should be close to the typical reach of the events. */
+		explicit FSpatialHash(const float InCellSize = 2000.0f);
+
+		/**
+		 * Adds an observer record at the \a Position. If the \a Source is valid, the position is read from it on every
+		 * \a Update. Returns the index of the entry.
+		 */
+		int32 Add(const int32 Record, const FVector& Position, const float Radius, const USceneComponent* Source);
+
+		/** Removes the entry. Entries may be removed during a query's delivery, since queries return copies. */
+		void Remove(const int32 Entry);
+
+		/** Replaces the position source and the radius of the entry. */
+		void SetSource(const int32 Entry, const USceneComponent* Source, const float Radius);
+
+		/** Moves the entry to the \a Position right away, re-binning it if it changed the cell. */
+		void SetPosition(const int32 Entry, const FVector& Position);
+
+		/** Reads the positions of all entries from their sources and re-bins the entries that changed the cell. */
+		void Update();
+
+		/** Appends the records of the entries within reach of a sphere at the \a Center with the \a Radius. */
+		void Query(const FVector& Center, const float Radius, TArray<int32>& OutRecords) const;
+
+		/** Returns the observer record of each entry, indexed by the entries. INDEX_NONE for the free entries. */
+		TConstArrayView<int32> GetRecords() const { return EntryRecords; }
+
+		/** Returns the amount of entries. */
+		int32 Num() const { return NumEntries; }
+
+		/** Returns the amount of bytes allocated for the entries and the cells. */
+		SIZE_T GetAllocatedSize() const;
+
+	private:
+		struct FEntry
+		{
+			TWeakObjectPtr<const USceneComponent> Source = nullptr;
+			FIntVector Cell = FIntVector::ZeroValue;
+
+			/** Index of the entry in its cell's arrays. */
+			int32 Slot = INDEX_NONE;
+		};
+
+		/** Observers binned into one cell, as a structure of arrays. */
+		struct FCell
+		{
+			TArray<float> X;
+			TArray<float> Y;
+			TArray<float> Z;
+			TArray<float> Radius;
+			TArray<int32> Entries;
+		};
+
+		float CellSize;
+		float InverseCellSize;
+
+		/** Largest radius of the entries. Queries are grown by it, since entries are binned by their position only. */
+		float MaxRadius = 0.0f;
+		bool bMaxRadiusDirty = false;
+
+		TArray<FEntry> Entries;
+		TArray<int32> EntryRecords;
+		TArray<int32> FreeEntries;
+		int32 NumEntries = 0;
+
+		TMap<FIntVector, FCell> Cells;
+
+		FIntVector GetCell(const FVector& Position) const;
+		void Bin(const int32 Entry, const FIntVector& Cell, const FVector& Position, const float Radius);
+		void Unbin(const int32 Entry);
+		static void QueryCell(const FCell& Cell, const FVector3f& Center, const float Radius,
+		                      TConstArrayView<int32> EntryRecords, TArray<int32>& OutRecords);
+	};
+}
@@ -0,0 +1,118 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#pragma once
+
+#include "Event.h"
+#include "StreamOperators.generated.h"
+
+/** Determines how the events received during a window are aggregated into a single event. */
+UENUM(BlueprintType)
+enum class ELES_ReduceOperation : uint8
+{
+	/** Events are not aggregated. */
+	None,
+	/** The delivered value is the sum of the received values. */
+	Sum,
+	/** The delivered value is the smallest of the received values. */
+	Min,
+	/** The delivered value is the largest of the received values. */
+	Max,
+	/**
+	 * The delivered event is the last received one, with the amount of received events written to its numeric
+	 * \a Count property, if the event class has one. Works with any event class, and leaves the \a Value intact.
+	 */
+	Count,
+};
+
+/**
+ * Declarative operators evaluated by the Event System before an event is delivered to an observer. Events suppressed by
+ * the operators never reach the observer's event handler, nor the \a BeforeReceive and \a AfterReceive hooks.
+ *
+ * The operators are evaluated in the following order: distinct-until-changed, throttle, and then at most one of reduce,
+ * debounce and sample, in that order of precedence. Deferred events are delivered when the Event System is ticked.
+ */
+USTRUCT(BlueprintType)
+struct LIGHTEVENTSYSTEM_API FLES_StreamOperators
+{
+	GENERATED_BODY()
+
+	/**
+	 * If true, an event is dropped when all of its properties, except for those declared in \a ULES_Event, are
+	 * identical to the last event that passed this operator.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stream Operators")
+	bool bDistinctUntilChanged = false;
+
+	/** If positive, at most this many events are delivered per second. Events over the limit are dropped. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Meta = (ClampMin = 0, Units = "Hz"), Category = "Stream Operators")
+	float ThrottleRate = 0.f;
+
+	/**
+	 * If other than None, the events received during the \a ReduceWindow are aggregated into a single event, delivered
+	 * when the window closes. Sum, Min and Max require the event class to have a numeric \a Value property, like the
+	 * basic events do. The aggregated event is owned by the Event System and reused between windows.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stream Operators")
+	ELES_ReduceOperation ReduceOperation = ELES_ReduceOperation::None;
+
+	/** Length of the aggregation window in seconds. A window of 0 seconds lasts until the next tick. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Meta = (ClampMin = 0, Units = "s"), Category = "Stream Operators")
+	float ReduceWindow = 0.f;
+
+	/**
+	 * If positive, an event is delivered only after no other events have been received for this many seconds. Only the
+	 * last received event is delivered.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Meta = (ClampMin = 0, Units = "s"), Category = "Stream Operators")
+	float DebounceTime = 0.f;
+
+	/** If true, at most one event is delivered per tick, and it's the last event received before the tick. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stream Operators")
+	bool bSamplePerTick = false;
+
+	/** Returns true if no operator is enabled. */
+	bool IsEmpty() const;
+};
+
+namespace LES
+{
+	/** Per-observer-record state of the stream operators. */
+	class LIGHTEVENTSYSTEM_API FStreamOperatorState
+	{
+	public:
+		FStreamOperatorState(const FLES_StreamOperators& InOperators, const UClass* EventClass);
+
+		/**
+		 * Runs the \a Event through the operators. Returns true if the event should be delivered right away. Deferred
+		 * events are kept by the state and returned later by \a Flush.
+		 */
+		bool Receive(ULES_Event* Event, const double Time);
+
+		/** Returns the deferred event that should be delivered at the \a Time, or nullptr if there's none. */
+		ULES_Event* Flush(const double Time);
+
+		/** Reports the kept events to the garbage collector. */
+		void AddReferencedObjects(FReferenceCollector& Collector);
+
+	private:
+		FLES_StreamOperators Operators;
+		/** Property receiving the reduced value: \a Value, or \a Count for the Count operation, if the class has it. */
+		const FNumericProperty* ReducedProperty = nullptr;
+
+		double NextThrottleTime = 0.0;
+
+		TObjectPtr<ULES_Event> PendingEvent = nullptr;
+		double PendingTime = 0.0;
+
+		TObjectPtr<ULES_Event> LastEvent = nullptr;
+
+		TObjectPtr<ULES_Event> AggregateEvent = nullptr;
+		double Accumulator = 0.0;
+		int32 WindowCount = 0;
+		double WindowEnd = 0.0;
+
+		bool IsSameAsLastEvent(const ULES_Event* Event) const;
+		void RememberLastEvent(const ULES_Event* Event);
+		void Accumulate(ULES_Event* Event, const double Time);
+	};
+}
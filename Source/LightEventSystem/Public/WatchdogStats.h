@@ -0,0 +1,33 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "WatchdogStats.generated.h"
+
+/** Counters of the slow-handler watchdog. See \a ULES_EventSystem::DefaultHandlerBudget. */
+USTRUCT(BlueprintType)
+struct FLES_WatchdogStats
+{
+	GENERATED_BODY()
+
+	/** Amount of handler calls timed, because their channel has a budget. */
+	UPROPERTY(BlueprintReadOnly, Category = "Watchdog")
+	int64 NumTimedCalls = 0;
+
+	/** Amount of handler calls that went over their channel's budget. */
+	UPROPERTY(BlueprintReadOnly, Category = "Watchdog")
+	int64 NumOverBudgetCalls = 0;
+
+	/** Amount of observer records demoted to the deferred delivery. */
+	UPROPERTY(BlueprintReadOnly, Category = "Watchdog")
+	int32 NumDemotedRecords = 0;
+
+	/** Amount of events delivered to the demoted records on the tick after they were sent. */
+	UPROPERTY(BlueprintReadOnly, Category = "Watchdog")
+	int64 NumDeferredDeliveries = 0;
+
+	/** Longest time a single handler call has taken, in milliseconds. */
+	UPROPERTY(BlueprintReadOnly, Category = "Watchdog")
+	double SlowestCallTime = 0.0;
+};
@@ -0,0 +1,196 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+
+#include "K2Node_LES_AddObserver.h"
+
+#include "BlueprintActionDatabaseRegistrar.h"
+#include "BlueprintNodeSpawner.h"
+#include "EventSystem.h"
+#include "K2Node_CallFunction.h"
+#include "K2Node_Self.h"
+#include "KismetCompiler.h"
+#include "Kismet2/BlueprintEditorUtils.h"
+
+#define LOCTEXT_NAMESPACE "K2Node_LES_AddObserver"
+
+namespace LES::AddObserverPins
+{
+	const FName EventSystem = "EventSystem";
+	const FName EventClass = "EventClass";
+	const FName Observer = "Observer";
+	const FName Channel = "Channel";
+	const FName Group = "Group";
+	const FName Handle = "ObserverHandle";
+}
+
+void UK2Node_LES_AddObserver::AllocateDefaultPins()
+{
+	using namespace LES::AddObserverPins;
+
+	CreatePin(EGPD_Input, UEdGraphSchema_K2::PC_Exec, UEdGraphSchema_K2::PN_Execute);
+	CreatePin(EGPD_Output, UEdGraphSchema_K2::PC_Exec, UEdGraphSchema_K2::PN_Then);
+	CreatePin(EGPD_Input, UEdGraphSchema_K2::PC_Object, ULES_EventSystem::StaticClass(), EventSystem);
+	CreatePin(EGPD_Input, UEdGraphSchema_K2::PC_Class, ULES_Event::StaticClass(), EventClass);
+
+	UEdGraphPin* ObserverPin = CreatePin(EGPD_Input, UEdGraphSchema_K2::PC_Object, UObject::StaticClass(), Observer);
+	ObserverPin->PinToolTip = LOCTEXT("ObserverTooltip", "Object owning the handler, self if unconnected.").ToString();
+
+	CreatePin(EGPD_Input, UEdGraphSchema_K2::PC_Name, Channel);
+	CreatePin(EGPD_Input, UEdGraphSchema_K2::PC_Name, Group);
+	CreatePin(EGPD_Output, UEdGraphSchema_K2::PC_Struct, FLES_ObserverHandle::StaticStruct(), Handle);
+
+	Super::AllocateDefaultPins();
+}
+
+FText UK2Node_LES_AddObserver::GetNodeTitle(const ENodeTitleType::Type TitleType) const
+{
+	if (FunctionName.IsNone())
+		return LOCTEXT("Title", "Add Observer");
+	return FText::Format(LOCTEXT("TitleWithFunction", "Add Observer ({0})"), FText::FromName(FunctionName));
+}
+
+FText UK2Node_LES_AddObserver::GetTooltipText() const
+{
+	return LOCTEXT("Tooltip", "Adds the observer's function as the handler of the events of the class, sent on the "
+	               "channel. The handler is checked when the blueprint is compiled.");
+}
+
+void UK2Node_LES_AddObserver::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	if (PropertyChangedEvent.GetPropertyName() == GET_MEMBER_NAME_CHECKED(UK2Node_LES_AddObserver, FunctionName))
+	{
+		GetGraph()->NotifyNodeChanged(this);
+		FBlueprintEditorUtils::MarkBlueprintAsModified(GetBlueprint());
+	}
+}
+
+void UK2Node_LES_AddObserver::GetMenuActions(FBlueprintActionDatabaseRegistrar& ActionRegistrar) const
+{
+	UClass* ActionKey = GetClass();
+	if (ActionRegistrar.IsOpenForRegistration(ActionKey))
+	{
+		UBlueprintNodeSpawner* NodeSpawner = UBlueprintNodeSpawner::Create(GetClass());
+		check(NodeSpawner != nullptr);
+		ActionRegistrar.AddBlueprintAction(ActionKey, NodeSpawner);
+	}
+}
+
+FText UK2Node_LES_AddObserver::GetMenuCategory() const
+{
+	return LOCTEXT("MenuCategory", "Event System");
+}
+
+void UK2Node_LES_AddObserver::ExpandNode(FKismetCompilerContext& CompilerContext, UEdGraph* SourceGraph)
+{
+	using namespace LES::AddObserverPins;
+
+	Super::ExpandNode(CompilerContext, SourceGraph);
+
+	FText Error;
+	if (FindPinChecked(EventSystem)->LinkedTo.IsEmpty())
+		Error = LOCTEXT("NoEventSystem", "@@ needs an Event System connected.");
+	else
+		ResolveHandler(Error);
+
+	if (!Error.IsEmpty())
+	{
+		CompilerContext.MessageLog.Error(*Error.ToString(), this);
+		BreakAllNodeLinks();
+		return;
+	}
+
+	UK2Node_CallFunction* CallNode = CompilerContext.SpawnIntermediateNode<UK2Node_CallFunction>(this, SourceGraph);
+	CallNode->FunctionReference.SetExternalMember(
+		GET_FUNCTION_NAME_CHECKED(ULES_EventSystem, BP_AddObserver_Resolved), ULES_EventSystem::StaticClass());
+	CallNode->AllocateDefaultPins();
+
+	CompilerContext.MovePinLinksToIntermediate(*GetExecPin(), *CallNode->GetExecPin());
+	CompilerContext.MovePinLinksToIntermediate(*FindPinChecked(UEdGraphSchema_K2::PN_Then), *CallNode->GetThenPin());
+	CompilerContext.MovePinLinksToIntermediate(*FindPinChecked(EventSystem),
+	                                           *CallNode->FindPinChecked(UEdGraphSchema_K2::PN_Self));
+	CompilerContext.MovePinLinksToIntermediate(*FindPinChecked(EventClass), *CallNode->FindPinChecked(EventClass));
+	CompilerContext.MovePinLinksToIntermediate(*FindPinChecked(Channel), *CallNode->FindPinChecked(Channel));
+	CompilerContext.MovePinLinksToIntermediate(*FindPinChecked(Group), *CallNode->FindPinChecked(Group));
+	CompilerContext.MovePinLinksToIntermediate(*FindPinChecked(Handle), *CallNode->GetReturnValuePin());
+
+	// The resolved handler is baked into the graph as a literal.
+	CallNode->FindPinChecked(TEXT("FunctionName"))->DefaultValue = FunctionName.ToString();
+
+	UEdGraphPin* CallObserverPin = CallNode->FindPinChecked(Observer);
+	if (FindPinChecked(Observer)->LinkedTo.IsEmpty())
+	{
+		UK2Node_Self* SelfNode = CompilerContext.SpawnIntermediateNode<UK2Node_Self>(this, SourceGraph);
+		SelfNode->AllocateDefaultPins();
+		SelfNode->FindPinChecked(UEdGraphSchema_K2::PN_Self)->MakeLinkTo(CallObserverPin);
+	}
+	else
+	{
+		CompilerContext.MovePinLinksToIntermediate(*FindPinChecked(Observer), *CallObserverPin);
+	}
+
+	BreakAllNodeLinks();
+}
+
+UClass* UK2Node_LES_AddObserver::GetObserverClass() const
+{
+	const UEdGraphPin* ObserverPin = FindPinChecked(LES::AddObserverPins::Observer);
+	const UEdGraphPin* SourcePin = ObserverPin->LinkedTo.IsEmpty() ? nullptr : ObserverPin->LinkedTo[0];
+	if (SourcePin && SourcePin->PinType.PinSubCategory != UEdGraphSchema_K2::PSC_Self)
+		return Cast<UClass>(SourcePin->PinType.PinSubCategoryObject.Get());
+
+	const UBlueprint* Blueprint = GetBlueprint();
+	return Blueprint->SkeletonGeneratedClass ? Blueprint->SkeletonGeneratedClass : Blueprint->GeneratedClass;
+}
+
+UFunction* UK2Node_LES_AddObserver::ResolveHandler(FText& OutError) const
+{
+	const UClass* ObserverClass = GetObserverClass();
+	UFunction* Handler = ObserverClass ? ObserverClass->FindFunctionByName(FunctionName) : nullptr;
+	if (!Handler)
+	{
+		OutError = FText::Format(LOCTEXT("HandlerNotFound", "@@ can't find the handler function '{0}' in {1}."),
+		                         FText::FromName(FunctionName), FText::FromString(GetNameSafe(ObserverClass)));
+		return nullptr;
+	}
+
+	int32 NumParameters = 0;
+	const FObjectProperty* EventParameter = nullptr;
+	for (TFieldIterator<FProperty> It(Handler); It && It->HasAnyPropertyFlags(CPF_Parm); ++It)
+	{
+		NumParameters++;
+		if (!It->HasAnyPropertyFlags(CPF_OutParm | CPF_ReturnParm))
+			EventParameter = CastField<FObjectProperty>(*It);
+	}
+	if (NumParameters != 1 || !EventParameter || !EventParameter->PropertyClass->IsChildOf<ULES_Event>())
+	{
+		OutError = FText::Format(
+			LOCTEXT("InvalidSignature", "@@: the handler '{0}' should take 1 event parameter and return no values."),
+			FText::FromName(FunctionName));
+		return nullptr;
+	}
+
+	// The events are passed to the handler as they are, so its parameter has to be of the event class or its base.
+	const UEdGraphPin* EventClassPin = FindPinChecked(LES::AddObserverPins::EventClass);
+	if (EventClassPin->LinkedTo.IsEmpty())
+	{
+		const UClass* EventClass = Cast<UClass>(EventClassPin->DefaultObject);
+		if (!EventClass)
+		{
+			OutError = LOCTEXT("NoEventClass", "@@ needs an event class.");
+			return nullptr;
+		}
+		if (!EventClass->IsChildOf(EventParameter->PropertyClass))
+		{
+			OutError = FText::Format(
+				LOCTEXT("IncompatibleEventClass", "@@: the handler '{0}' takes {1}, which {2} can't be passed as."),
+				FText::FromName(FunctionName), EventParameter->PropertyClass->GetDisplayNameText(),
+				EventClass->GetDisplayNameText());
+			return nullptr;
+		}
+	}
+	return Handler;
+}
+
+#undef LOCTEXT_NAMESPACE
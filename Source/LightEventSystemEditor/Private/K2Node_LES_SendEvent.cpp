@@ -0,0 +1,154 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+
+#include "K2Node_LES_SendEvent.h"
+
+#include "BasicEvents.h"
+#include "BlueprintActionDatabaseRegistrar.h"
+#include "BlueprintNodeSpawner.h"
+#include "EventSystem.h"
+#include "K2Node_CallFunction.h"
+#include "KismetCompiler.h"
+#include "KismetCompilerMisc.h"
+#include "Kismet/GameplayStatics.h"
+
+#define LOCTEXT_NAMESPACE "K2Node_LES_SendEvent"
+
+namespace LES::SendEventPins
+{
+	const FName EventSystem = "EventSystem";
+}
+
+void UK2Node_LES_SendEvent::AllocateDefaultPins()
+{
+	Super::AllocateDefaultPins();
+
+	CreatePin(EGPD_Input, UEdGraphSchema_K2::PC_Object, ULES_EventSystem::StaticClass(),
+	          LES::SendEventPins::EventSystem);
+
+	// Applied only when the node is placed. Reconstruction restores the class from the old pins.
+	UEdGraphPin* ClassPin = GetClassPin();
+	if (PresetEventClass && !ClassPin->DefaultObject)
+	{
+		ClassPin->DefaultObject = PresetEventClass;
+		CreatePinsForClass(PresetEventClass);
+	}
+	PresetEventClass = nullptr;
+}
+
+FText UK2Node_LES_SendEvent::GetTooltipText() const
+{
+	return LOCTEXT("Tooltip", "Creates an event of the class with the given properties and sends it with the Event "
+	               "System.");
+}
+
+void UK2Node_LES_SendEvent::GetMenuActions(FBlueprintActionDatabaseRegistrar& ActionRegistrar) const
+{
+	UClass* ActionKey = GetClass();
+	if (!ActionRegistrar.IsOpenForRegistration(ActionKey)) return;
+
+	UBlueprintNodeSpawner* NodeSpawner = UBlueprintNodeSpawner::Create(GetClass());
+	check(NodeSpawner != nullptr);
+	ActionRegistrar.AddBlueprintAction(ActionKey, NodeSpawner);
+
+	const UClass* BasicEventClasses[] = {
+		ULES_BooleanEvent::StaticClass(), ULES_ByteEvent::StaticClass(), ULES_IntegerEvent::StaticClass(),
+		ULES_Integer64Event::StaticClass(), ULES_FloatEvent::StaticClass(), ULES_DoubleEvent::StaticClass(),
+		ULES_NameEvent::StaticClass(), ULES_StringEvent::StaticClass(), ULES_TextEvent::StaticClass(),
+		ULES_VectorEvent::StaticClass(), ULES_RotatorEvent::StaticClass(), ULES_TransformEvent::StaticClass(),
+		ULES_ObjectEvent::StaticClass(),
+	};
+	for (const UClass* EventClass : BasicEventClasses)
+	{
+		UBlueprintNodeSpawner* TypedSpawner = UBlueprintNodeSpawner::Create(GetClass());
+		check(TypedSpawner != nullptr);
+		TypedSpawner->DefaultMenuSignature.MenuName = FText::Format(LOCTEXT("TypedMenuName", "Send {0}"),
+		                                                            EventClass->GetDisplayNameText());
+		TypedSpawner->CustomizeNodeDelegate = UBlueprintNodeSpawner::FCustomizeNodeDelegate::CreateLambda(
+			[EventClass = const_cast<UClass*>(EventClass)](UEdGraphNode* Node, bool)
+			{
+				CastChecked<UK2Node_LES_SendEvent>(Node)->PresetEventClass = EventClass;
+			});
+		ActionRegistrar.AddBlueprintAction(ActionKey, TypedSpawner);
+	}
+}
+
+FText UK2Node_LES_SendEvent::GetMenuCategory() const
+{
+	return LOCTEXT("MenuCategory", "Event System");
+}
+
+void UK2Node_LES_SendEvent::ExpandNode(FKismetCompilerContext& CompilerContext, UEdGraph* SourceGraph)
+{
+	Super::ExpandNode(CompilerContext, SourceGraph);
+
+	UEdGraphPin* ClassPin = GetClassPin();
+	UEdGraphPin* EventSystemPin = FindPinChecked(LES::SendEventPins::EventSystem);
+	FText Error;
+	if (ClassPin->LinkedTo.IsEmpty() && !ClassPin->DefaultObject)
+		Error = LOCTEXT("NoEventClass", "@@ needs an event class.");
+	else if (EventSystemPin->LinkedTo.IsEmpty())
+		Error = LOCTEXT("NoEventSystem", "@@ needs an Event System connected.");
+
+	if (!Error.IsEmpty())
+	{
+		CompilerContext.MessageLog.Error(*Error.ToString(), this);
+		BreakAllNodeLinks();
+		return;
+	}
+
+	// The event is created in the Event System, then its exposed properties are assigned and it's sent.
+	UK2Node_CallFunction* CreateNode = CompilerContext.SpawnIntermediateNode<UK2Node_CallFunction>(this, SourceGraph);
+	CreateNode->FunctionReference.SetExternalMember(GET_FUNCTION_NAME_CHECKED(UGameplayStatics, SpawnObject),
+	                                                UGameplayStatics::StaticClass());
+	CreateNode->AllocateDefaultPins();
+
+	UEdGraphPin* CreateResultPin = CreateNode->GetReturnValuePin();
+	CreateResultPin->PinType = GetResultPin()->PinType;
+	CompilerContext.MovePinLinksToIntermediate(*GetExecPin(), *CreateNode->GetExecPin());
+	CompilerContext.MovePinLinksToIntermediate(*ClassPin, *CreateNode->FindPinChecked(TEXT("ObjectClass")));
+	CompilerContext.CopyPinLinksToIntermediate(*EventSystemPin, *CreateNode->FindPinChecked(TEXT("Outer")));
+	CompilerContext.MovePinLinksToIntermediate(*GetResultPin(), *CreateResultPin);
+
+	UEdGraphPin* LastThenPin = FKismetCompilerUtilities::GenerateAssignmentNodes(
+		CompilerContext, SourceGraph, CreateNode, this, CreateResultPin, GetClassToSpawn());
+
+	// SendEvent is overloaded, so its name can't be checked at compile time.
+	UK2Node_CallFunction* SendNode = CompilerContext.SpawnIntermediateNode<UK2Node_CallFunction>(this, SourceGraph);
+	SendNode->FunctionReference.SetExternalMember(TEXT("SendEvent"), ULES_EventSystem::StaticClass());
+	SendNode->AllocateDefaultPins();
+
+	LastThenPin->MakeLinkTo(SendNode->GetExecPin());
+	CompilerContext.MovePinLinksToIntermediate(*EventSystemPin, *SendNode->FindPinChecked(UEdGraphSchema_K2::PN_Self));
+	CreateResultPin->MakeLinkTo(SendNode->FindPinChecked(TEXT("Event")));
+	CompilerContext.MovePinLinksToIntermediate(*GetThenPin(), *SendNode->GetThenPin());
+
+	BreakAllNodeLinks();
+}
+
+FText UK2Node_LES_SendEvent::GetBaseNodeTitle() const
+{
+	return LOCTEXT("BaseTitle", "Send Event");
+}
+
+FText UK2Node_LES_SendEvent::GetDefaultNodeTitle() const
+{
+	return LOCTEXT("DefaultTitle", "Send Event");
+}
+
+FText UK2Node_LES_SendEvent::GetNodeTitleFormat() const
+{
+	return LOCTEXT("TitleFormat", "Send {ClassName}");
+}
+
+UClass* UK2Node_LES_SendEvent::GetClassPinBaseClass() const
+{
+	return ULES_Event::StaticClass();
+}
+
+bool UK2Node_LES_SendEvent::IsSpawnVarPin(UEdGraphPin* Pin) const
+{
+	return Super::IsSpawnVarPin(Pin) && Pin->PinName != LES::SendEventPins::EventSystem;
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,20 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#include "LightEventSystemEditorModule.h"
+
+#define LOCTEXT_NAMESPACE "FLightEventSystemEditorModule"
+
+void FLightEventSystemEditorModule::StartupModule()
+{
+	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
+}
+
+void FLightEventSystemEditorModule::ShutdownModule()
+{
+	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
+	// we call this function before unloading the module.
+}
+
+#undef LOCTEXT_NAMESPACE
+	
+IMPLEMENT_MODULE(FLightEventSystemEditorModule, LightEventSystemEditor)
\ No newline at end of file
@@ -0,0 +1,43 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#pragma once
+
+#include "K2Node.h"
+#include "K2Node_LES_AddObserver.generated.h"
+
+/**
+ * Adds a blueprint function of the observer as the handler of the events of a class. Unlike the Add Observer
+ * (Function) call, the handler is checked when the blueprint is compiled: it has to exist in the observer's class and
+ * take one parameter the events can be passed to. At runtime the function is only looked up by its name.
+ */
+UCLASS()
+class LIGHTEVENTSYSTEMEDITOR_API UK2Node_LES_AddObserver : public UK2Node
+{
+	GENERATED_BODY()
+
+public:
+	/** Name of the observer's function called when the event is received. */
+	UPROPERTY(EditAnywhere, Category = "Add Observer")
+	FName FunctionName = NAME_None;
+
+	//~ Begin UEdGraphNode Interface
+	virtual void AllocateDefaultPins() override;
+	virtual FText GetNodeTitle(ENodeTitleType::Type TitleType) const override;
+	virtual FText GetTooltipText() const override;
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+	//~ End UEdGraphNode Interface
+
+	//~ Begin UK2Node Interface
+	virtual bool IsNodeSafeToIgnore() const override { return true; }
+	virtual void GetMenuActions(FBlueprintActionDatabaseRegistrar& ActionRegistrar) const override;
+	virtual FText GetMenuCategory() const override;
+	virtual void ExpandNode(FKismetCompilerContext& CompilerContext, UEdGraph* SourceGraph) override;
+	//~ End UK2Node Interface
+
+private:
+	/** Returns the class of the object connected to the Observer pin, or the blueprint's class if it's unconnected. */
+	UClass* GetObserverClass() const;
+
+	/** Returns the handler function, or nullptr and the reason in \a OutError if it can't receive the events. */
+	UFunction* ResolveHandler(FText& OutError) const;
+};
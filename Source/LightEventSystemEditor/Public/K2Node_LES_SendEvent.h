@@ -0,0 +1,43 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#pragma once
+
+#include "K2Node_ConstructObjectFromClass.h"
+#include "K2Node_LES_SendEvent.generated.h"
+
+/**
+ * Creates an event of the class and sends it with the Event System, in one node. The event's properties exposed on
+ * spawn become the node's pins, typed when the blueprint is edited. The menu has a typed version for each basic event.
+ */
+UCLASS()
+class LIGHTEVENTSYSTEMEDITOR_API UK2Node_LES_SendEvent : public UK2Node_ConstructObjectFromClass
+{
+	GENERATED_BODY()
+
+public:
+	//~ Begin UEdGraphNode Interface
+	virtual void AllocateDefaultPins() override;
+	virtual FText GetTooltipText() const override;
+	//~ End UEdGraphNode Interface
+
+	//~ Begin UK2Node Interface
+	virtual void GetMenuActions(FBlueprintActionDatabaseRegistrar& ActionRegistrar) const override;
+	virtual FText GetMenuCategory() const override;
+	virtual void ExpandNode(FKismetCompilerContext& CompilerContext, UEdGraph* SourceGraph) override;
+	//~ End UK2Node Interface
+
+protected:
+	//~ Begin UK2Node_ConstructObjectFromClass Interface
+	virtual FText GetBaseNodeTitle() const override;
+	virtual FText GetDefaultNodeTitle() const override;
+	virtual FText GetNodeTitleFormat() const override;
+	virtual UClass* GetClassPinBaseClass() const override;
+	virtual bool IsSpawnVarPin(UEdGraphPin* Pin) const override;
+	virtual bool UseWorldContext() const override { return false; }
+	//~ End UK2Node_ConstructObjectFromClass Interface
+
+private:
+	/** Event class set by the menu action of a typed send. Applied to the class pin when the node is placed. */
+	UPROPERTY()
+	TObjectPtr<UClass> PresetEventClass = nullptr;
+};
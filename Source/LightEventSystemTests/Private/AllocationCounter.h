@@ -0,0 +1,103 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/PlatformTLS.h"
+
+namespace LES
+{
+	/**
+	 * Counts the heap allocations made by the current thread while in scope, by putting itself in front of GMalloc.
+	 * Allocations of the other threads are forwarded without being counted. Reallocations count as allocations, frees
+	 * don't.
+	 */
+	class FScopedAllocationCounter : public FMalloc
+	{
+	public:
+		FScopedAllocationCounter()
+			: InnerMalloc(GMalloc),
+			  ThreadId(FPlatformTLS::GetCurrentThreadId())
+		{
+			GMalloc = this;
+		}
+
+		virtual ~FScopedAllocationCounter() override
+		{
+			GMalloc = InnerMalloc;
+		}
+
+		FScopedAllocationCounter(const FScopedAllocationCounter&) = delete;
+		FScopedAllocationCounter& operator=(const FScopedAllocationCounter&) = delete;
+
+		/** Returns the amount of allocations made by the thread that created the counter. */
+		int32 GetNumAllocations() const { return NumAllocations; }
+
+		virtual void* Malloc(const SIZE_T Count, const uint32 Alignment) override
+		{
+			CountAllocation();
+			return InnerMalloc->Malloc(Count, Alignment);
+		}
+
+		virtual void* TryMalloc(const SIZE_T Count, const uint32 Alignment) override
+		{
+			CountAllocation();
+			return InnerMalloc->TryMalloc(Count, Alignment);
+		}
+
+		virtual void* Realloc(void* Original, const SIZE_T Count, const uint32 Alignment) override
+		{
+			if (Count > 0)
+				CountAllocation();
+			return InnerMalloc->Realloc(Original, Count, Alignment);
+		}
+
+		virtual void* TryRealloc(void* Original, const SIZE_T Count, const uint32 Alignment) override
+		{
+			if (Count > 0)
+				CountAllocation();
+			return InnerMalloc->TryRealloc(Original, Count, Alignment);
+		}
+
+		virtual void Free(void* Original) override
+		{
+			InnerMalloc->Free(Original);
+		}
+
+		virtual SIZE_T QuantizeSize(const SIZE_T Count, const uint32 Alignment) override
+		{
+			return InnerMalloc->QuantizeSize(Count, Alignment);
+		}
+
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override
+		{
+			return InnerMalloc->GetAllocationSize(Original, SizeOut);
+		}
+
+		virtual void Trim(const bool bTrimThreadCaches) override
+		{
+			InnerMalloc->Trim(bTrimThreadCaches);
+		}
+
+		virtual bool IsInternallyThreadSafe() const override
+		{
+			return InnerMalloc->IsInternallyThreadSafe();
+		}
+
+		virtual const TCHAR* GetDescriptiveName() override
+		{
+			return TEXT("LES Allocation Counter");
+		}
+
+	private:
+		FMalloc* InnerMalloc;
+		uint32 ThreadId;
+		int32 NumAllocations = 0;
+
+		void CountAllocation()
+		{
+			if (FPlatformTLS::GetCurrentThreadId() == ThreadId)
+				NumAllocations++;
+		}
+	};
+}
@@ -0,0 +1,137 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#include "TestClasses.h"
+#include "Misc/AutomationTest.h"
+
+namespace
+{
+	/** Ticks the \a EventSystem until the \a Predicate holds, for up to a few seconds. Returns the last result. */
+	template <typename TPredicate>
+	bool TickUntil(ULES_EventSystem* EventSystem, TPredicate Predicate)
+	{
+		const double EndTime = FPlatformTime::Seconds() + 5.0;
+		while (!Predicate() && FPlatformTime::Seconds() < EndTime)
+		{
+			FPlatformProcess::Sleep(0.001f);
+			EventSystem->Tick(0.0f);
+		}
+		return Predicate();
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLES_AsyncObserverTest, "Light Event System.Async observers",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+bool FLES_AsyncObserverTest::RunTest(const FString& Parameters)
+{
+	auto EventSystem = TStrongObjectPtr(NewObject<ULES_CountingEventSystem>());
+	auto Observer = TStrongObjectPtr(NewObject<ULES_TestObserver>());
+
+	std::atomic<int32> NumWorkCalls = 0;
+	std::atomic<bool> bWorkOnGameThread = false;
+	std::atomic<bool> bBlockWork = true;
+	std::atomic<ULES_TestEvent*> FirstWorkEvent = nullptr;
+	auto Work = [&](ULES_TestEvent* Event)
+	{
+		ULES_TestEvent* Expected = nullptr;
+		FirstWorkEvent.compare_exchange_strong(Expected, Event);
+		while (bBlockWork)
+			FPlatformProcess::Sleep(0.0f);
+		bWorkOnGameThread = bWorkOnGameThread || IsInGameThread();
+		NumWorkCalls++;
+	};
+	const auto Handle = EventSystem->AddAsyncObserver<ULES_TestEvent>(Observer.Get(), Work,
+	                                                                  &ULES_TestObserver::OnTestEvent);
+
+	// With one task in flight, the other events wait in the queue.
+	TWeakObjectPtr<ULES_TestEvent> UnreferencedEvent = NewObject<ULES_TestEvent>();
+	EventSystem->SendEvent(UnreferencedEvent.Get());
+	EventSystem->SendEvent(NewObject<ULES_TestEvent>());
+	EventSystem->SendEvent(NewObject<ULES_TestEvent>());
+	FLES_AsyncObserverStats Stats = EventSystem->GetAsyncObserverStats(Handle);
+	TestEqual(TEXT("One task should be in flight"), Stats.NumTasksInFlight, 1);
+	TestEqual(TEXT("Other events should be queued"), Stats.NumQueuedEvents, 2);
+	TestEqual(TEXT("Sending shouldn't wait for the work"), NumWorkCalls.load(), 0);
+	TestEqual(TEXT("BeforeReceive should be called when sent"), EventSystem->BeforeReceiveCount, 3);
+
+	// Tasks get their own copies of the events, which are kept alive while in flight.
+	const double EndTime = FPlatformTime::Seconds() + 5.0;
+	while (!FirstWorkEvent && FPlatformTime::Seconds() < EndTime)
+		FPlatformProcess::Sleep(0.001f);
+	TWeakObjectPtr<ULES_TestEvent> CopiedEvent = FirstWorkEvent.load();
+	TestTrue(TEXT("Task should get a copy of the event"), CopiedEvent.IsValid() && CopiedEvent != UnreferencedEvent);
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	TestTrue(TEXT("Copy in flight should survive garbage collection"), CopiedEvent.IsValid());
+
+	bBlockWork = false;
+	TestTrue(TEXT("All events should be completed"), TickUntil(EventSystem.Get(), [&Observer]
+	{
+		return Observer->Counter.X == 3;
+	}));
+	TestEqual(TEXT("Work should be called for every event"), NumWorkCalls.load(), 3);
+	TestFalse(TEXT("Work shouldn't run on the game thread"), bWorkOnGameThread.load());
+	TestEqual(TEXT("AfterReceive should follow the completion"), EventSystem->AfterReceiveCount, 3);
+	Stats = EventSystem->GetAsyncObserverStats(Handle);
+	TestEqual(TEXT("Completed events should be counted"), Stats.NumCompletedEvents, static_cast<int64>(3));
+	TestEqual(TEXT("Peak queue depth should be reported"), Stats.PeakQueuedEvents, 2);
+	TestTrue(TEXT("Latency should be measured"), Stats.MaxLatency > 0.0 && Stats.AverageLatency <= Stats.MaxLatency);
+
+	// Removed records drop their queued events and aren't completed.
+	bBlockWork = true;
+	EventSystem->SendEvent(NewObject<ULES_TestEvent>());
+	EventSystem->SendEvent(NewObject<ULES_TestEvent>());
+	EventSystem->RemoveByHandle(Handle);
+	bBlockWork = false;
+	TickUntil(EventSystem.Get(), [&NumWorkCalls] { return NumWorkCalls == 4; });
+	EventSystem->Tick(0.0f);
+	TestEqual(TEXT("Running task should finish"), NumWorkCalls.load(), 4);
+	TestEqual(TEXT("Removed observer shouldn't be completed"), Observer->Counter.X, 3);
+	TestEqual(TEXT("Queued events of the removed observer should be dropped"), EventSystem->AfterReceiveCount, 3);
+
+	// Several tasks may run at once, and the completion is optional.
+	std::atomic<int32> NumRunning = 0;
+	std::atomic<int32> MaxRunning = 0;
+	bBlockWork = true;
+	EventSystem->AddAsyncObserver<ULES_OtherTestEvent>(Observer.Get(), [&](ULES_OtherTestEvent*)
+	{
+		const int32 Running = ++NumRunning;
+		int32 Expected = MaxRunning;
+		while (Running > Expected && !MaxRunning.compare_exchange_weak(Expected, Running))
+		{
+		}
+		while (bBlockWork)
+			FPlatformProcess::Sleep(0.0f);
+		--NumRunning;
+	}, NAME_None, 2);
+	for (int32 Index = 0; Index < 4; Index++)
+		EventSystem->SendEvent(NewObject<ULES_OtherTestEvent>());
+	TestTrue(TEXT("Two tasks should run at once"), TickUntil(EventSystem.Get(), [&NumRunning]
+	{
+		return NumRunning == 2;
+	}));
+	bBlockWork = false;
+	TestTrue(TEXT("All events should be completed"), TickUntil(EventSystem.Get(), [&EventSystem]
+	{
+		return EventSystem->AfterReceiveCount == 7;
+	}));
+	TestEqual(TEXT("No more than two tasks should run at once"), MaxRunning.load(), 2);
+
+	// Senders may reuse their events while the tasks run.
+	TArray<int32> CompletedValues;
+	EventSystem->AddAsyncObserver<ULES_IntegerEvent>(Observer.Get(), [](ULES_IntegerEvent*)
+	{
+	}, [&CompletedValues](const ULES_IntegerEvent* Event)
+	{
+		CompletedValues.Add(Event->Value);
+	});
+	ULES_IntegerEvent* ReusedEvent = LES::Create<ULES_IntegerEvent>(1, nullptr, NAME_None);
+	EventSystem->SendEvent(ReusedEvent);
+	ReusedEvent->Value = 2;
+	EventSystem->SendEvent(ReusedEvent);
+	TickUntil(EventSystem.Get(), [&CompletedValues] { return CompletedValues.Num() == 2; });
+	TestEqual(TEXT("Each task should keep the values sent"), CompletedValues, TArray<int32>{1, 2});
+
+	return true;
+}
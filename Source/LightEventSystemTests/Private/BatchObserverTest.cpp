@@ -0,0 +1,92 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#include "TestClasses.h"
+#include "Misc/AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLES_BatchObserverTest, "Light Event System.Batch observers",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+bool FLES_BatchObserverTest::RunTest(const FString& Parameters)
+{
+	auto EventSystem = TStrongObjectPtr(NewObject<ULES_CountingEventSystem>());
+	auto SizedObserver = TStrongObjectPtr(NewObject<ULES_TestObserver>());
+	auto TickedObserver = TStrongObjectPtr(NewObject<ULES_TestObserver>());
+
+	TArray<TArray<const ULES_TestEvent*>> Batches;
+	auto BatchHandler = [&Batches](TArrayView<const ULES_TestEvent* const> Batch)
+	{
+		Batches.Emplace(Batch);
+	};
+	const auto SizedHandle = EventSystem->AddBatchObserver<ULES_TestEvent>(
+		SizedObserver.Get(), &ULES_TestObserver::OnTestEvents, NAME_None, 3);
+	const auto TickedHandle = EventSystem->AddBatchObserver<ULES_TestEvent>(TickedObserver.Get(), BatchHandler);
+
+	auto FirstEvent = TStrongObjectPtr(NewObject<ULES_TestEvent>());
+	auto SecondEvent = TStrongObjectPtr(NewObject<ULES_TestEvent>());
+	EventSystem->SendEvent(FirstEvent.Get());
+	EventSystem->SendEvent(SecondEvent.Get());
+	TestEqual(TEXT("Events should wait in the mailbox"), SizedObserver->Counter, FIntVector3::ZeroValue);
+	TestEqual(TEXT("Events should wait in the mailbox"), Batches.Num(), 0);
+	TestEqual(TEXT("BeforeReceive should run when the events are collected"), EventSystem->BeforeReceiveCount, 4);
+	TestEqual(TEXT("AfterReceive should wait for the batch"), EventSystem->AfterReceiveCount, 0);
+
+	EventSystem->Tick(0.0f);
+	TestEqual(TEXT("Tick should flush the mailbox"), SizedObserver->Counter, FIntVector3(2, 0, 0));
+	if (TestEqual(TEXT("Tick should deliver one batch"), Batches.Num(), 1) &&
+		TestEqual(TEXT("Batch should have all events"), Batches[0].Num(), 2))
+	{
+		TestTrue(TEXT("Batch should keep the send order"),
+		         Batches[0][0] == FirstEvent.Get() && Batches[0][1] == SecondEvent.Get());
+	}
+	TestEqual(TEXT("AfterReceive should run for every batched event"), EventSystem->AfterReceiveCount, 4);
+
+	// A full mailbox is flushed right away.
+	for (int32 Index = 0; Index < 3; Index++)
+		EventSystem->SendEvent(FirstEvent.Get());
+	TestEqual(TEXT("Full mailbox should be flushed when sending"), SizedObserver->Counter, FIntVector3(5, 0, 0));
+	TestEqual(TEXT("Mailbox without a size should wait for the tick"), Batches.Num(), 1);
+	EventSystem->Tick(0.0f);
+	TestEqual(TEXT("Empty mailbox shouldn't be flushed"), SizedObserver->Counter, FIntVector3(5, 0, 0));
+	TestEqual(TEXT("Mailbox without a size should be flushed on tick"), Batches.Num(), 2);
+
+	// Collected events are kept alive until they're handled.
+	EventSystem->SendEvent(NewObject<ULES_TestEvent>());
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	EventSystem->Tick(0.0f);
+	TestEqual(TEXT("Collected events should survive garbage collection"), SizedObserver->Counter,
+	          FIntVector3(6, 0, 0));
+
+	// Events sent by the batch handler to its own observer wait for the next batch.
+	EventSystem->RemoveByHandle(SizedHandle);
+	int32 NumEchoedBatches = 0;
+	auto EchoHandler = [&EventSystem, &NumEchoedBatches](TArrayView<const ULES_OtherTestEvent* const>)
+	{
+		if (NumEchoedBatches++ == 0)
+			EventSystem->SendEvent(NewObject<ULES_OtherTestEvent>());
+	};
+	EventSystem->AddBatchObserver<ULES_OtherTestEvent>(SizedObserver.Get(), EchoHandler, NAME_None, 1);
+	EventSystem->SendEvent(NewObject<ULES_OtherTestEvent>());
+	TestEqual(TEXT("Echoed event should wait for the next batch"), NumEchoedBatches, 1);
+	EventSystem->Tick(0.0f);
+	TestEqual(TEXT("Echoed event should be handled on tick"), NumEchoedBatches, 2);
+
+	// Suspended mailboxes keep their events, and removed ones drop them.
+	EventSystem->RemoveByHandle(TickedHandle);
+	EventSystem->AddBatchObserver<ULES_TestEvent>(TickedObserver.Get(), BatchHandler, NAME_None, 0, "Paused");
+	EventSystem->SendEvent(FirstEvent.Get());
+	EventSystem->SuspendGroup("Paused");
+	EventSystem->Tick(0.0f);
+	TestEqual(TEXT("Suspended mailbox shouldn't be flushed"), Batches.Num(), 2);
+	EventSystem->ResumeGroup("Paused");
+	EventSystem->Tick(0.0f);
+	TestEqual(TEXT("Resumed mailbox should be flushed"), Batches.Num(), 3);
+
+	EventSystem->SendEvent(FirstEvent.Get());
+	EventSystem->RemoveByObserver(TickedObserver.Get());
+	EventSystem->Tick(0.0f);
+	TestEqual(TEXT("Removed observer shouldn't receive its collected events"), Batches.Num(), 3);
+
+	return true;
+}
@@ -0,0 +1,76 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#include "EventSystemSettings.h"
+#include "TestClasses.h"
+#include "Misc/AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLES_CapacityTest, "Light Event System.Reserved capacity",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+bool FLES_CapacityTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 NumObservers = 1000;
+	const FName Channels[] = {"Reserved", "Reserved 1", "Reserved 2", "Reserved 3"};
+	constexpr int32 NumChannels = UE_ARRAY_COUNT(Channels);
+	constexpr int32 NumObserversPerChannel = NumObservers / NumChannels;
+	const FName Channel = Channels[0];
+
+	auto Settings = TStrongObjectPtr(NewObject<ULES_EventSystemSettings>());
+	Settings->ExpectedNumObservers = NumObservers;
+	Settings->ExpectedNumBuckets = NumChannels + 1;
+	for (const FName ReservedChannel : Channels)
+	{
+		Settings->ExpectedObservers.Add({
+			.EventClass = ULES_TestEvent::StaticClass(),
+			.Channel = ReservedChannel,
+			.NumObservers = NumObserversPerChannel,
+		});
+	}
+	Settings->bWarmUpEventClasses = true;
+
+	auto EventSystem = TStrongObjectPtr(NewObject<ULES_EventSystem>());
+	Settings->ApplyTo(EventSystem.Get());
+	const FLES_MemoryReport ReservedReport = EventSystem->GetMemoryReport();
+	TestEqual(TEXT("Expected buckets should be created up front"), ReservedReport.NumBuckets, NumChannels);
+
+	// Adding the expected observers doesn't grow the record arena, the buckets nor the channel and class indices.
+	TArray<TStrongObjectPtr<ULES_TestObserver>> Observers;
+	for (int32 Index = 0; Index < NumObservers; Index++)
+	{
+		ULES_TestObserver* Observer = Observers.Emplace_GetRef(NewObject<ULES_TestObserver>()).Get();
+		EventSystem->AddObserver<ULES_TestEvent>(Observer, &ULES_TestObserver::OnTestEvent,
+		                                         Channels[Index / NumObserversPerChannel]);
+	}
+	const FLES_MemoryReport Report = EventSystem->GetMemoryReport();
+	TestEqual(TEXT("Record arena shouldn't grow"), Report.RecordArenaBytes, ReservedReport.RecordArenaBytes);
+	TestEqual(TEXT("Tables shouldn't grow"), Report.AllocatedBytes - Report.RecordArenaBytes,
+	          ReservedReport.AllocatedBytes - ReservedReport.RecordArenaBytes);
+
+	// The usage report compares the peak use with the reservations.
+	EventSystem->RemoveByObserver(Observers[0].Get());
+	EventSystem->AddObserver<ULES_OtherTestEvent>(Observers[0].Get(), &ULES_TestObserver::OnOtherTestEvent);
+	FLES_UsageReport Usage = EventSystem->GetUsageReport();
+	TestEqual(TEXT("Reserved records should be reported"), Usage.ReservedRecords, NumObservers);
+	TestEqual(TEXT("Peak records should be reported"), Usage.PeakRecords, NumObservers);
+	TestEqual(TEXT("Reserved buckets should be reported"), Usage.ReservedBuckets, NumChannels + 1);
+	TestEqual(TEXT("Peak buckets should be reported"), Usage.PeakBuckets, NumChannels + 1);
+	if (TestEqual(TEXT("Reserved buckets should be reported"), Usage.Buckets.Num(), NumChannels))
+	{
+		TestEqual(TEXT("Bucket's class should be reported"), Usage.Buckets[0].EventClass.Get(),
+		          ULES_TestEvent::StaticClass());
+		TestEqual(TEXT("Bucket's channel should be reported"), Usage.Buckets[0].Channel, Channel);
+		TestEqual(TEXT("Bucket's peak should be reported"), Usage.Buckets[0].PeakRecords, NumObserversPerChannel);
+		TestEqual(TEXT("Bucket's current use should be reported"), Usage.Buckets[0].NumRecords,
+		          NumObserversPerChannel - 1);
+	}
+
+	// Exceeding the reservation is logged as a warning.
+	EventSystem->AddObserver<ULES_TestEvent>(Observers[0].Get(), &ULES_TestObserver::OnTestEvent, Channel);
+	EventSystem->AddObserver<ULES_TestEvent>(Observers[1].Get(), &ULES_TestObserver::OnTestEvent, Channel);
+	AddExpectedError(TEXT("reserved, but the peak was"), EAutomationExpectedErrorFlags::Contains, 2);
+	EventSystem->LogUsageReport();
+
+	return true;
+}
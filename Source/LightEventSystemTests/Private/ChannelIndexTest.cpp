@@ -0,0 +1,65 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#include "TestClasses.h"
+#include "Misc/AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLES_ChannelIndexTest, "Light Event System.Channel index",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+bool FLES_ChannelIndexTest::RunTest(const FString& Parameters)
+{
+	const FName Channel1 = "Channel1";
+	const FName Channel2 = "Channel2";
+
+	auto EventSystem = TStrongObjectPtr(NewObject<ULES_EventSystem>());
+	auto Observer = TStrongObjectPtr(NewObject<ULES_TestObserver>());
+	auto OtherObserver = TStrongObjectPtr(NewObject<ULES_TestObserver>());
+	EventSystem->AddObserver<ULES_TestEvent>(Observer.Get(), &ULES_TestObserver::OnTestEvent, Channel1);
+	EventSystem->AddObserver<ULES_TestEvent>(OtherObserver.Get(), &ULES_TestObserver::OnTestEvent, Channel1);
+	EventSystem->AddObserver<ULES_OtherTestEvent>(Observer.Get(), &ULES_TestObserver::OnOtherTestEvent, Channel1);
+	EventSystem->AddObserver<ULES_TestEvent>(Observer.Get(), &ULES_TestObserver::OnTestEvent, Channel2);
+	EventSystem->AddObserver<ULES_OtherTestEvent>(Observer.Get(), &ULES_TestObserver::OnOtherTestEvent);
+
+	// Counts are kept per bucket and per channel.
+	TestEqual(TEXT("Should count the observers of a class on a channel"),
+	          EventSystem->GetObserverCount(ULES_TestEvent::StaticClass(), Channel1), 2);
+	TestEqual(TEXT("Shouldn't count the observers of other classes"),
+	          EventSystem->GetObserverCount(ULES_OtherTestEvent::StaticClass(), Channel2), 0);
+	TestEqual(TEXT("Should count the observers of a channel"), EventSystem->GetChannelObserverCount(Channel1), 3);
+	TestEqual(TEXT("Shouldn't count an unused channel"), EventSystem->GetChannelObserverCount("Unused"), 0);
+
+	TArray<FName> Channels;
+	TestEqual(TEXT("Should list the channels in use"), EventSystem->GetChannels(Channels), 3);
+
+	// Removing single records updates the counts.
+	EventSystem->RemoveByObserver(OtherObserver.Get());
+	TestEqual(TEXT("Should count the remaining observers"),
+	          EventSystem->GetObserverCount(ULES_TestEvent::StaticClass(), Channel1), 1);
+	TestEqual(TEXT("Channel count should follow the removal"), EventSystem->GetChannelObserverCount(Channel1), 2);
+
+	// A channel is removed with all of its buckets.
+	TestEqual(TEXT("Should remove the records of the channel"), EventSystem->RemoveByChannel(Channel1), 2);
+	TestEqual(TEXT("Channel should be empty"), EventSystem->GetChannelObserverCount(Channel1), 0);
+	EventSystem->GetChannels(Channels);
+	TestFalse(TEXT("Empty channel shouldn't be listed"), Channels.Contains(Channel1));
+	TestEqual(TEXT("Other channels should be kept"), EventSystem->Num(), 2);
+
+	// An event class is removed on every channel.
+	TestEqual(TEXT("Should remove the records of the class"),
+	          EventSystem->RemoveByEventClass(ULES_TestEvent::StaticClass()), 1);
+	TestEqual(TEXT("Records of other classes should be kept"),
+	          EventSystem->GetObserverCount(ULES_OtherTestEvent::StaticClass()), 1);
+	TestEqual(TEXT("Removing again shouldn't find any records"), EventSystem->RemoveByChannel(Channel1), 0);
+
+	// Emptied channels can be observed again.
+	EventSystem->AddObserver<ULES_TestEvent>(Observer.Get(), &ULES_TestObserver::OnTestEvent, Channel1);
+	ULES_TestEvent* Event = NewObject<ULES_TestEvent>();
+	Event->Channel = Channel1;
+	EventSystem->SendEvent(Event);
+	TestEqual(TEXT("Re-added observer should receive the event"), Observer->Counter.X, 1);
+	TestEqual(TEXT("Re-added observer should be counted"), EventSystem->GetChannelObserverCount(Channel1), 1);
+
+	return true;
+}
@@ -0,0 +1,81 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#include "TestClasses.h"
+#include "Misc/AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLES_ClassObserversTest, "Light Event System.Class observers",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+bool FLES_ClassObserversTest::RunTest(const FString& Parameters)
+{
+	auto EventSystem = TStrongObjectPtr(NewObject<ULES_CountingEventSystem>());
+	auto ExistingObserver = TStrongObjectPtr(NewObject<ULES_TestClassObserver>());
+	auto OtherObserver = TStrongObjectPtr(NewObject<ULES_TestObserver>());
+	const FName Alerts = "Alerts";
+
+	const auto Handle = EventSystem->AddClassObserver<ULES_TestEvent, ULES_TestClassObserver>(
+		&ULES_TestClassObserver::OnTestEvent, Alerts);
+	TestEqual(TEXT("Subscription should be a single record"), EventSystem->Num(), 1);
+	TestTrue(TEXT("Class should be the observer"),
+	         EventSystem->GetObserver(Handle) == ULES_TestClassObserver::StaticClass());
+
+	auto SpawnedObserver = TStrongObjectPtr(NewObject<ULES_TestClassObserver>());
+	auto DerivedObserver = TStrongObjectPtr(NewObject<ULES_DerivedClassObserver>());
+	TestEqual(TEXT("Spawning instances shouldn't add records"), EventSystem->Num(), 1);
+
+	auto Event = TStrongObjectPtr(NewObject<ULES_TestEvent>());
+	Event->Channel = Alerts;
+	EventSystem->SendEvent(Event.Get());
+	TestEqual(TEXT("Existing instance should receive the event"), ExistingObserver->Counter, FIntVector3(1, 0, 0));
+	TestEqual(TEXT("Spawned instance should receive the event"), SpawnedObserver->Counter, FIntVector3(1, 0, 0));
+	TestEqual(TEXT("Subclass instance should receive the event"), DerivedObserver->Counter, FIntVector3(1, 0, 0));
+	TestEqual(TEXT("Other classes shouldn't receive the event"), OtherObserver->Counter, FIntVector3::ZeroValue);
+	TestEqual(TEXT("Class default object shouldn't receive the event"),
+	          GetDefault<ULES_TestClassObserver>()->Counter, FIntVector3::ZeroValue);
+	TestEqual(TEXT("Hooks should run once for the whole class"), EventSystem->BeforeReceiveCount, 1);
+
+	// Destroyed instances stop receiving right away, and leave the list with the garbage collection.
+	ULES_TestClassObserver* DestroyedObserver = SpawnedObserver.Get();
+	SpawnedObserver.Reset();
+	DestroyedObserver->MarkAsGarbage();
+	EventSystem->SendEvent(Event.Get());
+	TestEqual(TEXT("Destroyed instance shouldn't receive events"), DestroyedObserver->Counter, FIntVector3(1, 0, 0));
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	EventSystem->SendEvent(Event.Get());
+	TestEqual(TEXT("Remaining instances should receive events"), ExistingObserver->Counter, FIntVector3(3, 0, 0));
+
+	// Instances spawned by a handler receive the next events.
+	TStrongObjectPtr<ULES_TestClassObserver> HandlerObserver;
+	auto SpawnObserver = [&HandlerObserver](const ULES_TestEvent*)
+	{
+		if (!HandlerObserver.IsValid())
+			HandlerObserver.Reset(NewObject<ULES_TestClassObserver>());
+	};
+	EventSystem->AddObserver<ULES_TestEvent>(OtherObserver.Get(), SpawnObserver, Alerts);
+	EventSystem->SendEvent(Event.Get());
+	EventSystem->SendEvent(Event.Get());
+	TestEqual(TEXT("Instance spawned by a handler should receive the next event"), HandlerObserver->Counter,
+	          FIntVector3(1, 0, 0));
+
+	TestEqual(TEXT("Removing the handle should end the subscription"), EventSystem->RemoveByHandle(Handle), 1);
+	EventSystem->SendEvent(Event.Get());
+	TestEqual(TEXT("Instances shouldn't receive events after unsubscribing"), DerivedObserver->Counter,
+	          FIntVector3(5, 0, 0));
+
+	// Instances are reported before their constructor runs, and receive events only once they're constructed.
+	EventSystem->AddClassObserver<ULES_TestEvent, ULES_ConstructingClassObserver>(
+		&ULES_ConstructingClassObserver::OnTestEvent, Alerts);
+	ULES_ConstructingClassObserver::ConstructionEventSystem = EventSystem.Get();
+	ULES_ConstructingClassObserver::ConstructionEvent = Event.Get();
+	auto ConstructingObserver = TStrongObjectPtr(NewObject<ULES_ConstructingClassObserver>());
+	ULES_ConstructingClassObserver::ConstructionEventSystem = nullptr;
+	ULES_ConstructingClassObserver::ConstructionEvent = nullptr;
+	TestEqual(TEXT("Instance under construction shouldn't receive events"), ConstructingObserver->Counter,
+	          FIntVector3::ZeroValue);
+	EventSystem->SendEvent(Event.Get());
+	TestEqual(TEXT("Constructed instance should receive events"), ConstructingObserver->Counter, FIntVector3(1, 0, 0));
+
+	return true;
+}
@@ -0,0 +1,263 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#include "TestClasses.h"
+#include "Async/Async.h"
+#include "Misc/AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLES_ConcurrentDispatchTest, "Light Event System.Concurrent dispatch",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+bool FLES_ConcurrentDispatchTest::RunTest(const FString& Parameters)
+{
+	auto EventSystem = TStrongObjectPtr(NewObject<ULES_EventSystem>());
+	auto Observer = TStrongObjectPtr(NewObject<ULES_TestObserver>());
+	auto RegularObserver = TStrongObjectPtr(NewObject<ULES_TestObserver>());
+	const FName Channel = "Concurrent";
+
+	std::atomic<int32> NumCalls = 0;
+	auto Handler = [&NumCalls](ULES_TestEvent*) { NumCalls++; };
+	const auto Handle = EventSystem->AddConcurrentObserver<ULES_TestEvent>(Observer.Get(), Handler, Channel);
+	EventSystem->AddObserver<ULES_TestEvent>(RegularObserver.Get(), &ULES_TestObserver::OnTestEvent, Channel);
+	TestEqual(TEXT("Concurrent observer should have a record"), EventSystem->Num(), 2);
+
+	auto Event = TStrongObjectPtr(NewObject<ULES_TestEvent>());
+	Event->Channel = Channel;
+	EventSystem->SendEventConcurrent(Event.Get());
+	TestEqual(TEXT("Concurrent observer should receive concurrent sends"), NumCalls.load(), 1);
+	TestEqual(TEXT("Regular observer shouldn't receive concurrent sends"), RegularObserver->Counter,
+	          FIntVector3::ZeroValue);
+
+	EventSystem->SendEvent(Event.Get());
+	TestEqual(TEXT("Concurrent observer should receive regular sends"), NumCalls.load(), 2);
+	TestEqual(TEXT("Regular observer should receive regular sends"), RegularObserver->Counter, FIntVector3(1, 0, 0));
+
+	// Only the exact event class on the same channel is dispatched.
+	auto OtherChannelEvent = TStrongObjectPtr(NewObject<ULES_TestEvent>());
+	EventSystem->SendEventConcurrent(OtherChannelEvent.Get());
+	EventSystem->SendEventConcurrent(NewObject<ULES_OtherTestEvent>());
+	TestEqual(TEXT("Other channels and classes shouldn't be dispatched"), NumCalls.load(), 2);
+
+	// Sends from other threads.
+	Async(EAsyncExecution::Thread, [&EventSystem, &Event] { EventSystem->SendEventConcurrent(Event.Get()); }).Wait();
+	TestEqual(TEXT("Sends from other threads should be dispatched"), NumCalls.load(), 3);
+
+	EventSystem->RemoveByHandle(Handle);
+	EventSystem->SendEventConcurrent(Event.Get());
+	TestEqual(TEXT("Removed observer shouldn't receive events"), NumCalls.load(), 3);
+
+	// Clean removes the concurrent observers of destroyed objects too.
+	EventSystem->AddConcurrentObserver<ULES_TestEvent>(Observer.Get(), Handler, Channel);
+	Observer->MarkAsGarbage();
+	EventSystem->SendEventConcurrent(Event.Get());
+	TestEqual(TEXT("Destroyed observer shouldn't receive events"), NumCalls.load(), 3);
+	EventSystem->Clean();
+	TestEqual(TEXT("Clean should remove the concurrent observer"), EventSystem->Num(), 1);
+
+	EventSystem->Tick(0.0f);
+	return true;
+}
+
+/**
+ * Senders on several threads dispatch while the game thread keeps adding and removing observers of the same bucket.
+ * Every send has to reach the observer that stays subscribed, and none may reach a freed one.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLES_ConcurrentDispatchStressTest, "Light Event System.Concurrent dispatch stress",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+bool FLES_ConcurrentDispatchStressTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 NumSenders = 4;
+	constexpr int32 NumSendsPerSender = 20000;
+	constexpr int32 NumChurnObservers = 16;
+
+	auto EventSystem = TStrongObjectPtr(NewObject<ULES_EventSystem>());
+	auto Event = TStrongObjectPtr(NewObject<ULES_TestEvent>());
+	Event->Channel = NAME_None;
+
+	auto Observer = TStrongObjectPtr(NewObject<ULES_TestObserver>());
+	std::atomic<int32> NumCalls = 0;
+	EventSystem->AddConcurrentObserver<ULES_TestEvent>(Observer.Get(), [&NumCalls](ULES_TestEvent*) { NumCalls++; });
+
+	TArray<TStrongObjectPtr<ULES_TestObserver>> ChurnObservers;
+	for (int32 Index = 0; Index < NumChurnObservers; Index++)
+		ChurnObservers.Emplace(NewObject<ULES_TestObserver>());
+
+	std::atomic<int32> NumRunningSenders = NumSenders;
+	TArray<TFuture<void>> Senders;
+	for (int32 Index = 0; Index < NumSenders; Index++)
+	{
+		Senders.Add(Async(EAsyncExecution::Thread, [&EventSystem, &Event, &NumRunningSenders]
+		{
+			for (int32 SendIndex = 0; SendIndex < NumSendsPerSender; SendIndex++)
+				EventSystem->SendEventConcurrent(Event.Get());
+			NumRunningSenders--;
+		}));
+	}
+
+	std::atomic<int32> NumChurnCalls = 0;
+	TArray<FLES_ObserverHandle> ChurnHandles;
+	FRandomStream Random(1234);
+	int32 NumIterations = 0;
+	while (NumRunningSenders > 0)
+	{
+		for (const TStrongObjectPtr<ULES_TestObserver>& ChurnObserver : ChurnObservers)
+		{
+			ChurnHandles.Add(EventSystem->AddConcurrentObserver<ULES_TestEvent>(
+				ChurnObserver.Get(), [&NumChurnCalls](ULES_TestEvent*) { NumChurnCalls++; }));
+		}
+		while (!ChurnHandles.IsEmpty())
+			EventSystem->RemoveByHandle(ChurnHandles.Pop());
+		if (Random.FRand() < 0.5f)
+			EventSystem->Clean();
+		EventSystem->Tick(0.0f);
+		NumIterations++;
+	}
+	for (TFuture<void>& Sender : Senders)
+		Sender.Wait();
+	EventSystem->Tick(0.0f);
+
+	AddInfo(FString::Printf(TEXT("%d add and remove rounds, %d calls of the churned observers"), NumIterations,
+	                        NumChurnCalls.load()));
+	TestEqual(TEXT("Every send should reach the permanent observer"), NumCalls.load(), NumSenders * NumSendsPerSender);
+	TestEqual(TEXT("Only the permanent observer should be left"), EventSystem->Num(), 1);
+	return true;
+}
+
+/**
+ * Senders on several threads dispatch while the game thread keeps adding observers that nothing references and
+ * collecting the garbage, which removes their records. The handlers check the state they capture, which mustn't be
+ * freed while a send may still call them.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLES_ConcurrentDispatchGarbageCollectionTest,
+                                 "Light Event System.Concurrent dispatch garbage collection",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::StressFilter)
+
+bool FLES_ConcurrentDispatchGarbageCollectionTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 NumSenders = 4;
+	constexpr int32 NumRounds = 32;
+	constexpr int32 NumCollectedObservers = 16;
+
+	auto EventSystem = TStrongObjectPtr(NewObject<ULES_EventSystem>());
+	auto Event = TStrongObjectPtr(NewObject<ULES_TestEvent>());
+	Event->Channel = NAME_None;
+
+	// Destroyed with the handler capturing it.
+	struct FHandlerState
+	{
+		std::atomic<bool> bAlive = true;
+		~FHandlerState() { bAlive = false; }
+	};
+
+	std::atomic<int32> NumCalls = 0;
+	std::atomic<int32> NumInvalidCalls = 0;
+	std::atomic<bool> bStop = false;
+	TArray<TFuture<void>> Senders;
+	for (int32 Index = 0; Index < NumSenders; Index++)
+	{
+		Senders.Add(Async(EAsyncExecution::Thread, [&EventSystem, &Event, &bStop]
+		{
+			while (!bStop)
+				EventSystem->SendEventConcurrent(Event.Get());
+		}));
+	}
+
+	for (int32 Round = 0; Round < NumRounds; Round++)
+	{
+		for (int32 Index = 0; Index < NumCollectedObservers; Index++)
+		{
+			auto State = MakeShared<FHandlerState, ESPMode::ThreadSafe>();
+			EventSystem->AddConcurrentObserver<ULES_TestEvent>(NewObject<ULES_TestObserver>(), [State, &NumCalls,
+				&NumInvalidCalls](ULES_TestEvent*)
+			{
+				NumCalls++;
+				if (!State->bAlive)
+					NumInvalidCalls++;
+			});
+		}
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+		EventSystem->Tick(0.0f);
+	}
+	bStop = true;
+	for (TFuture<void>& Sender : Senders)
+		Sender.Wait();
+	EventSystem->Clean();
+	EventSystem->Tick(0.0f);
+
+	AddInfo(FString::Printf(TEXT("%d garbage collections, %d calls of the collected observers"), NumRounds,
+	                        NumCalls.load()));
+	TestEqual(TEXT("Handlers shouldn't see their captures freed"), NumInvalidCalls.load(), 0);
+	TestEqual(TEXT("Collected observers should be removed"), EventSystem->Num(), 0);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLES_ConcurrentDispatchBenchmark, "Light Event System.Benchmark.Concurrent dispatch",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::StressFilter)
+
+bool FLES_ConcurrentDispatchBenchmark::RunTest(const FString& Parameters)
+{
+	constexpr int32 NumObservers = 8;
+	constexpr int32 NumSendsPerThread = 200000;
+	const int32 ThreadCounts[] = {1, 2, 4, 8, 16, 32};
+
+	auto EventSystem = TStrongObjectPtr(NewObject<ULES_EventSystem>());
+	auto Event = TStrongObjectPtr(NewObject<ULES_TestEvent>());
+	Event->Channel = NAME_None;
+
+	// Every observer counts on its own cache line, so that the handlers don't dominate the measurement.
+	struct alignas(64) FPaddedCounter
+	{
+		std::atomic<int64> Value = 0;
+	};
+	FPaddedCounter Counters[NumObservers];
+	TArray<TStrongObjectPtr<ULES_TestObserver>> Observers;
+	for (FPaddedCounter& Counter : Counters)
+	{
+		ULES_TestObserver* Observer = Observers.Emplace_GetRef(NewObject<ULES_TestObserver>()).Get();
+		EventSystem->AddConcurrentObserver<ULES_TestEvent>(Observer, [&Counter](ULES_TestEvent*)
+		{
+			Counter.Value.fetch_add(1, std::memory_order_relaxed);
+		});
+	}
+
+	double SingleThreadRate = 0.0;
+	for (const int32 NumThreads : ThreadCounts)
+	{
+		std::atomic<bool> bStart = false;
+		TArray<TFuture<void>> Senders;
+		for (int32 Index = 0; Index < NumThreads; Index++)
+		{
+			Senders.Add(Async(EAsyncExecution::Thread, [&EventSystem, &Event, &bStart]
+			{
+				while (!bStart)
+					FPlatformProcess::Yield();
+				for (int32 SendIndex = 0; SendIndex < NumSendsPerThread; SendIndex++)
+					EventSystem->SendEventConcurrent(Event.Get());
+			}));
+		}
+
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+		bStart = true;
+		for (TFuture<void>& Sender : Senders)
+			Sender.Wait();
+		const double Time = FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - StartCycles);
+
+		const double Rate = static_cast<double>(NumThreads) * NumSendsPerThread / Time;
+		if (NumThreads == 1)
+			SingleThreadRate = Rate;
+		AddInfo(FString::Printf(TEXT("%2d threads: %.2f M sends/s, %.2fx of one thread"), NumThreads, Rate / 1.0e6,
+		                        Rate / SingleThreadRate));
+	}
+
+	int64 ExpectedCalls = 0;
+	for (const int32 NumThreads : ThreadCounts)
+		ExpectedCalls += static_cast<int64>(NumThreads) * NumSendsPerThread;
+	TestEqual(TEXT("Every observer should receive every event"), Counters[0].Value.load(), ExpectedCalls);
+	return true;
+}
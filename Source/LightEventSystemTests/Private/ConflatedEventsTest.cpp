@@ -0,0 +1,67 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#include "BasicEvents.h"
+#include "TestClasses.h"
+#include "Misc/AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLES_ConflatedEventsTest, "Light Event System.Conflated events",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+bool FLES_ConflatedEventsTest::RunTest(const FString& Parameters)
+{
+	ULES_EventSystem* EventSystem = NewObject<ULES_EventSystem>();
+	ULES_TestObserver* TestObserver = NewObject<ULES_TestObserver>();
+	UObject* Sender1 = NewObject<ULES_TestObserver>();
+	UObject* Sender2 = NewObject<ULES_TestObserver>();
+
+	TArray<int32> Values;
+	EventSystem->AddObserver<ULES_IntegerEvent>(TestObserver, [&Values](const ULES_IntegerEvent* Event)
+	{
+		Values.Add(Event->Value);
+	});
+
+	EventSystem->SendEventConflated(LES::Create<ULES_IntegerEvent>(1, Sender1, NAME_None));
+	EventSystem->SendEventConflated(LES::Create<ULES_IntegerEvent>(10, Sender2, NAME_None));
+	EventSystem->SendEventConflated(LES::Create<ULES_IntegerEvent>(2, Sender1, NAME_None));
+	EventSystem->SendEventConflated(LES::Create<ULES_IntegerEvent>(3, Sender1, NAME_None));
+	EventSystem->SendEventConflated(nullptr);
+	TestEqual(TEXT("Conflated events shouldn't be sent right away"), Values.Num(), 0);
+
+	EventSystem->Tick(0.f);
+	TestEqual(TEXT("Only the latest event per sender should be sent, in the order of first send"), Values,
+	          TArray<int32>{3, 10});
+
+	const FLES_ConflationStats Stats = EventSystem->GetConflationStats();
+	TestEqual(TEXT("Should count 4 sends"), Stats.NumSends, static_cast<int64>(4));
+	TestEqual(TEXT("Should count 2 merged sends"), Stats.NumMerged, static_cast<int64>(2));
+	TestEqual(TEXT("Should count 2 dispatched events"), Stats.NumDispatched, static_cast<int64>(2));
+
+	// With manual flushing, events wait until flushed explicitly.
+	Values.Reset();
+	EventSystem->ConflationFlushPoint = ELES_ConflationFlushPoint::Manual;
+	EventSystem->SendEventConflated(LES::Create<ULES_IntegerEvent>(4, Sender1, NAME_None));
+	EventSystem->Tick(0.f);
+	TestEqual(TEXT("Manually flushed events shouldn't be sent when ticked"), Values.Num(), 0);
+	EventSystem->FlushConflatedEvents();
+	TestEqual(TEXT("Manually flushed events should be sent when flushed"), Values, TArray<int32>{4});
+
+	// Handlers flushing the queue during a flush leave their events for the next one.
+	Values.Reset();
+	EventSystem->AddObserver<ULES_ByteEvent>(TestObserver, [EventSystem, Sender1](const ULES_ByteEvent*)
+	{
+		EventSystem->SendEventConflated(LES::Create<ULES_IntegerEvent>(5, Sender1, NAME_None));
+		EventSystem->FlushConflatedEvents();
+	});
+	EventSystem->SendEventConflated(LES::Create<ULES_ByteEvent>(static_cast<uint8>(1), Sender1, NAME_None));
+	EventSystem->FlushConflatedEvents();
+	TestEqual(TEXT("Events conflated by handlers shouldn't be sent by a nested flush"), Values.Num(), 0);
+	EventSystem->FlushConflatedEvents();
+	TestEqual(TEXT("Events conflated by handlers should be sent by the next flush"), Values, TArray<int32>{5});
+
+	EventSystem->ResetConflationStats();
+	TestEqual(TEXT("Stats should be reset"), EventSystem->GetConflationStats().NumSends, static_cast<int64>(0));
+
+	return true;
+}
@@ -11,6 +11,7 @@ IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLES_ObserverLifetimeTest, "Light Event System.
 bool FLES_ObserverLifetimeTest::RunTest(const FString& Parameters)
 {
 	auto EventSystem = TStrongObjectPtr(NewObject<ULES_EventSystem>());
+	EventSystem->bCleanAfterGarbageCollection = false;
 	ULES_TestObserver* TestObserver = NewObject<ULES_TestObserver>();
 
 	const TWeakObjectPtr<> ObserverPtr = TestObserver;
@@ -34,6 +35,94 @@ bool FLES_ObserverLifetimeTest::RunTest(const FString& Parameters)
 	return true;
 }
 
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLES_EventClassLifetimeTest, "Light Event System.Event class lifetime",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+bool FLES_EventClassLifetimeTest::RunTest(const FString& Parameters)
+{
+	auto EventSystem = TStrongObjectPtr(NewObject<ULES_EventSystem>());
+	auto TestObserver = TStrongObjectPtr(NewObject<ULES_TestObserver>());
+
+	// Stands in for a blueprint event class from a level that gets unloaded.
+	UClass* TransientClass = NewObject<UClass>(GetTransientPackage(), "LES_TransientTestEvent", RF_Transient);
+	TransientClass->SetSuperStruct(ULES_TestEvent::StaticClass());
+	TransientClass->Bind();
+	TransientClass->StaticLink(true);
+	const TWeakObjectPtr<UClass> TransientClassPtr = TransientClass;
+
+	EventSystem->AddObserver<ULES_TestEvent>(TestObserver.Get(), &ULES_TestObserver::OnTestEvent);
+	const auto Handle = EventSystem->BP_AddObserver_Event(TransientClass, TestObserver.Get(), {});
+	const auto Token = EventSystem->ResolveSendToken(TransientClass);
+	TestTrue(TEXT("Handle should be valid"), ULES_EventSystem::IsHandleValid(Handle));
+	TestEqual(TEXT("Should contain 2 buckets"), EventSystem->GetMemoryReport().NumBuckets, 2);
+	TransientClass = nullptr;
+
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	TestFalse(TEXT("Event System shouldn't keep the event class alive"), TransientClassPtr.IsValid());
+
+	const FLES_MemoryReport Report = EventSystem->GetMemoryReport();
+	TestEqual(TEXT("Bucket of the unloaded class should be purged"), Report.NumPurgedBuckets, 1);
+	TestEqual(TEXT("Records of the unloaded class should be purged"), Report.NumPurgedRecords, 1);
+	TestTrue(TEXT("Purging should reclaim memory"), Report.ReclaimedBytes > 0);
+	TestEqual(TEXT("Should contain 1 bucket"), Report.NumBuckets, 1);
+	TestEqual(TEXT("Should contain 1 observer record"), EventSystem->Num(), 1);
+	TestFalse(TEXT("Handle should be invalid"), ULES_EventSystem::IsHandleValid(Handle));
+	TestFalse(TEXT("Token should be invalid"), EventSystem->IsSendTokenValid(Token));
+
+	EventSystem->SendEvent(NewObject<ULES_TestEvent>());
+	TestEqual(TEXT("Remaining observers should still receive events"), TestObserver->Counter, FIntVector3(1, 0, 0));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLES_ObserverRecordArenaTest, "Light Event System.Observer record arena",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+bool FLES_ObserverRecordArenaTest::RunTest(const FString& Parameters)
+{
+	auto EventSystem = TStrongObjectPtr(NewObject<ULES_EventSystem>());
+	auto TestObserver = TStrongObjectPtr(NewObject<ULES_TestObserver>());
+
+	const auto Handle1 = EventSystem->AddObserver<ULES_TestEvent>(TestObserver.Get(), &ULES_TestObserver::OnTestEvent);
+	const auto Handle2 = EventSystem->AddObserver<ULES_TestEvent>(TestObserver.Get(), &ULES_TestObserver::OnTestEvent);
+	TestEqual(TEXT("Should use 2 record slots"), EventSystem->GetMemoryReport().RecordCapacity, 2);
+
+	EventSystem->RemoveByHandle(Handle1);
+	TestFalse(TEXT("Removed handle should be invalid"), ULES_EventSystem::IsHandleValid(Handle1));
+
+	// Reuses the released slot, but the old handle must not refer to the new record.
+	const auto Handle3 = EventSystem->AddObserver<ULES_TestEvent>(TestObserver.Get(), &ULES_TestObserver::OnTestEvent);
+	TestEqual(TEXT("Released slot should be reused"), EventSystem->GetMemoryReport().RecordCapacity, 2);
+	TestFalse(TEXT("Old handle should stay invalid after its slot is reused"), ULES_EventSystem::IsHandleValid(Handle1));
+	TestEqual(TEXT("Old handle shouldn't remove the new record"), EventSystem->RemoveByHandle(Handle1), 0);
+	TestTrue(TEXT("New handle should be valid"), ULES_EventSystem::IsHandleValid(Handle3));
+	TestTrue(TEXT("Other handles should be unaffected"), ULES_EventSystem::IsHandleValid(Handle2));
+
+	// Large handlers don't fit inside the record.
+	TArray<uint8, TInlineAllocator<64>> LargeCapture;
+	LargeCapture.Add(1);
+	int32 LargeCaptureSum = 0;
+	EventSystem->AddObserver<ULES_TestEvent>(TestObserver.Get(), [LargeCapture, &LargeCaptureSum](const ULES_TestEvent*)
+	{
+		LargeCaptureSum += LargeCapture[0];
+	});
+
+	const FLES_MemoryReport Report = EventSystem->GetMemoryReport();
+	TestEqual(TEXT("Should contain 3 observer records"), Report.NumRecords, 3);
+	TestEqual(TEXT("Only the large handler should be allocated on the heap"), Report.NumHeapCallbacks, 1);
+	TestTrue(TEXT("Arena should be counted in the allocated bytes"), Report.AllocatedBytes >= Report.RecordArenaBytes);
+
+	EventSystem->SendEvent(NewObject<ULES_TestEvent>());
+	TestEqual(TEXT("Arena records should receive events"), TestObserver->Counter, FIntVector3(2, 0, 0));
+	TestEqual(TEXT("Heap-allocated handler should receive events"), LargeCaptureSum, 1);
+
+	return true;
+}
+
 IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLES_AddingObserversTest, "Light Event System.Adding observers",
                                  EAutomationTestFlags::ApplicationContextMask |
                                  EAutomationTestFlags::HighPriority |
@@ -127,6 +216,53 @@ bool FLES_AddingObserversTest::RunTest(const FString& Parameters)
 	return true;
 }
 
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLES_ResolvedObserversTest, "Light Event System.Adding resolved observers",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+bool FLES_ResolvedObserversTest::RunTest(const FString& Parameters)
+{
+	auto EventSystem = TStrongObjectPtr(NewObject<ULES_EventSystem>());
+	auto TestObserver = TStrongObjectPtr(NewObject<ULES_TestObserver>());
+
+	// Handlers checked by the Add Observer node are registered by name.
+	const auto Handle = EventSystem->BP_AddObserver_Resolved(ULES_TestEvent::StaticClass(), TestObserver.Get(),
+	                                                         "OnTestEvent", NAME_None, NAME_None);
+	TestTrue(TEXT("Adding observers should return valid handles"), ULES_EventSystem::IsHandleValid(Handle));
+	TestTrue(TEXT("Should contain the handle"), EventSystem->ContainsValidHandle(Handle));
+	EventSystem->SendEvent(NewObject<ULES_TestEvent>());
+	TestEqual(TEXT("Resolved handler should receive the event"), TestObserver->Counter, FIntVector3(1, 0, 0));
+
+	// Handlers taking a base class of the event are accepted.
+	const auto BaseHandle = EventSystem->BP_AddObserver_Resolved(ULES_DerivedEvent::StaticClass(), TestObserver.Get(),
+	                                                             "OnTestEvent", NAME_None, NAME_None);
+	TestTrue(TEXT("Handler taking a base class should be accepted"), ULES_EventSystem::IsHandleValid(BaseHandle));
+
+	// The observer passed at runtime may not match the one the node was compiled against.
+	const auto UnknownHandle = EventSystem->BP_AddObserver_Resolved(
+		ULES_TestEvent::StaticClass(), TestObserver.Get(), "NoSuchFunction", NAME_None, NAME_None);
+	TestFalse(TEXT("Unknown functions should return invalid handles"), ULES_EventSystem::IsHandleValid(UnknownHandle));
+
+	const auto WrongClassHandle = EventSystem->BP_AddObserver_Resolved(
+		ULES_TestEvent::StaticClass(), TestObserver.Get(), "OnOtherTestEvent", NAME_None, NAME_None);
+	TestFalse(TEXT("Handlers of another event class should return invalid handles"),
+	          ULES_EventSystem::IsHandleValid(WrongClassHandle));
+
+	const auto DerivedOnlyHandle = EventSystem->BP_AddObserver_Resolved(
+		ULES_TestEvent::StaticClass(), TestObserver.Get(), "OnDerivedEvent", NAME_None, NAME_None);
+	TestFalse(TEXT("Handlers taking a subclass of the event should return invalid handles"),
+	          ULES_EventSystem::IsHandleValid(DerivedOnlyHandle));
+
+	const auto NoParamsHandle = EventSystem->BP_AddObserver_Resolved(
+		ULES_TestEvent::StaticClass(), TestObserver.Get(), "AddToCounter", NAME_None, NAME_None);
+	TestFalse(TEXT("Functions with another signature should return invalid handles"),
+	          ULES_EventSystem::IsHandleValid(NoParamsHandle));
+
+	TestEqual(TEXT("Should contain 2 observer records"), EventSystem->Num(), 2);
+	return true;
+}
+
 IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLES_RemovingObserversTest, "Light Event System.Removing observers",
                                  EAutomationTestFlags::ApplicationContextMask |
                                  EAutomationTestFlags::HighPriority |
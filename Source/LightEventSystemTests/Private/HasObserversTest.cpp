@@ -0,0 +1,84 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#include "TestClasses.h"
+#include "Misc/AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLES_HasObserversTest, "Light Event System.Has observers",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+bool FLES_HasObserversTest::RunTest(const FString& Parameters)
+{
+	auto EventSystem = TStrongObjectPtr(NewObject<ULES_EventSystem>());
+	auto TestObserver = TStrongObjectPtr(NewObject<ULES_TestObserver>());
+	const FName Channel = "Some channel";
+
+	TestFalse(TEXT("Should have no observers"), EventSystem->HasObservers(ULES_TestEvent::StaticClass(), Channel));
+	EventSystem->ResolveSendToken(ULES_TestEvent::StaticClass(), Channel);
+	TestFalse(TEXT("Resolving a token shouldn't add observers"),
+	          EventSystem->HasObservers(ULES_TestEvent::StaticClass(), Channel));
+
+	const auto Handle = EventSystem->AddObserver<ULES_TestEvent>(TestObserver.Get(), &ULES_TestObserver::OnTestEvent,
+	                                                             Channel);
+	TestTrue(TEXT("Should have observers"), EventSystem->HasObservers(ULES_TestEvent::StaticClass(), Channel));
+	TestFalse(TEXT("Other channels should have no observers"),
+	          EventSystem->HasObservers(ULES_TestEvent::StaticClass()));
+	TestFalse(TEXT("Derived classes should have no observers"),
+	          EventSystem->HasObservers(ULES_DerivedEvent::StaticClass(), Channel));
+
+	// Lazy events are created only when someone listens.
+	int32 NumCreated = 0;
+	auto Factory = [&NumCreated]
+	{
+		NumCreated++;
+		return NewObject<ULES_TestEvent>();
+	};
+	TestTrue(TEXT("Observed lazy event should be sent"), EventSystem->SendEventLazy<ULES_TestEvent>(Channel, Factory));
+	TestFalse(TEXT("Unobserved lazy event shouldn't be sent"),
+	          EventSystem->SendEventLazy<ULES_TestEvent>(NAME_None, Factory));
+	TestEqual(TEXT("Only the observed lazy event should be created"), NumCreated, 1);
+	TestEqual(TEXT("Lazy event should be received on its channel"), TestObserver->Counter, FIntVector3(1, 0, 0));
+
+	EventSystem->RemoveByHandle(Handle);
+	TestFalse(TEXT("Should have no observers after removal"),
+	          EventSystem->HasObservers(ULES_TestEvent::StaticClass(), Channel));
+
+	// Emptied buckets eventually rebuild the filter, without affecting the answers.
+	for (int32 Index = 0; Index < 100; Index++)
+	{
+		EventSystem->AddObserver<ULES_TestEvent>(TestObserver.Get(), &ULES_TestObserver::OnTestEvent,
+		                                         FName("Channel", Index));
+	}
+	TestTrue(TEXT("Should have observers on each channel"),
+	         EventSystem->HasObservers(ULES_TestEvent::StaticClass(), FName("Channel", 99)));
+	EventSystem->RemoveAll();
+	for (int32 Index = 0; Index < 100; Index++)
+	{
+		if (EventSystem->HasObservers(ULES_TestEvent::StaticClass(), FName("Channel", Index)))
+			AddError(FString::Printf(TEXT("Channel %d shouldn't have observers after removal"), Index));
+	}
+
+#if LES_WITH_SEND_REPORT
+	EventSystem->ResetUnobservedSends();
+	for (int32 Index = 0; Index < 3; Index++)
+		EventSystem->SendEvent(NewObject<ULES_OtherTestEvent>());
+	EventSystem->SendEventLazy<ULES_TestEvent>(Channel, Factory);
+
+	const TArray<FLES_UnobservedSend> Report = EventSystem->GetUnobservedSends();
+	if (TestEqual(TEXT("Report should list 2 call sites"), Report.Num(), 2))
+	{
+		TestEqual(TEXT("Most frequent sends should be first"), Report[0].EventClass.Get(),
+		          ULES_OtherTestEvent::StaticClass());
+		TestEqual(TEXT("Sends from one call site should be counted together"), Report[0].NumSends,
+		          static_cast<int64>(3));
+		TestEqual(TEXT("Skipped lazy events should be reported"), Report[1].Channel, Channel);
+	}
+	TestEqual(TEXT("Filtering by the amount of sends"), EventSystem->GetUnobservedSends(2).Num(), 1);
+
+	EventSystem->ResetUnobservedSends();
+	TestEqual(TEXT("Report should be empty after reset"), EventSystem->GetUnobservedSends().Num(), 0);
+#endif
+
+	return true;
+}
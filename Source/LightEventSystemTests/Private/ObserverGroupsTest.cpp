@@ -0,0 +1,58 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#include "TestClasses.h"
+#include "Misc/AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLES_ObserverGroupsTest, "Light Event System.Observer groups",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+bool FLES_ObserverGroupsTest::RunTest(const FString& Parameters)
+{
+	auto EventSystem = TStrongObjectPtr(NewObject<ULES_EventSystem>());
+	auto GameplayObserver = TStrongObjectPtr(NewObject<ULES_TestObserver>());
+	auto UngroupedObserver = TStrongObjectPtr(NewObject<ULES_TestObserver>());
+	const FName Gameplay = "Gameplay";
+
+	const auto Handle = EventSystem->AddObserver<ULES_TestEvent>(GameplayObserver.Get(), &ULES_TestObserver::OnTestEvent,
+	                                                             NAME_None, {}, Gameplay);
+	EventSystem->AddObserver<ULES_TestEvent>(UngroupedObserver.Get(), &ULES_TestObserver::OnTestEvent);
+	TestEqual(TEXT("Record should belong to its group"), EventSystem->GetGroup(Handle), Gameplay);
+
+	EventSystem->SendEvent(NewObject<ULES_TestEvent>());
+	TestEqual(TEXT("Grouped observer should receive events"), GameplayObserver->Counter, FIntVector3(1, 0, 0));
+	TestEqual(TEXT("Ungrouped observer should receive events"), UngroupedObserver->Counter, FIntVector3(1, 0, 0));
+
+	// Suspended records stay registered, but don't receive events.
+	EventSystem->SuspendGroup(Gameplay);
+	TestTrue(TEXT("Group should be suspended"), EventSystem->IsGroupSuspended(Gameplay));
+	EventSystem->SendEvent(NewObject<ULES_TestEvent>());
+	TestEqual(TEXT("Suspended observer shouldn't receive events"), GameplayObserver->Counter, FIntVector3(1, 0, 0));
+	TestEqual(TEXT("Ungrouped observer should still receive events"), UngroupedObserver->Counter, FIntVector3(2, 0, 0));
+	TestEqual(TEXT("Suspended records should stay registered"), EventSystem->Num(), 2);
+	TestTrue(TEXT("Suspended handle should stay valid"), ULES_EventSystem::IsHandleValid(Handle));
+
+	// Records added to a suspended group start suspended.
+	EventSystem->AddObserver<ULES_DerivedEvent>(GameplayObserver.Get(), &ULES_TestObserver::OnDerivedEvent, NAME_None,
+	                                            {}, Gameplay);
+	EventSystem->SendEvent(NewObject<ULES_DerivedEvent>());
+	TestEqual(TEXT("Records added while suspended should be suspended"), GameplayObserver->Counter,
+	          FIntVector3(1, 0, 0));
+
+	EventSystem->ResumeGroup(Gameplay);
+	TestFalse(TEXT("Group should be resumed"), EventSystem->IsGroupSuspended(Gameplay));
+	EventSystem->SendEvent(NewObject<ULES_TestEvent>());
+	EventSystem->SendEvent(NewObject<ULES_DerivedEvent>());
+	TestEqual(TEXT("Resumed observer should receive events"), GameplayObserver->Counter, FIntVector3(2, 1, 0));
+
+	// Records without a group can't be suspended.
+	EventSystem->SuspendGroup(NAME_None);
+	EventSystem->SendEvent(NewObject<ULES_TestEvent>());
+	TestEqual(TEXT("Ungrouped observer can't be suspended"), UngroupedObserver->Counter, FIntVector3(4, 0, 0));
+
+	TestEqual(TEXT("Removing the grouped observer should remove its records"),
+	          EventSystem->RemoveByObserver(GameplayObserver.Get()), 2);
+
+	return true;
+}
@@ -0,0 +1,82 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#include "TestClasses.h"
+#include "Misc/AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLES_QueryTest, "Light Event System.Queries",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+bool FLES_QueryTest::RunTest(const FString& Parameters)
+{
+	const FName Channel = "Query";
+
+	auto EventSystem = TStrongObjectPtr(NewObject<ULES_CountingEventSystem>());
+	auto Observer = TStrongObjectPtr(NewObject<ULES_TestObserver>());
+	auto Query = TStrongObjectPtr(NewObject<ULES_TestEvent>());
+	Query->Channel = Channel;
+
+	// Three observers answering with their own values.
+	TArray<float> Answers = {2.0f, -1.0f, 5.0f};
+	int32 NumCalls = 0;
+	for (int32 Index = 0; Index < Answers.Num(); Index++)
+	{
+		EventSystem->AddQueryObserver<ULES_TestEvent, float>(Observer.Get(), [&Answers, &NumCalls, Index](
+			const ULES_TestEvent*, LES::TQueryResult<float>& Result)
+		{
+			NumCalls++;
+			Result.Add(Answers[Index]);
+		}, Channel);
+	}
+	EventSystem->AddObserver<ULES_TestEvent>(Observer.Get(), &ULES_TestObserver::OnTestEvent, Channel);
+
+	TestEqual(TEXT("Sum should be reduced"), EventSystem->Query<float>(Query.Get(), ELES_QueryReducer::Sum).Get(),
+	          6.0f);
+	TestEqual(TEXT("Min should be reduced"), EventSystem->Query<float>(Query.Get(), ELES_QueryReducer::Min).Get(),
+	          -1.0f);
+	TestEqual(TEXT("Max should be reduced"), EventSystem->Query<float>(Query.Get(), ELES_QueryReducer::Max).Get(),
+	          5.0f);
+	const LES::TQueryResult<float> Collected = EventSystem->Query<float>(Query.Get(), ELES_QueryReducer::Collect);
+	TestTrue(TEXT("Answers should be collected in order"), Collected.GetValues() == Answers);
+	TestEqual(TEXT("Other observers should receive the query"), Observer->Counter.X, 4);
+	TestEqual(TEXT("Receive hooks should run for the queries"), EventSystem->BeforeReceiveCount, 16);
+
+	// Normal sends aren't answered.
+	NumCalls = 0;
+	EventSystem->SendEvent(Query.Get());
+	TestEqual(TEXT("Query handlers shouldn't answer normal sends"), NumCalls, 0);
+
+	// AND stops at the first false answer, and OR at the first true one.
+	auto BoolQuery = TStrongObjectPtr(NewObject<ULES_OtherTestEvent>());
+	TArray<bool> BoolAnswers = {true, false, true};
+	NumCalls = 0;
+	for (int32 Index = 0; Index < BoolAnswers.Num(); Index++)
+	{
+		EventSystem->AddQueryObserver<ULES_OtherTestEvent, bool>(Observer.Get(), [&BoolAnswers, &NumCalls, Index](
+			const ULES_OtherTestEvent*, LES::TQueryResult<bool>& Result)
+		{
+			NumCalls++;
+			Result.Add(BoolAnswers[Index]);
+		});
+	}
+	TestFalse(TEXT("AND should be false"), EventSystem->Query<bool>(BoolQuery.Get(), ELES_QueryReducer::And).Get(true));
+	TestEqual(TEXT("AND should stop at the first false answer"), NumCalls, 2);
+
+	NumCalls = 0;
+	TestTrue(TEXT("OR should be true"), EventSystem->Query<bool>(BoolQuery.Get(), ELES_QueryReducer::Or).Get());
+	TestEqual(TEXT("OR should stop at the first true answer"), NumCalls, 1);
+
+	BoolAnswers = {true, true, true};
+	NumCalls = 0;
+	TestTrue(TEXT("AND should be true"), EventSystem->Query<bool>(BoolQuery.Get(), ELES_QueryReducer::And).Get());
+	TestEqual(TEXT("Every observer should be asked"), NumCalls, 3);
+
+	// Queries without answers return the default.
+	EventSystem->RemoveByObserver(Observer.Get());
+	const LES::TQueryResult<bool> Unanswered = EventSystem->Query<bool>(BoolQuery.Get(), ELES_QueryReducer::And);
+	TestFalse(TEXT("Unanswered query shouldn't have a value"), Unanswered.HasValue());
+	TestTrue(TEXT("Unanswered query should return the default"), Unanswered.Get(true));
+
+	return true;
+}
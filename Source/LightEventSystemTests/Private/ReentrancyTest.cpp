@@ -0,0 +1,123 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#include "TestClasses.h"
+#include "Misc/AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLES_ReentrancyTest, "Light Event System.Reentrancy",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+bool FLES_ReentrancyTest::RunTest(const FString& Parameters)
+{
+	ULES_TestObserver* TestObserver = NewObject<ULES_TestObserver>();
+
+	// Removing observers from inside a handler.
+	{
+		ULES_EventSystem* EventSystem = NewObject<ULES_EventSystem>();
+		int SelfRemovingCalls = 0;
+		int RemovedCalls = 0;
+		int LastCalls = 0;
+
+		FLES_ObserverHandle SelfRemovingHandle;
+		FLES_ObserverHandle RemovedHandle;
+		SelfRemovingHandle = EventSystem->AddObserver<ULES_TestEvent>(TestObserver, [&](const ULES_TestEvent*)
+		{
+			SelfRemovingCalls++;
+			TestEqual(TEXT("Removing itself should remove 1 record"), EventSystem->RemoveByHandle(SelfRemovingHandle), 1);
+			TestEqual(TEXT("Removing a later observer should remove 1 record"),
+			          EventSystem->RemoveByHandle(RemovedHandle), 1);
+			TestFalse(TEXT("Handles should be invalid right after removal"),
+			          ULES_EventSystem::IsHandleValid(SelfRemovingHandle));
+			TestEqual(TEXT("Should count the remaining records"), EventSystem->Num(), 1);
+		});
+		RemovedHandle = EventSystem->AddObserver<ULES_TestEvent>(TestObserver, [&](const ULES_TestEvent*)
+		{
+			RemovedCalls++;
+		});
+		EventSystem->AddObserver<ULES_TestEvent>(TestObserver, [&](const ULES_TestEvent*)
+		{
+			LastCalls++;
+		});
+
+		EventSystem->SendEvent(NewObject<ULES_TestEvent>());
+		EventSystem->SendEvent(NewObject<ULES_TestEvent>());
+		TestEqual(TEXT("Self-removing handler should run once"), SelfRemovingCalls, 1);
+		TestEqual(TEXT("Observers removed during dispatch shouldn't receive the event"), RemovedCalls, 0);
+		TestEqual(TEXT("Remaining observer should receive both events"), LastCalls, 2);
+		TestEqual(TEXT("Should contain 1 observer record"), EventSystem->Num(), 1);
+	}
+
+	// Adding observers from inside a handler.
+	{
+		ULES_EventSystem* EventSystem = NewObject<ULES_EventSystem>();
+		int AddedCalls = 0;
+
+		EventSystem->AddObserver<ULES_TestEvent>(TestObserver, [&](const ULES_TestEvent*)
+		{
+			EventSystem->AddObserver<ULES_TestEvent>(TestObserver, [&](const ULES_TestEvent*)
+			{
+				AddedCalls++;
+			});
+			// Adding to another bucket may reallocate the buckets during the dispatch.
+			for (int i = 0; i < 16; i++)
+				EventSystem->ResolveSendToken(ULES_OtherTestEvent::StaticClass(), FName("Channel", i));
+		});
+
+		EventSystem->SendEvent(NewObject<ULES_TestEvent>());
+		TestEqual(TEXT("Observers added during dispatch shouldn't receive the event"), AddedCalls, 0);
+		EventSystem->SendEvent(NewObject<ULES_TestEvent>());
+		TestEqual(TEXT("Observers added during dispatch should receive later events"), AddedCalls, 1);
+		TestEqual(TEXT("Should contain 3 observer records"), EventSystem->Num(), 3);
+	}
+
+	// Sending events from inside a handler.
+	{
+		ULES_EventSystem* EventSystem = NewObject<ULES_EventSystem>();
+		int Depth = 0;
+		int MaxDepth = 0;
+		int OtherCalls = 0;
+
+		FLES_ObserverHandle OtherHandle;
+		EventSystem->AddObserver<ULES_TestEvent>(TestObserver, [&](const ULES_TestEvent*)
+		{
+			Depth++;
+			MaxDepth = FMath::Max(MaxDepth, Depth);
+			if (Depth < 3)
+				EventSystem->SendEvent(NewObject<ULES_TestEvent>());
+			if (Depth == 3)
+				EventSystem->RemoveByHandle(OtherHandle);
+			Depth--;
+		});
+		OtherHandle = EventSystem->AddObserver<ULES_TestEvent>(TestObserver, [&](const ULES_TestEvent*)
+		{
+			OtherCalls++;
+		});
+
+		EventSystem->SendEvent(NewObject<ULES_TestEvent>());
+		TestEqual(TEXT("Nested sends should reach depth 3"), MaxDepth, 3);
+		TestEqual(TEXT("Observer removed in the innermost send shouldn't receive any event"), OtherCalls, 0);
+		TestEqual(TEXT("Should contain 1 observer record"), EventSystem->Num(), 1);
+	}
+
+	// Removing all observers from inside a handler.
+	{
+		ULES_EventSystem* EventSystem = NewObject<ULES_EventSystem>();
+		int Calls = 0;
+		for (int i = 0; i < 3; i++)
+		{
+			EventSystem->AddObserver<ULES_TestEvent>(TestObserver, [&](const ULES_TestEvent*)
+			{
+				Calls++;
+				EventSystem->RemoveAll();
+			});
+		}
+
+		EventSystem->SendEvent(NewObject<ULES_TestEvent>());
+		TestEqual(TEXT("Only the first handler should run"), Calls, 1);
+		TestEqual(TEXT("Should be empty"), EventSystem->Num(), 0);
+		TestFalse(TEXT("Shouldn't contain the observer"), EventSystem->ContainsObserver(TestObserver));
+	}
+
+	return true;
+}
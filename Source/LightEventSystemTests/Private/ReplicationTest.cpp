@@ -0,0 +1,143 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#include "BasicEvents.h"
+#include "EventReplicator.h"
+#include "TestClasses.h"
+#include "Misc/AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLES_ReplicationTest, "Light Event System.Replication",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+bool FLES_ReplicationTest::RunTest(const FString& Parameters)
+{
+	ULES_EventSystem* ServerEventSystem = NewObject<ULES_EventSystem>();
+	ULES_EventSystem* ClientEventSystem = NewObject<ULES_EventSystem>();
+	ULES_TestObserver* TestObserver = NewObject<ULES_TestObserver>();
+
+	const TSharedRef<LES::FReplicationTable> Table = MakeShared<LES::FReplicationTable>();
+	Table->AddEventClass(ULES_IntegerEvent::StaticClass());
+	Table->AddEventClass(ULES_StringEvent::StaticClass());
+	Table->AddEventClass(ULES_VectorEvent::StaticClass());
+	Table->AddEventClass(ULES_RotatorEvent::StaticClass());
+	Table->AddEventClass(ULES_TransformEvent::StaticClass());
+	Table->AddChannel(NAME_None);
+	Table->AddChannel("Movement");
+
+	ULES_EventReplicator* Server = NewObject<ULES_EventReplicator>();
+	ULES_EventReplicator* Client = NewObject<ULES_EventReplicator>();
+	Server->Initialize(ServerEventSystem, Table);
+	Client->Initialize(ClientEventSystem, Table);
+	Server->ConnectLoopback(Client);
+	Server->bFlushAtEndOfFrame = false;
+
+	TestTrue(TEXT("Should replicate classes from the table"),
+	         Server->StartReplicating(ULES_IntegerEvent::StaticClass()));
+	TestTrue(TEXT("Should replicate classes from the table"),
+	         Server->StartReplicating(ULES_StringEvent::StaticClass()));
+	TestTrue(TEXT("Should replicate classes from the table"),
+	         Server->StartReplicating(ULES_VectorEvent::StaticClass(), "Movement"));
+	TestTrue(TEXT("Should replicate classes from the table"),
+	         Server->StartReplicating(ULES_RotatorEvent::StaticClass(), "Movement"));
+	TestTrue(TEXT("Should replicate classes from the table"),
+	         Server->StartReplicating(ULES_TransformEvent::StaticClass(), "Movement"));
+	TestFalse(TEXT("Shouldn't replicate classes missing from the table"),
+	          Server->StartReplicating(ULES_FloatEvent::StaticClass()));
+	TestFalse(TEXT("Shouldn't replicate channels missing from the table"),
+	          Server->StartReplicating(ULES_IntegerEvent::StaticClass(), "Unknown"));
+
+	TArray<int32> Integers;
+	TArray<FString> Strings;
+	TArray<FVector> Vectors;
+	TArray<FRotator> Rotators;
+	TArray<FTransform> Transforms;
+	ClientEventSystem->AddObserver<ULES_IntegerEvent>(TestObserver, [&](const ULES_IntegerEvent* Event)
+	{
+		Integers.Add(Event->Value);
+	});
+	ClientEventSystem->AddObserver<ULES_StringEvent>(TestObserver, [&](const ULES_StringEvent* Event)
+	{
+		Strings.Add(Event->Value);
+	});
+	ClientEventSystem->AddObserver<ULES_VectorEvent>(TestObserver, [&](const ULES_VectorEvent* Event)
+	{
+		TestEqual(TEXT("Channel should be replicated"), Event->Channel, FName("Movement"));
+		Vectors.Add(Event->Value);
+	}, "Movement");
+	ClientEventSystem->AddObserver<ULES_RotatorEvent>(TestObserver, [&](const ULES_RotatorEvent* Event)
+	{
+		Rotators.Add(Event->Value);
+	}, "Movement");
+	ClientEventSystem->AddObserver<ULES_TransformEvent>(TestObserver, [&](const ULES_TransformEvent* Event)
+	{
+		Transforms.Add(Event->Value);
+	}, "Movement");
+
+	// All events of one frame go into one packet.
+	const FTransform Transform(FRotator(10.0, 20.0, 30.0), FVector(100.0, -200.0, 300.0), FVector(1.0, 2.0, 1.0));
+	ServerEventSystem->SendEvent(LES::Create<ULES_IntegerEvent>(1000, nullptr, NAME_None));
+	ServerEventSystem->SendEvent(LES::Create<ULES_IntegerEvent>(999, nullptr, NAME_None));
+	ServerEventSystem->SendEvent(LES::Create<ULES_StringEvent>(FString("Hello"), nullptr, NAME_None));
+	ServerEventSystem->SendEvent(LES::Create<ULES_VectorEvent>(FVector(1.234, -5.678, 9000.0), nullptr, "Movement"));
+	ServerEventSystem->SendEvent(LES::Create<ULES_RotatorEvent>(FRotator(45.0, -90.0, 180.0), nullptr, "Movement"));
+	ServerEventSystem->SendEvent(LES::Create<ULES_TransformEvent>(Transform, nullptr, "Movement"));
+	ServerEventSystem->SendEvent(LES::Create<ULES_FloatEvent>(1.f, nullptr, NAME_None));
+	TestEqual(TEXT("Events shouldn't be received before flushing"), Integers.Num(), 0);
+
+	Server->Flush();
+	TestEqual(TEXT("Should send 1 packet"), Server->NumPacketsSent, static_cast<int64>(1));
+	TestEqual(TEXT("Should send 6 events"), Server->NumEventsSent, static_cast<int64>(6));
+	TestEqual(TEXT("Should receive 6 events"), Client->NumEventsReceived, static_cast<int64>(6));
+	TestEqual(TEXT("Integers should be received in order"), Integers, TArray<int32>{1000, 999});
+	TestEqual(TEXT("Strings should be received"), Strings, TArray<FString>{"Hello"});
+	if (TestEqual(TEXT("Should receive 1 vector"), Vectors.Num(), 1))
+	{
+		TestEqual(TEXT("Vectors should be quantized to 0.01"), Vectors[0], FVector(1.234, -5.678, 9000.0), 0.005);
+	}
+	if (TestEqual(TEXT("Should receive 1 rotator"), Rotators.Num(), 1))
+	{
+		TestTrue(TEXT("Rotators should be quantized to 16 bits per axis"),
+		         Rotators[0].Equals(FRotator(45.0, -90.0, 180.0), 0.01));
+	}
+	if (TestEqual(TEXT("Should receive 1 transform"), Transforms.Num(), 1))
+	{
+		TestTrue(TEXT("Transforms should be quantized"), Transforms[0].Equals(Transform, 0.01));
+	}
+
+	// Values that barely change are delta-compressed to a few bits.
+	const int64 BitsBefore = Server->NumBitsSent;
+	ServerEventSystem->SendEvent(LES::Create<ULES_VectorEvent>(FVector(1.244, -5.678, 9000.0), nullptr, "Movement"));
+	ServerEventSystem->SendEvent(LES::Create<ULES_StringEvent>(FString("Hello"), nullptr, NAME_None));
+	Server->Flush();
+	TestTrue(TEXT("Small changes should take less than 64 bits"), Server->NumBitsSent - BitsBefore < 64);
+	if (TestEqual(TEXT("Should receive 2 vectors"), Vectors.Num(), 2))
+	{
+		TestEqual(TEXT("Deltas should be applied"), Vectors[1], FVector(1.24, -5.68, 9000.0), 0.005);
+	}
+	TestEqual(TEXT("Unchanged strings should be received"), Strings, TArray<FString>{"Hello", "Hello"});
+
+	// Flushing without events doesn't send empty packets, and corrupted packets are rejected.
+	Server->Flush();
+	TestEqual(TEXT("Should send 2 packets"), Server->NumPacketsSent, static_cast<int64>(2));
+	AddExpectedError(TEXT("corrupted event packet"), EAutomationExpectedErrorFlags::Contains, 3);
+	TestFalse(TEXT("Corrupted packets should be rejected"), Client->ReceivePacket(TArray<uint8>{0xFF, 0xFF}, 16));
+	TestFalse(TEXT("Packets with more bits than bytes should be rejected"),
+	          Client->ReceivePacket(TArray<uint8>{0xFF, 0xFF}, 1 << 20));
+	TestFalse(TEXT("Packets with a negative size should be rejected"), Client->ReceivePacket(TArray<uint8>{0xFF}, -1));
+
+	// Received events aren't sent back, but the events sent by their handlers are.
+	Client->bFlushAtEndOfFrame = false;
+	TestTrue(TEXT("Should replicate classes from the table"),
+	         Client->StartReplicating(ULES_IntegerEvent::StaticClass()));
+	ClientEventSystem->AddObserver<ULES_StringEvent>(TestObserver, [ClientEventSystem](const ULES_StringEvent*)
+	{
+		ClientEventSystem->SendEvent(LES::Create<ULES_IntegerEvent>(7, nullptr, NAME_None));
+	});
+	ServerEventSystem->SendEvent(LES::Create<ULES_IntegerEvent>(1, nullptr, NAME_None));
+	ServerEventSystem->SendEvent(LES::Create<ULES_StringEvent>(FString("Reply"), nullptr, NAME_None));
+	Server->Flush();
+	TestEqual(TEXT("Only the handler's event should be sent back"), Client->NumEventsSent, static_cast<int64>(1));
+
+	return true;
+}
@@ -0,0 +1,98 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#include "TestClasses.h"
+#include "Misc/AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLES_ScheduledEventsTest, "Light Event System.Scheduled events",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+bool FLES_ScheduledEventsTest::RunTest(const FString& Parameters)
+{
+	auto EventSystem = TStrongObjectPtr(NewObject<ULES_EventSystem>());
+	auto TestObserver = TStrongObjectPtr(NewObject<ULES_TestObserver>());
+
+	EventSystem->AddObserver<ULES_TestEvent>(TestObserver.Get(), &ULES_TestObserver::OnTestEvent);
+	EventSystem->AddObserver<ULES_OtherTestEvent>(TestObserver.Get(), &ULES_TestObserver::OnOtherTestEvent);
+
+	const auto Handle1 = EventSystem->SendEventDelayed(NewObject<ULES_TestEvent>(), 1.0);
+	const auto Handle2 = EventSystem->SendEventAt(NewObject<ULES_OtherTestEvent>(), 2.0);
+	const auto Handle3 = EventSystem->SendEventDelayed(NewObject<ULES_TestEvent>(), 100.0);
+	const auto InvalidHandle = EventSystem->SendEventDelayed(nullptr, 1.0);
+	TestTrue(TEXT("Handle1 should be scheduled"), EventSystem->IsEventScheduled(Handle1));
+	TestTrue(TEXT("Handle2 should be scheduled"), EventSystem->IsEventScheduled(Handle2));
+	TestFalse(TEXT("Scheduling nullptr events should return invalid handles"),
+	          EventSystem->IsEventScheduled(InvalidHandle));
+	TestEqual(TEXT("Should contain 3 scheduled events"), EventSystem->GetNumScheduledEvents(), 3);
+
+	// Another Event System hands out the same indices and serials, but doesn't accept the handles of this one.
+	auto OtherEventSystem = TStrongObjectPtr(NewObject<ULES_EventSystem>());
+	OtherEventSystem->SendEventDelayed(NewObject<ULES_TestEvent>(), 1.0);
+	TestFalse(TEXT("Other Event System shouldn't report the event as scheduled"),
+	          OtherEventSystem->IsEventScheduled(Handle1));
+	TestFalse(TEXT("Other Event System shouldn't cancel the event"), OtherEventSystem->CancelScheduledEvent(Handle1));
+	TestEqual(TEXT("Other Event System should keep its event"), OtherEventSystem->GetNumScheduledEvents(), 1);
+
+	// Scheduled events should be kept alive until they are sent.
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+
+	EventSystem->Tick(0.5f);
+	TestEqual(TEXT("No events should be sent before they are due"), TestObserver->Counter, FIntVector3::ZeroValue);
+
+	EventSystem->Tick(0.5f);
+	TestEqual(TEXT("The first event should be sent"), TestObserver->Counter, FIntVector3(1, 0, 0));
+	TestFalse(TEXT("Handle1 should be invalid after sending"), EventSystem->IsEventScheduled(Handle1));
+
+	TestTrue(TEXT("Cancelling a scheduled event should succeed"), EventSystem->CancelScheduledEvent(Handle3));
+	TestFalse(TEXT("Cancelling the same event twice should fail"), EventSystem->CancelScheduledEvent(Handle3));
+
+	// Advancing by more than one revolution of the wheel should still send the remaining event exactly once.
+	EventSystem->Tick(1000.0f);
+	TestEqual(TEXT("The second event should be sent"), TestObserver->Counter, FIntVector3(1, 0, 1));
+	TestEqual(TEXT("Should contain no scheduled events"), EventSystem->GetNumScheduledEvents(), 0);
+
+	// Events scheduled in the past are sent on the next tick.
+	EventSystem->SendEventAt(NewObject<ULES_TestEvent>(), 0.0);
+	EventSystem->Tick(0.0f);
+	TestEqual(TEXT("Overdue events should be sent on the next tick"), TestObserver->Counter, FIntVector3(2, 0, 1));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLES_TimingWheelOrderTest, "Light Event System.Timing wheel order",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+bool FLES_TimingWheelOrderTest::RunTest(const FString& Parameters)
+{
+	LES::FTimingWheel TimingWheel(0.1, 8);
+
+	TArray<ULES_Event*> Events;
+	for (int i = 0; i < 4; i++)
+		Events.Add(NewObject<ULES_TestEvent>());
+
+	// The first and the last event land in the same slot, but one revolution apart.
+	TimingWheel.Schedule(Events[0], 0.9);
+	TimingWheel.Schedule(Events[1], 0.3);
+	TimingWheel.Schedule(Events[2], 0.3);
+	TimingWheel.Schedule(Events[3], 0.1);
+
+	TArray<ULES_Event*> DueEvents;
+	TimingWheel.Advance(0.5, DueEvents);
+	TestEqual(TEXT("Should return 3 due events"), DueEvents.Num(), 3);
+	if (DueEvents.Num() == 3)
+	{
+		TestEqual(TEXT("Earliest event should be first"), DueEvents[0], Events[3]);
+		TestEqual(TEXT("Events due at the same time should keep their order"), DueEvents[1], Events[1]);
+		TestEqual(TEXT("Events due at the same time should keep their order"), DueEvents[2], Events[2]);
+	}
+
+	DueEvents.Reset();
+	TimingWheel.Advance(0.9, DueEvents);
+	TestEqual(TEXT("Should return the last event"), DueEvents.Num(), 1);
+	TestEqual(TEXT("Should be empty"), TimingWheel.Num(), 0);
+
+	return true;
+}
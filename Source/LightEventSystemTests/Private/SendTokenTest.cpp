@@ -0,0 +1,49 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#include "TestClasses.h"
+#include "Misc/AutomationTest.h"
+
+LES_DEFINE_CHANNEL_STATIC(Channel_NativeTest, "Native test channel");
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLES_SendTokenTest, "Light Event System.Send tokens",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+bool FLES_SendTokenTest::RunTest(const FString& Parameters)
+{
+	ULES_EventSystem* EventSystem = NewObject<ULES_EventSystem>();
+	ULES_EventSystem* OtherEventSystem = NewObject<ULES_EventSystem>();
+	ULES_TestObserver* TestObserver = NewObject<ULES_TestObserver>();
+
+	TestEqual(TEXT("Native channels should be resolved"), Channel_NativeTest.GetName(), FName("Native test channel"));
+
+	// Tokens may be resolved before anyone listens, and stay valid when observers are added.
+	const FLES_SendToken Token = EventSystem->ResolveSendToken(ULES_TestEvent::StaticClass(), Channel_NativeTest);
+	TestTrue(TEXT("Resolved token should be valid"), EventSystem->IsSendTokenValid(Token));
+	TestFalse(TEXT("Token shouldn't be valid for other Event Systems"), OtherEventSystem->IsSendTokenValid(Token));
+	TestFalse(TEXT("Resolving a token for nullptr class should fail"),
+	          EventSystem->IsSendTokenValid(EventSystem->ResolveSendToken(nullptr)));
+
+	const auto Handle = EventSystem->AddObserver<ULES_TestEvent>(TestObserver, &ULES_TestObserver::OnTestEvent,
+	                                                             Channel_NativeTest);
+	EventSystem->AddObserver<ULES_OtherTestEvent>(TestObserver, &ULES_TestObserver::OnOtherTestEvent);
+	TestTrue(TEXT("Token should stay valid after adding observers"), EventSystem->IsSendTokenValid(Token));
+	TestEqual(TEXT("Resolving a token shouldn't add observer records"), EventSystem->Num(), 2);
+
+	ULES_TestEvent* Event = NewObject<ULES_TestEvent>();
+	Event->Channel = Channel_NativeTest;
+	EventSystem->SendEvent(Token, Event);
+	TestEqual(TEXT("Event sent with a token should be received"), TestObserver->Counter, FIntVector3(1, 0, 0));
+
+	// Events that don't match the token are sent the regular way.
+	EventSystem->SendEvent(Token, NewObject<ULES_OtherTestEvent>());
+	TestEqual(TEXT("Mismatched events should still be received"), TestObserver->Counter, FIntVector3(1, 0, 1));
+
+	EventSystem->RemoveByHandle(Handle);
+	TestTrue(TEXT("Token should stay valid after removing observers"), EventSystem->IsSendTokenValid(Token));
+	EventSystem->SendEvent(Token, Event);
+	TestEqual(TEXT("Removed observers shouldn't receive events"), TestObserver->Counter, FIntVector3(1, 0, 1));
+
+	return true;
+}
@@ -0,0 +1,90 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#include "ShardedEventBus.h"
+#include "TestClasses.h"
+#include "Misc/AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLES_ShardedEventBusTest, "Light Event System.Sharded event bus",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+bool FLES_ShardedEventBusTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 NumShards = 4;
+	constexpr int32 NumSends = 1000;
+
+	auto Bus = TStrongObjectPtr(NewObject<ULES_ShardedEventBus>());
+	Bus->Start(NumShards);
+	TestEqual(TEXT("Shards should be created"), Bus->GetNumShards(), NumShards);
+	TestTrue(TEXT("Console commands should skip the shard's Event System"),
+	         Bus->GetShardEventSystem(0)->IsOwnedByShard());
+
+	// Two channels handled by different shards.
+	const FName First = "Shard_0";
+	FName Second = NAME_None;
+	for (int32 Index = 1; Second.IsNone(); Index++)
+	{
+		const FName Channel = *FString::Printf(TEXT("Shard_%d"), Index);
+		if (Bus->GetShard(Channel) != Bus->GetShard(First))
+			Second = Channel;
+	}
+
+	// Events of a shard are handled in order, on the shard's thread.
+	auto Observer = TStrongObjectPtr(NewObject<ULES_TestObserver>());
+	TArray<float> Received;
+	bool bOnShardThread = true;
+	const int32 FirstShard = Bus->GetShard(First);
+	const auto Handle = Bus->AddObserver<ULES_FloatEvent>(Observer.Get(), [&](const ULES_FloatEvent* Event)
+	{
+		bOnShardThread = bOnShardThread && Bus->IsInShardThread(FirstShard) && !IsInGameThread();
+		Received.Add(Event->Value);
+	}, First);
+	TestEqual(TEXT("Observer should be added"), Bus->Num(), 1);
+
+	for (int32 Index = 0; Index < NumSends; Index++)
+		Bus->SendEvent(LES::Create<ULES_FloatEvent>(static_cast<float>(Index), nullptr, First));
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	TestTrue(TEXT("Events should be handled"), Bus->Flush());
+	TestEqual(TEXT("Every event should be received"), Received.Num(), NumSends);
+	bool bInOrder = true;
+	for (int32 Index = 0; Index < Received.Num(); Index++)
+		bInOrder = bInOrder && Received[Index] == static_cast<float>(Index);
+	TestTrue(TEXT("Events should be received in the order they were sent"), bInOrder);
+	TestTrue(TEXT("Handlers should run on the shard's thread"), bOnShardThread);
+
+	// A pinned observer listening on both shards is never called concurrently.
+	auto PinnedObserver = TStrongObjectPtr(NewObject<ULES_TestObserver>());
+	Bus->PinObserver(PinnedObserver.Get(), FirstShard);
+	std::atomic<int32> NumRunning = 0;
+	bool bConcurrent = false;
+	bool bOnPinnedShard = true;
+	int32 NumPinnedCalls = 0;
+	auto PinnedHandler = [&](const ULES_FloatEvent*)
+	{
+		bConcurrent = bConcurrent || ++NumRunning > 1;
+		bOnPinnedShard = bOnPinnedShard && Bus->IsInShardThread(FirstShard);
+		NumPinnedCalls++;
+		FPlatformProcess::Sleep(0.0f);
+		NumRunning--;
+	};
+	Bus->AddObserver<ULES_FloatEvent>(PinnedObserver.Get(), PinnedHandler, First);
+	Bus->AddObserver<ULES_FloatEvent>(PinnedObserver.Get(), PinnedHandler, Second);
+	Bus->RemoveByHandle(Handle);
+	TestEqual(TEXT("Observer should be removed"), Bus->Num(), 2);
+
+	for (int32 Index = 0; Index < NumSends; Index++)
+	{
+		Bus->SendEvent(LES::Create<ULES_FloatEvent>(0.0f, nullptr, First));
+		Bus->SendEvent(LES::Create<ULES_FloatEvent>(0.0f, nullptr, Second));
+	}
+	TestTrue(TEXT("Events should be handled"), Bus->Flush());
+	TestEqual(TEXT("Pinned observer should receive events on both channels"), NumPinnedCalls, 2 * NumSends);
+	TestFalse(TEXT("Pinned observer shouldn't be called concurrently"), bConcurrent);
+	TestTrue(TEXT("Pinned observer should be called on its shard"), bOnPinnedShard);
+	TestEqual(TEXT("Removed observer shouldn't receive events"), Received.Num(), NumSends);
+
+	Bus->Stop();
+	TestFalse(TEXT("Bus should be stopped"), Bus->IsRunning());
+	return true;
+}
@@ -0,0 +1,141 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#include "BasicEvents.h"
+#include "SharedMemoryBridge.h"
+#include "TestClasses.h"
+#include "Misc/AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLES_SharedMemoryBridgeTest, "Light Event System.Shared memory bridge",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+bool FLES_SharedMemoryBridgeTest::RunTest(const FString& Parameters)
+{
+	ULES_EventSystem* EventSystem = NewObject<ULES_EventSystem>();
+	ULES_TestObserver* TestObserver = NewObject<ULES_TestObserver>();
+	ULES_SharedMemoryBridge* Bridge = NewObject<ULES_SharedMemoryBridge>();
+	Bridge->bReceiveAtBeginningOfFrame = false;
+
+	constexpr int32 Capacity = 4096;
+	constexpr int32 SchemaCapacity = 4096;
+	const FString Name = FString::Printf(TEXT("LESBridgeTest_%u"), FPlatformProcess::GetCurrentProcessId());
+	if (!TestTrue(TEXT("Bridge should open"), Bridge->Open(EventSystem, Name, Capacity, SchemaCapacity)))
+		return false;
+	TestTrue(TEXT("Should mirror vector events"), Bridge->Mirror(ULES_VectorEvent::StaticClass(), "Movement"));
+	TestTrue(TEXT("Should mirror string events"), Bridge->Mirror(ULES_StringEvent::StaticClass()));
+	TestTrue(TEXT("Should mirror name events"), Bridge->Mirror(ULES_NameEvent::StaticClass()));
+	TestTrue(TEXT("Should mirror object events"), Bridge->Mirror(ULES_ObjectEvent::StaticClass()));
+	TestTrue(TEXT("Should allow injecting vector events"), Bridge->AllowInjection(ULES_VectorEvent::StaticClass()));
+
+	// Acts as the tools, through a second mapping of the same region.
+	FPlatformMemory::FSharedMemoryRegion* ToolRegion = FPlatformMemory::MapNamedSharedMemoryRegion(
+		Name, false, FPlatformMemory::ESharedMemoryAccess::Read | FPlatformMemory::ESharedMemoryAccess::Write,
+		LES::Bridge::GetRegionSize(Capacity, SchemaCapacity));
+	LES::Bridge::FRegionHeader* ToolHeader =
+		ToolRegion ? LES::Bridge::GetRegionHeader(ToolRegion->GetAddress(), ToolRegion->GetSize()) : nullptr;
+	if (!TestNotNull(TEXT("Region should be readable by the tools"), ToolHeader))
+		return false;
+
+	int32 NumSchemas = 0;
+	LES::Bridge::ForEachSchema(ToolHeader, [&NumSchemas](const uint8*, const uint32) { NumSchemas++; });
+	TestEqual(TEXT("Should publish 4 schemas"), NumSchemas, 4);
+
+	EventSystem->SendEvent(LES::Create<ULES_VectorEvent>(FVector(1.0, 2.0, 3.0), nullptr, "Movement"));
+	EventSystem->SendEvent(LES::Create<ULES_StringEvent>(FString("Hello"), nullptr, NAME_None));
+	EventSystem->SendEvent(LES::Create<ULES_NameEvent>(FName("Hello"), nullptr, NAME_None));
+	EventSystem->SendEvent(LES::Create<ULES_ObjectEvent>(static_cast<UObject*>(TestObserver), nullptr, NAME_None));
+	EventSystem->SendEvent(LES::Create<ULES_VectorEvent>(FVector(1.0, 2.0, 3.0), nullptr, "Not mirrored"));
+	TestEqual(TEXT("Should mirror 4 events"), Bridge->NumMirrored, static_cast<int64>(4));
+
+	LES::Bridge::FRingReader ToolReader(ToolHeader, LES::Bridge::GameToTools);
+	LES::Bridge::FRecordHeader RecordHeader;
+	const uint8* Body = nullptr;
+	uint32 BodySize = 0;
+
+	// Vector event: class id, channel length, reserved, "Movement", then the raw vector.
+	TArray<uint8> VectorBody;
+	if (TestTrue(TEXT("Vector event should be mirrored"), ToolReader.Peek(RecordHeader, Body, BodySize)))
+	{
+		FVector Value;
+		FMemory::Memcpy(&Value, Body + 16, sizeof(Value));
+		TestEqual(TEXT("Channel should be mirrored"), FString(8, reinterpret_cast<const ANSICHAR*>(Body + 8)),
+		          FString("Movement"));
+		TestEqual(TEXT("Vector should be copied"), Value, FVector(1.0, 2.0, 3.0));
+		VectorBody.Append(Body, BodySize);
+		ToolReader.Pop();
+	}
+
+	// String event: class id, channel length, reserved, "None", then the length and the text.
+	if (TestTrue(TEXT("String event should be mirrored"), ToolReader.Peek(RecordHeader, Body, BodySize)))
+	{
+		uint32 Length = 0;
+		FMemory::Memcpy(&Length, Body + 12, sizeof(Length));
+		TestEqual(TEXT("String should be written as text"), Length, 5u);
+		TestEqual(TEXT("String should be written as text"), FString(5, reinterpret_cast<const ANSICHAR*>(Body + 16)),
+		          FString("Hello"));
+		ToolReader.Pop();
+	}
+
+	// Names and object references are plain old data to the engine, but mean nothing outside the game, so they're
+	// written as text too.
+	TArray<uint8> NameBody;
+	if (TestTrue(TEXT("Name event should be mirrored"), ToolReader.Peek(RecordHeader, Body, BodySize)))
+	{
+		uint32 Length = 0;
+		FMemory::Memcpy(&Length, Body + 12, sizeof(Length));
+		TestEqual(TEXT("Name should be written as text"), Length, 5u);
+		TestEqual(TEXT("Name should be written as text"), FString(5, reinterpret_cast<const ANSICHAR*>(Body + 16)),
+		          FString("Hello"));
+		NameBody.Append(Body, BodySize);
+		ToolReader.Pop();
+	}
+	if (TestTrue(TEXT("Object event should be mirrored"), ToolReader.Peek(RecordHeader, Body, BodySize)))
+	{
+		uint32 Length = 0;
+		FMemory::Memcpy(&Length, Body + 12, sizeof(Length));
+		TestEqual(TEXT("Object reference should be written as text"), BodySize, 16 + Length);
+		const FString Text = FString(Length, reinterpret_cast<const ANSICHAR*>(Body + 16));
+		TestTrue(TEXT("Object reference should be written as its path"), Text.Contains(TestObserver->GetName()));
+		ToolReader.Pop();
+	}
+	TestFalse(TEXT("Events on other channels shouldn't be mirrored"), ToolReader.Peek(RecordHeader, Body, BodySize));
+
+	// Injecting the mirrored vector event back into the game.
+	TArray<FVector> Values;
+	EventSystem->AddObserver<ULES_VectorEvent>(TestObserver, [&Values](const ULES_VectorEvent* Event)
+	{
+		Values.Add(Event->Value);
+	}, "Movement");
+
+	LES::Bridge::FRingWriter ToolWriter(ToolHeader, LES::Bridge::ToolsToGame);
+	if (uint8* InjectedBody = ToolWriter.BeginWrite(LES::Bridge::ERecordType::Event, VectorBody.Num()))
+	{
+		FMemory::Memcpy(InjectedBody, VectorBody.GetData(), VectorBody.Num());
+		ToolWriter.EndWrite();
+	}
+	TestEqual(TEXT("Should receive 1 injected event"), Bridge->ReceiveInjectedEvents(), 1);
+	TestEqual(TEXT("Injected event should be sent"), Values, TArray<FVector>{FVector(1.0, 2.0, 3.0)});
+
+	// Injected names are imported from their text.
+	TArray<FName> Names;
+	EventSystem->AddObserver<ULES_NameEvent>(TestObserver, [&Names](const ULES_NameEvent* Event)
+	{
+		Names.Add(Event->Value);
+	});
+	Bridge->AllowInjection(ULES_NameEvent::StaticClass());
+	if (uint8* InjectedBody = ToolWriter.BeginWrite(LES::Bridge::ERecordType::Event, NameBody.Num()))
+	{
+		FMemory::Memcpy(InjectedBody, NameBody.GetData(), NameBody.Num());
+		ToolWriter.EndWrite();
+	}
+	TestEqual(TEXT("Should receive the injected name event"), Bridge->ReceiveInjectedEvents(), 1);
+	TestTrue(TEXT("Injected name should be imported"), Names.Num() == 1 && Names[0] == FName("Hello"));
+	TestEqual(TEXT("Nothing should be dropped"), Bridge->GetNumDropped(), static_cast<int64>(0));
+
+	FPlatformMemory::UnmapNamedSharedMemoryRegion(ToolRegion);
+	Bridge->Close();
+	TestFalse(TEXT("Bridge should be closed"), Bridge->IsOpen());
+
+	return true;
+}
@@ -0,0 +1,161 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#include "TestClasses.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+
+namespace
+{
+	/** State of the Event System and the timings measured at the end of one soak epoch. */
+	struct FSoakSample
+	{
+		int32 NumRecords = 0;
+		int64 AllocatedBytes = 0;
+		double GarbageCollectionTime = 0.0;
+		double MedianSendTime = 0.0;
+		double SlowSendTime = 0.0;
+	};
+
+	/** Returns the \a Percentile of the sorted \a Times. */
+	double GetPercentile(const TArray<double>& Times, const double Percentile)
+	{
+		if (Times.IsEmpty()) return 0.0;
+		return Times[FMath::Min(FMath::FloorToInt32(Times.Num() * Percentile), Times.Num() - 1)];
+	}
+
+	/** Stands in for a blueprint event class of a streamed level. */
+	UClass* LoadStreamedEventClass(const int32 Epoch)
+	{
+		const FName ClassName = MakeUniqueObjectName(GetTransientPackage(), UClass::StaticClass(),
+		                                             *FString::Printf(TEXT("LES_StreamedEvent_%d"), Epoch));
+		UClass* StreamedClass = NewObject<UClass>(GetTransientPackage(), ClassName, RF_Transient);
+		StreamedClass->SetSuperStruct(ULES_TestEvent::StaticClass());
+		StreamedClass->Bind();
+		StreamedClass->StaticLink(true);
+		return StreamedClass;
+	}
+}
+
+/**
+ * Simulates a long session: every epoch stands in for ten seconds of the game at 60 frames per second, with observers
+ * coming and going, a level's event class streamed in and out, scheduled and immediate event traffic, and a garbage
+ * collection. The Event System keeps its default settings and nothing calls \a Clean, like in a game that never
+ * removes the destroyed observers itself. The test fails if the records, the memory, the garbage collection time or
+ * the send latency grow past the warm-up epochs. Pass -LESSoakEpochs=N for longer runs.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLES_SoakTest, "Light Event System.Soak.Observer churn",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::StressFilter)
+
+bool FLES_SoakTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 NumWarmUpEpochs = 2;
+	constexpr int32 FramesPerEpoch = 600;
+	constexpr int32 NumLiveObservers = 256;
+	constexpr int32 NumReplacedObserversPerFrame = 4;
+	constexpr int32 NumSendsPerFrame = 16;
+	const FName Channels[] = {NAME_None, "Combat", "UI", "Audio"};
+
+	int32 NumEpochs = 20;
+	FParse::Value(FCommandLine::Get(), TEXT("LESSoakEpochs="), NumEpochs);
+	NumEpochs = FMath::Max(NumEpochs, NumWarmUpEpochs + 1);
+
+	auto EventSystem = TStrongObjectPtr(NewObject<ULES_EventSystem>());
+
+	FRandomStream Random(1234);
+	TArray<TStrongObjectPtr<ULES_TestObserver>> Observers;
+	auto AddObserver = [&EventSystem, &Observers, &Random, &Channels]
+	{
+		ULES_TestObserver* Observer = NewObject<ULES_TestObserver>();
+		const FName Channel = Channels[Random.RandRange(0, UE_ARRAY_COUNT(Channels) - 1)];
+		EventSystem->AddObserver<ULES_TestEvent>(Observer, &ULES_TestObserver::OnTestEvent, Channel);
+		if (Random.FRand() < 0.25f)
+			EventSystem->AddObserver<ULES_OtherTestEvent>(Observer, &ULES_TestObserver::OnOtherTestEvent, Channel);
+		Observers.Emplace(Observer);
+	};
+	for (int32 Index = 0; Index < NumLiveObservers; Index++)
+		AddObserver();
+
+	TStrongObjectPtr<UClass> StreamedClass;
+	TStrongObjectPtr<ULES_TestObserver> StreamedObserver;
+	TArray<double> SendTimes;
+	SendTimes.Reserve(FramesPerEpoch * NumSendsPerFrame);
+	TArray<FSoakSample> Samples;
+
+	for (int32 Epoch = 0; Epoch < NumEpochs; Epoch++)
+	{
+		// The previous level's class is unloaded by the garbage collection at the end of this epoch.
+		StreamedClass.Reset(LoadStreamedEventClass(Epoch));
+		StreamedObserver.Reset(NewObject<ULES_TestObserver>());
+		EventSystem->BP_AddObserver_Function(StreamedClass.Get(), StreamedObserver.Get(), "OnEvent");
+		EventSystem->ResolveSendToken(StreamedClass.Get());
+
+		SendTimes.Reset();
+		for (int32 Frame = 0; Frame < FramesPerEpoch; Frame++)
+		{
+			// Dropped observers are destroyed by the next garbage collection, without being removed from the system.
+			for (int32 Index = 0; Index < NumReplacedObserversPerFrame; Index++)
+			{
+				Observers.RemoveAtSwap(Random.RandRange(0, Observers.Num() - 1));
+				AddObserver();
+			}
+
+			for (int32 Index = 0; Index < NumSendsPerFrame; Index++)
+			{
+				ULES_Event* Event = Index % 4 == 0
+					                    ? NewObject<ULES_Event>(GetTransientPackage(), StreamedClass.Get())
+					                    : NewObject<ULES_TestEvent>();
+				Event->Channel = Channels[Random.RandRange(0, UE_ARRAY_COUNT(Channels) - 1)];
+
+				const uint64 StartCycles = FPlatformTime::Cycles64();
+				EventSystem->SendEvent(Event);
+				SendTimes.Add(FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles));
+			}
+			EventSystem->SendEventDelayed(NewObject<ULES_OtherTestEvent>(), Random.FRandRange(0.0f, 2.0f));
+			EventSystem->Tick(1.0f / 60.0f);
+		}
+
+		const double GarbageCollectionStartTime = FPlatformTime::Seconds();
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+		const double GarbageCollectionTime = (FPlatformTime::Seconds() - GarbageCollectionStartTime) * 1000.0;
+
+		SendTimes.Sort();
+		const FLES_MemoryReport Report = EventSystem->GetMemoryReport();
+		const FSoakSample& Sample = Samples.Add_GetRef({
+			.NumRecords = EventSystem->Num(),
+			.AllocatedBytes = Report.AllocatedBytes,
+			.GarbageCollectionTime = GarbageCollectionTime,
+			.MedianSendTime = GetPercentile(SendTimes, 0.5),
+			.SlowSendTime = GetPercentile(SendTimes, 0.99),
+		});
+		AddInfo(FString::Printf(
+			TEXT("Epoch %d: %d records, %lld bytes, %d purged buckets, GC %.3f ms, send p50 %.4f ms, p99 %.4f ms"),
+			Epoch, Sample.NumRecords, Sample.AllocatedBytes, Report.NumPurgedBuckets, Sample.GarbageCollectionTime,
+			Sample.MedianSendTime, Sample.SlowSendTime));
+	}
+
+	// The live observers and their handlers are constant, so after the warm-up nothing should grow. Timings get
+	// generous margins, since they're noisy on shared build machines.
+	const FSoakSample& Baseline = Samples[NumWarmUpEpochs - 1];
+	const FLES_MemoryReport Report = EventSystem->GetMemoryReport();
+	TestEqual(TEXT("Unloaded event classes should be purged"), Report.NumPurgedBuckets, NumEpochs - 1);
+	for (int32 Epoch = NumWarmUpEpochs; Epoch < Samples.Num(); Epoch++)
+	{
+		const FSoakSample& Sample = Samples[Epoch];
+		if (Sample.NumRecords > Baseline.NumRecords * 11 / 10 + 16)
+			AddError(FString::Printf(TEXT("Records grew from %d to %d by epoch %d"), Baseline.NumRecords,
+			                         Sample.NumRecords, Epoch));
+		if (Sample.AllocatedBytes > Baseline.AllocatedBytes * 3 / 2 + 4096)
+			AddError(FString::Printf(TEXT("Allocated bytes grew from %lld to %lld by epoch %d"),
+			                         Baseline.AllocatedBytes, Sample.AllocatedBytes, Epoch));
+		if (Sample.GarbageCollectionTime > Baseline.GarbageCollectionTime * 3.0 + 10.0)
+			AddError(FString::Printf(TEXT("Garbage collection time grew from %.3f ms to %.3f ms by epoch %d"),
+			                         Baseline.GarbageCollectionTime, Sample.GarbageCollectionTime, Epoch));
+		if (Sample.SlowSendTime > Baseline.SlowSendTime * 4.0 + 0.05)
+			AddError(FString::Printf(TEXT("99th percentile send time grew from %.4f ms to %.4f ms by epoch %d"),
+			                         Baseline.SlowSendTime, Sample.SlowSendTime, Epoch));
+	}
+
+	return true;
+}
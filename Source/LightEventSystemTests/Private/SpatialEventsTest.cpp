@@ -0,0 +1,103 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#include "TestClasses.h"
+#include "Components/SceneComponent.h"
+#include "Misc/AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLES_SpatialEventsTest, "Light Event System.Spatial events",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+bool FLES_SpatialEventsTest::RunTest(const FString& Parameters)
+{
+	auto EventSystem = TStrongObjectPtr(NewObject<ULES_EventSystem>());
+	auto TestObserver = TStrongObjectPtr(NewObject<ULES_TestObserver>());
+	auto SendAt = [&EventSystem](const FVector& Location, const float Radius)
+	{
+		ULES_TestSpatialEvent* Event = NewObject<ULES_TestSpatialEvent>();
+		Event->Location = Location;
+		Event->Radius = Radius;
+		EventSystem->SendEvent(Event);
+	};
+
+	// Observers in a line, 100 units apart, filling the SIMD lanes of a single cell and a few more.
+	constexpr int32 NumObservers = 10;
+	TArray<int32> Received;
+	Received.Init(0, NumObservers);
+	TArray<FLES_ObserverHandle> Handles;
+	for (int32 Index = 0; Index < NumObservers; Index++)
+	{
+		Handles.Add(EventSystem->AddObserver<ULES_TestSpatialEvent>(
+			TestObserver.Get(), [&Received, Index](const ULES_TestSpatialEvent*) { Received[Index]++; }));
+		TestTrue(TEXT("Spatial filter should be set"), EventSystem->SetSpatialFilter(Handles[Index], nullptr, 0.0f));
+		EventSystem->SetSpatialObserverLocation(Handles[Index], FVector(Index * 100.0, 0.0, 0.0));
+	}
+
+	int32 ReceivedUnfiltered = 0;
+	EventSystem->AddObserver<ULES_TestSpatialEvent>(TestObserver.Get(), [&ReceivedUnfiltered](const ULES_SpatialEvent*)
+	{
+		ReceivedUnfiltered++;
+	});
+	TestEqual(TEXT("Should contain all observer records"), EventSystem->Num(), NumObservers + 1);
+
+	SendAt(FVector::ZeroVector, 450.0f);
+	TestEqual(TEXT("Only the observers within reach should receive the event"), Received,
+	          TArray<int32>{1, 1, 1, 1, 1, 0, 0, 0, 0, 0});
+	TestEqual(TEXT("Observers without a filter should receive the event"), ReceivedUnfiltered, 1);
+
+	// The observer's radius adds to the event's.
+	EventSystem->SetSpatialFilter(Handles[9], nullptr, 500.0f);
+	SendAt(FVector(400.0, 0.0, 0.0), 0.0f);
+	TestEqual(TEXT("Observer's radius should extend its reach"), Received,
+	          TArray<int32>{1, 1, 1, 1, 2, 0, 0, 0, 0, 1});
+
+	// Far away events don't reach anyone, but are still sent to the observers without a filter.
+	SendAt(FVector(100000.0, 0.0, 0.0), 100.0f);
+	TestEqual(TEXT("Far events shouldn't reach spatial observers"), Received,
+	          TArray<int32>{1, 1, 1, 1, 2, 0, 0, 0, 0, 1});
+	TestEqual(TEXT("Observers without a filter should receive far events"), ReceivedUnfiltered, 3);
+
+	// Positions of observers with a source are read when the Event System is ticked.
+	USceneComponent* PositionSource = NewObject<USceneComponent>();
+	PositionSource->SetWorldLocation(FVector(5000.0, 0.0, 0.0));
+	EventSystem->SetSpatialFilter(Handles[0], PositionSource, 0.0f);
+	SendAt(FVector::ZeroVector, 50.0f);
+	TestEqual(TEXT("Observer should follow its source"), Received[0], 1);
+
+	PositionSource->SetWorldLocation(FVector(0.0, 0.0, 10.0));
+	SendAt(FVector::ZeroVector, 50.0f);
+	TestEqual(TEXT("Positions should be updated in a batch on tick"), Received[0], 1);
+	EventSystem->Tick(0.0f);
+	SendAt(FVector::ZeroVector, 50.0f);
+	TestEqual(TEXT("Observer should receive the event after the update"), Received[0], 2);
+
+	// Removed spatial observers stop receiving events.
+	TestEqual(TEXT("Spatial observer should be removed"), EventSystem->RemoveByHandle(Handles[0]), 1);
+	SendAt(FVector::ZeroVector, 50.0f);
+	TestEqual(TEXT("Removed observer shouldn't receive events"), Received[0], 2);
+	TestEqual(TEXT("Should contain the remaining records"), EventSystem->Num(), NumObservers);
+
+	// Records moved to the spatial hash by a handler leave no cleared slots after the dispatch.
+	const auto MovedHandle = EventSystem->AddObserver<ULES_TestSpatialEvent>(
+		TestObserver.Get(), [](const ULES_TestSpatialEvent*) {});
+	const auto MovingHandle = EventSystem->AddObserver<ULES_TestSpatialEvent>(
+		TestObserver.Get(), [&EventSystem, MovedHandle](const ULES_TestSpatialEvent*)
+		{
+			EventSystem->SetSpatialFilter(MovedHandle, nullptr, 0.0f);
+		});
+	SendAt(FVector::ZeroVector, 50.0f);
+	TestEqual(TEXT("Moved record's slot should be compacted after the dispatch"),
+	          EventSystem->GetMemoryReport().NumClearedSlots, 0);
+	EventSystem->RemoveByHandle(MovingHandle);
+	EventSystem->RemoveByHandle(MovedHandle);
+
+	// Spatial filters are only for spatial events.
+	const auto Handle = EventSystem->AddObserver<ULES_TestEvent>(TestObserver.Get(), &ULES_TestObserver::OnTestEvent);
+	TestFalse(TEXT("Non-spatial events can't be filtered"), EventSystem->SetSpatialFilter(Handle, nullptr, 100.0f));
+
+	EventSystem->RemoveAll();
+	TestEqual(TEXT("Should be empty"), EventSystem->Num(), 0);
+
+	return true;
+}
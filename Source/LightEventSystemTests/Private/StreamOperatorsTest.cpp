@@ -0,0 +1,141 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#include "BasicEvents.h"
+#include "TestClasses.h"
+#include "Misc/AutomationTest.h"
+
+namespace LES::Tests
+{
+	/** Registers an observer of float events with the \a Operators and records the values it receives. */
+	FLES_ObserverHandle AddFloatObserver(ULES_EventSystem* EventSystem, UObject* Observer, TArray<float>& OutValues,
+	                                     const FLES_StreamOperators& Operators)
+	{
+		return EventSystem->AddObserver<ULES_FloatEvent>(Observer, [&OutValues](const ULES_FloatEvent* Event)
+		{
+			OutValues.Add(Event->Value);
+		}, NAME_None, Operators);
+	}
+
+	void SendFloats(ULES_EventSystem* EventSystem, const TArray<float>& Values)
+	{
+		for (const float Value : Values)
+			EventSystem->SendEvent(LES::Create<ULES_FloatEvent>(Value, nullptr, NAME_None));
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLES_StreamOperatorsTest, "Light Event System.Stream operators",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+bool FLES_StreamOperatorsTest::RunTest(const FString& Parameters)
+{
+	using namespace LES::Tests;
+
+	ULES_TestObserver* TestObserver = NewObject<ULES_TestObserver>();
+
+	// Throttle
+	{
+		ULES_EventSystem* EventSystem = NewObject<ULES_EventSystem>();
+		TArray<float> Values;
+		AddFloatObserver(EventSystem, TestObserver, Values, {.ThrottleRate = 10.f});
+
+		SendFloats(EventSystem, {1.f, 2.f, 3.f});
+		EventSystem->Tick(0.05f);
+		SendFloats(EventSystem, {4.f});
+		EventSystem->Tick(0.05f);
+		SendFloats(EventSystem, {5.f});
+		TestEqual(TEXT("Throttle should let through one event per period"), Values, TArray<float>{1.f, 5.f});
+	}
+
+	// Distinct until changed
+	{
+		ULES_EventSystem* EventSystem = NewObject<ULES_EventSystem>();
+		TArray<float> Values;
+		AddFloatObserver(EventSystem, TestObserver, Values, {.bDistinctUntilChanged = true});
+
+		SendFloats(EventSystem, {1.f, 1.f, 2.f, 2.f, 1.f});
+		TestEqual(TEXT("Repeated values should be dropped"), Values, TArray<float>{1.f, 2.f, 1.f});
+	}
+
+	// Debounce
+	{
+		ULES_EventSystem* EventSystem = NewObject<ULES_EventSystem>();
+		TArray<float> Values;
+		AddFloatObserver(EventSystem, TestObserver, Values, {.DebounceTime = 0.5f});
+
+		SendFloats(EventSystem, {1.f, 2.f});
+		EventSystem->Tick(0.25f);
+		SendFloats(EventSystem, {3.f});
+		EventSystem->Tick(0.25f);
+		TestEqual(TEXT("Debounced events shouldn't be delivered before the quiet period"), Values.Num(), 0);
+		EventSystem->Tick(0.25f);
+		TestEqual(TEXT("Only the last debounced event should be delivered"), Values, TArray<float>{3.f});
+	}
+
+	// Sample per tick
+	{
+		ULES_EventSystem* EventSystem = NewObject<ULES_EventSystem>();
+		TArray<float> Values;
+		AddFloatObserver(EventSystem, TestObserver, Values, {.bSamplePerTick = true});
+
+		SendFloats(EventSystem, {1.f, 2.f, 3.f});
+		TestEqual(TEXT("Sampled events should be delivered when ticked"), Values.Num(), 0);
+		EventSystem->Tick(0.f);
+		EventSystem->Tick(0.f);
+		TestEqual(TEXT("The last event of the tick should be delivered once"), Values, TArray<float>{3.f});
+	}
+
+	// Windowed reduce
+	{
+		ULES_EventSystem* EventSystem = NewObject<ULES_EventSystem>();
+		TArray<float> Sums;
+		TArray<float> CountedValues;
+		TArray<float> Maximums;
+		TArray<FVector2f> Counts;
+		AddFloatObserver(EventSystem, TestObserver, Sums, {.ReduceOperation = ELES_ReduceOperation::Sum});
+		AddFloatObserver(EventSystem, TestObserver, CountedValues, {.ReduceOperation = ELES_ReduceOperation::Count});
+		EventSystem->AddObserver<ULES_CountedEvent>(TestObserver, [&Counts](const ULES_CountedEvent* Event)
+		{
+			Counts.Add(FVector2f(static_cast<float>(Event->Count), Event->Value));
+		}, NAME_None, {.ReduceOperation = ELES_ReduceOperation::Count});
+		AddFloatObserver(EventSystem, TestObserver, Maximums, {
+			                 .ReduceOperation = ELES_ReduceOperation::Max,
+			                 .ReduceWindow = 1.f
+		                 });
+
+		SendFloats(EventSystem, {1.f, 2.f, 3.f});
+		for (int32 Index = 0; Index < 3; Index++)
+		{
+			ULES_CountedEvent* Event = NewObject<ULES_CountedEvent>();
+			Event->Value = 7.f;
+			EventSystem->SendEvent(Event);
+		}
+		EventSystem->Tick(0.5f);
+		SendFloats(EventSystem, {5.f, 4.f});
+		EventSystem->Tick(0.5f);
+		TestEqual(TEXT("Sums should be aggregated per tick"), Sums, TArray<float>{6.f, 9.f});
+		TestEqual(TEXT("Counting should deliver the last event of the tick unchanged"), CountedValues,
+		          TArray<float>{3.f, 4.f});
+		TestEqual(TEXT("Counts should be delivered in the Count property"), Counts, TArray<FVector2f>{{3.f, 7.f}});
+		TestEqual(TEXT("Maximum should be aggregated over the window"), Maximums, TArray<float>{5.f});
+	}
+
+	// Suppressed deliveries don't reach the hooks.
+	{
+		ULES_CountingEventSystem* EventSystem = NewObject<ULES_CountingEventSystem>();
+		TArray<float> Values;
+		const auto Handle = AddFloatObserver(EventSystem, TestObserver, Values, {.bSamplePerTick = true});
+
+		SendFloats(EventSystem, {1.f, 2.f, 3.f});
+		EventSystem->Tick(0.f);
+		TestEqual(TEXT("BeforeReceive should be called once"), EventSystem->BeforeReceiveCount, 1);
+		TestEqual(TEXT("AfterReceive should be called once"), EventSystem->AfterReceiveCount, 1);
+
+		EventSystem->SetStreamOperators(Handle, {});
+		SendFloats(EventSystem, {4.f, 5.f});
+		TestEqual(TEXT("Removing the operators should deliver every event"), Values, TArray<float>{3.f, 4.f, 5.f});
+	}
+
+	return true;
+}
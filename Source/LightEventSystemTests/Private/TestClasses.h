@@ -2,7 +2,9 @@
 
 #pragma once
 
+#include "BasicEvents.h"
 #include "EventSystem.h"
+#include "UObject/StrongObjectPtr.h"
 #include "TestClasses.generated.h"
 
 UCLASS(HideDropdown)
@@ -23,6 +25,46 @@ class ULES_OtherTestEvent : public ULES_Event
 	GENERATED_BODY()
 };
 
+UCLASS(HideDropdown)
+class ULES_CountedEvent : public ULES_Event
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY()
+	float Value = 0.f;
+
+	UPROPERTY()
+	int32 Count = 0;
+};
+
+UCLASS(HideDropdown)
+class ULES_TestSpatialEvent : public ULES_SpatialEvent
+{
+	GENERATED_BODY()
+};
+
+UCLASS(HideDropdown)
+class ULES_CountingEventSystem : public ULES_EventSystem
+{
+	GENERATED_BODY()
+
+public:
+	int BeforeReceiveCount = 0;
+	int AfterReceiveCount = 0;
+
+	virtual bool BeforeReceive_Implementation(ULES_Event* Event, UObject* Observer) override
+	{
+		BeforeReceiveCount++;
+		return true;
+	}
+
+	virtual void AfterReceive_Implementation(ULES_Event* Event, UObject* Observer) override
+	{
+		AfterReceiveCount++;
+	}
+};
+
 UCLASS(HideDropdown)
 class ULES_TestObserver : public UObject
 {
@@ -54,4 +96,50 @@ public:
 	{
 		Counter += FIntVector3(1, 0, 0);
 	}
+
+	UFUNCTION()
+	void AddToCounter(const int32 Amount)
+	{
+		Counter += FIntVector3(Amount, 0, 0);
+	}
+
+	void OnFloatEvent(const ULES_FloatEvent* FloatEvent)
+	{
+		Counter += FIntVector3(FMath::TruncToInt32(FloatEvent->Value), 0, 0);
+	}
+
+	void OnTestEvents(TArrayView<const ULES_TestEvent* const> TestEvents)
+	{
+		Counter += FIntVector3(TestEvents.Num(), 0, 0);
+	}
+};
+
+UCLASS(HideDropdown)
+class ULES_TestClassObserver : public ULES_TestObserver
+{
+	GENERATED_BODY()
+};
+
+UCLASS(HideDropdown)
+class ULES_DerivedClassObserver : public ULES_TestClassObserver
+{
+	GENERATED_BODY()
+};
+
+/** Class observer sending an event from its constructor, before it's fully constructed. */
+UCLASS(HideDropdown)
+class ULES_ConstructingClassObserver : public ULES_TestClassObserver
+{
+	GENERATED_BODY()
+
+public:
+	/** Event System and event the instances send when they're constructed, if set. */
+	static inline ULES_EventSystem* ConstructionEventSystem = nullptr;
+	static inline ULES_Event* ConstructionEvent = nullptr;
+
+	ULES_ConstructingClassObserver()
+	{
+		if (ConstructionEventSystem && ConstructionEvent)
+			ConstructionEventSystem->SendEvent(ConstructionEvent);
+	}
 };
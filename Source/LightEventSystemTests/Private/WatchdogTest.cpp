@@ -0,0 +1,69 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#include "TestClasses.h"
+#include "Misc/AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLES_WatchdogTest, "Light Event System.Slow handler watchdog",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+bool FLES_WatchdogTest::RunTest(const FString& Parameters)
+{
+	auto EventSystem = TStrongObjectPtr(NewObject<ULES_EventSystem>());
+	auto SlowObserver = TStrongObjectPtr(NewObject<ULES_TestObserver>());
+	auto FastObserver = TStrongObjectPtr(NewObject<ULES_TestObserver>());
+	const FName Slow = "Slow";
+
+	int NumSlowCalls = 0;
+	auto SlowHandler = [&NumSlowCalls](ULES_TestEvent*)
+	{
+		const double EndTime = FPlatformTime::Seconds() + 0.005;
+		while (FPlatformTime::Seconds() < EndTime)
+		{
+		}
+		NumSlowCalls++;
+	};
+	const auto SlowHandle = EventSystem->AddObserver<ULES_TestEvent>(SlowObserver.Get(), SlowHandler, Slow);
+	EventSystem->AddObserver<ULES_TestEvent>(FastObserver.Get(), &ULES_TestObserver::OnTestEvent, Slow);
+
+	// Handlers aren't timed without a budget.
+	auto Event = NewObject<ULES_TestEvent>();
+	Event->Channel = Slow;
+	EventSystem->SendEvent(Event);
+	TestEqual(TEXT("Handlers shouldn't be timed without a budget"), EventSystem->GetWatchdogStats().NumTimedCalls,
+	          static_cast<int64>(0));
+
+	EventSystem->ChannelHandlerBudgets.Add(Slow, 1.0f);
+	EventSystem->bDeferSlowHandlers = true;
+	AddExpectedError(TEXT("over the budget"), EAutomationExpectedErrorFlags::Contains, 1);
+	EventSystem->SendEvent(Event);
+	FLES_WatchdogStats Stats = EventSystem->GetWatchdogStats();
+	TestEqual(TEXT("Both handlers should be timed"), Stats.NumTimedCalls, static_cast<int64>(2));
+	TestEqual(TEXT("Slow handler should go over the budget"), Stats.NumOverBudgetCalls, static_cast<int64>(1));
+	TestTrue(TEXT("Slowest call should be measured"), Stats.SlowestCallTime >= 5.0);
+	TestTrue(TEXT("Slow handler should be demoted"), EventSystem->IsDeliveryDeferred(SlowHandle));
+	TestEqual(TEXT("Slow handler should receive the event that demoted it"), NumSlowCalls, 2);
+
+	// Demoted handlers receive their events when the Event System is ticked.
+	EventSystem->SendEvent(Event);
+	TestEqual(TEXT("Demoted handler shouldn't receive events while they're sent"), NumSlowCalls, 2);
+	TestEqual(TEXT("Fast handler should receive events right away"), FastObserver->Counter, FIntVector3(3, 0, 0));
+	EventSystem->Tick(0.0f);
+	TestEqual(TEXT("Demoted handler should receive events on tick"), NumSlowCalls, 3);
+	Stats = EventSystem->GetWatchdogStats();
+	TestEqual(TEXT("Deferred delivery should be counted"), Stats.NumDeferredDeliveries, static_cast<int64>(1));
+	TestEqual(TEXT("Slow handler should be demoted once"), Stats.NumDemotedRecords, 1);
+
+	// Deferred events of removed records are dropped.
+	EventSystem->SendEvent(Event);
+	EventSystem->RemoveByHandle(SlowHandle);
+	EventSystem->Tick(0.0f);
+	TestEqual(TEXT("Removed handler shouldn't receive deferred events"), NumSlowCalls, 3);
+
+	EventSystem->ResetWatchdogStats();
+	TestEqual(TEXT("Counters should be reset"), EventSystem->GetWatchdogStats().NumOverBudgetCalls,
+	          static_cast<int64>(0));
+
+	return true;
+}
@@ -0,0 +1,202 @@
+// Copyright © 2024 Mariusz Kurowski. All Rights Reserved.
+
+#include "AllocationCounter.h"
+#include "TestClasses.h"
+#include "Misc/AutomationTest.h"
+
+/**
+ * Checks that the steady state of the dispatch doesn't allocate, as documented on \a ULES_EventSystem::SendEvent. Each
+ * scenario runs once to warm up the Event System's arrays, and is counted on the second run. New dispatch features
+ * should add their scenarios here.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLES_ZeroAllocationTest, "Light Event System.Zero allocation",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+bool FLES_ZeroAllocationTest::RunTest(const FString& Parameters)
+{
+	auto EventSystem = TStrongObjectPtr(NewObject<ULES_EventSystem>());
+	auto TestObserver = TStrongObjectPtr(NewObject<ULES_TestObserver>());
+	auto CountAllocations = [](auto&& Scenario)
+	{
+		Scenario();
+		LES::FScopedAllocationCounter Counter;
+		Scenario();
+		return Counter.GetNumAllocations();
+	};
+
+	// Events are created up front, since creating them allocates.
+	auto Event = TStrongObjectPtr(NewObject<ULES_TestEvent>());
+	auto ChannelEvent = TStrongObjectPtr(NewObject<ULES_TestEvent>());
+	ChannelEvent->Channel = "Channel";
+	auto SpatialEvent = TStrongObjectPtr(NewObject<ULES_TestSpatialEvent>());
+	SpatialEvent->Radius = 100.0f;
+
+	int32 NumLambdaCalls = 0;
+	for (int32 Index = 0; Index < 8; Index++)
+	{
+		EventSystem->AddObserver<ULES_TestEvent>(TestObserver.Get(), &ULES_TestObserver::OnTestEvent);
+		EventSystem->AddObserver<ULES_TestEvent>(TestObserver.Get(), [&NumLambdaCalls](const ULES_TestEvent*)
+		{
+			NumLambdaCalls++;
+		}, "Channel", {}, *FString::Printf(TEXT("Group %d"), Index));
+
+		const auto SpatialHandle = EventSystem->AddObserver<ULES_TestSpatialEvent>(
+			TestObserver.Get(), [&NumLambdaCalls](const ULES_TestSpatialEvent*) { NumLambdaCalls++; });
+		EventSystem->SetSpatialFilter(SpatialHandle, nullptr, 50.0f);
+		EventSystem->SetSpatialObserverLocation(SpatialHandle, FVector(Index * 20.0, 0.0, 0.0));
+	}
+	EventSystem->SuspendGroup("Group 0");
+
+	TestEqual(TEXT("Sending shouldn't allocate"), CountAllocations([&]
+	{
+		EventSystem->SendEvent(Event.Get());
+	}), 0);
+	TestEqual(TEXT("Sending to many groups shouldn't allocate"), CountAllocations([&]
+	{
+		EventSystem->SendEvent(ChannelEvent.Get());
+	}), 0);
+	TestEqual(TEXT("Sending to spatial observers shouldn't allocate"), CountAllocations([&]
+	{
+		EventSystem->SendEvent(SpatialEvent.Get());
+	}), 0);
+
+	const FLES_SendToken Token = EventSystem->ResolveSendToken(ULES_TestEvent::StaticClass());
+	TestEqual(TEXT("Sending with a token shouldn't allocate"), CountAllocations([&]
+	{
+		EventSystem->SendEvent(Token, Event.Get());
+	}), 0);
+
+	// Handlers sending events dispatch them nested in the outer dispatch.
+	auto NestedEvent = TStrongObjectPtr(NewObject<ULES_OtherTestEvent>());
+	auto SendNested = [&EventSystem, &ChannelEvent](const ULES_OtherTestEvent*)
+	{
+		EventSystem->SendEvent(ChannelEvent.Get());
+	};
+	EventSystem->AddObserver<ULES_OtherTestEvent>(TestObserver.Get(), SendNested);
+	TestEqual(TEXT("Nested sending shouldn't allocate"), CountAllocations([&]
+	{
+		EventSystem->SendEvent(NestedEvent.Get());
+	}), 0);
+
+	// Queued paths, delivered by the tick.
+	TestEqual(TEXT("Conflated sending shouldn't allocate"), CountAllocations([&]
+	{
+		EventSystem->SendEventConflated(Event.Get());
+		EventSystem->SendEventConflated(ChannelEvent.Get());
+		EventSystem->Tick(0.0f);
+	}), 0);
+	TestEqual(TEXT("Scheduled sending shouldn't allocate"), CountAllocations([&]
+	{
+		EventSystem->SendEventDelayed(Event.Get(), 0.0);
+		EventSystem->Tick(0.0f);
+	}), 0);
+
+	const auto DeferredHandle = EventSystem->AddObserver<ULES_TestEvent>(TestObserver.Get(),
+	                                                                     &ULES_TestObserver::OnTestEvent);
+	EventSystem->SetDeliveryDeferred(DeferredHandle, true);
+	TestEqual(TEXT("Deferred delivery shouldn't allocate"), CountAllocations([&]
+	{
+		EventSystem->SendEvent(Event.Get());
+		EventSystem->Tick(0.0f);
+	}), 0);
+
+	EventSystem->DefaultHandlerBudget = 1000.0f;
+	TestEqual(TEXT("Timing the handlers shouldn't allocate"), CountAllocations([&]
+	{
+		EventSystem->SendEvent(Event.Get());
+	}), 0);
+	EventSystem->DefaultHandlerBudget = 0.0f;
+
+	int32 NumBatchedEvents = 0;
+	auto BatchHandler = [&NumBatchedEvents](TArrayView<const ULES_TestEvent* const> Batch)
+	{
+		NumBatchedEvents += Batch.Num();
+	};
+	EventSystem->AddBatchObserver<ULES_TestEvent>(TestObserver.Get(), BatchHandler, NAME_None, 2);
+	TestEqual(TEXT("Batch delivery shouldn't allocate"), CountAllocations([&]
+	{
+		for (int32 Index = 0; Index < 3; Index++)
+			EventSystem->SendEvent(Event.Get());
+		EventSystem->Tick(0.0f);
+	}), 0);
+	TestEqual(TEXT("Batched events should be handled"), NumBatchedEvents, 6);
+
+	auto ClassObserver = TStrongObjectPtr(NewObject<ULES_TestClassObserver>());
+	EventSystem->AddClassObserver<ULES_TestEvent, ULES_TestClassObserver>(&ULES_TestClassObserver::OnTestEvent);
+	TestEqual(TEXT("Sending to class observers shouldn't allocate"), CountAllocations([&]
+	{
+		EventSystem->SendEvent(Event.Get());
+	}), 0);
+
+	std::atomic<int32> NumConcurrentCalls = 0;
+	EventSystem->AddConcurrentObserver<ULES_TestEvent>(TestObserver.Get(), [&NumConcurrentCalls](ULES_TestEvent*)
+	{
+		NumConcurrentCalls++;
+	});
+	TestEqual(TEXT("Concurrent sending shouldn't allocate"), CountAllocations([&]
+	{
+		EventSystem->SendEventConcurrent(Event.Get());
+	}), 0);
+	TestEqual(TEXT("Concurrent observer should be called"), NumConcurrentCalls.load(), 2);
+
+	// Queries reduce the answers in place, without reply events.
+	auto SumQuery = TStrongObjectPtr(NewObject<ULES_TestEvent>());
+	SumQuery->Channel = "Query";
+	auto AndQuery = TStrongObjectPtr(NewObject<ULES_OtherTestEvent>());
+	AndQuery->Channel = "Query";
+	for (int32 Index = 0; Index < 4; Index++)
+	{
+		EventSystem->AddQueryObserver<ULES_TestEvent, float>(TestObserver.Get(), [Index](
+			const ULES_TestEvent*, LES::TQueryResult<float>& Result)
+		{
+			Result.Add(static_cast<float>(Index));
+		}, "Query");
+		EventSystem->AddQueryObserver<ULES_OtherTestEvent, bool>(TestObserver.Get(), [Index](
+			const ULES_OtherTestEvent*, LES::TQueryResult<bool>& Result)
+		{
+			Result.Add(Index != 1);
+		}, "Query");
+	}
+	float Sum = 0.0f;
+	TestEqual(TEXT("SUM query shouldn't allocate"), CountAllocations([&]
+	{
+		Sum = EventSystem->Query<float>(SumQuery.Get(), ELES_QueryReducer::Sum).Get();
+	}), 0);
+	TestEqual(TEXT("SUM query should be answered"), Sum, 6.0f);
+	bool bAnd = true;
+	TestEqual(TEXT("Early stopping AND query shouldn't allocate"), CountAllocations([&]
+	{
+		bAnd = EventSystem->Query<bool>(AndQuery.Get(), ELES_QueryReducer::And).Get(true);
+	}), 0);
+	TestFalse(TEXT("AND query should be answered"), bAnd);
+
+	// Removal is counted on its own, since adding the records allocates their slots on the first run.
+	TArray<FLES_ObserverHandle> Handles;
+	Handles.Reserve(2);
+	auto AddRemovedObservers = [&]
+	{
+		Handles.Add(EventSystem->AddObserver<ULES_TestEvent>(TestObserver.Get(), &ULES_TestObserver::OnTestEvent));
+		Handles.Add(EventSystem->AddObserver<ULES_TestEvent>(TestObserver.Get(), &ULES_TestObserver::OnTestEvent));
+	};
+	auto RemoveObservers = [&]
+	{
+		for (const FLES_ObserverHandle& Handle : Handles)
+			EventSystem->RemoveByHandle(Handle);
+		Handles.Reset();
+	};
+	AddRemovedObservers();
+	RemoveObservers();
+	AddRemovedObservers();
+	{
+		LES::FScopedAllocationCounter Counter;
+		RemoveObservers();
+		const int32 NumAllocations = Counter.GetNumAllocations();
+		TestEqual(TEXT("Removing by handle shouldn't allocate"), NumAllocations, 0);
+	}
+
+	TestTrue(TEXT("Handlers should have been called"), NumLambdaCalls > 0);
+
+	return true;
+}